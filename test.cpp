@@ -58,6 +58,7 @@ extern std::string vhGetDeviceInfo();
 extern std::string vhBuildShaderFlagArgs_Internal( uint64_t flags );
 extern bool vhRunExe( const std::string& command, std::string& outOutput );
 extern bool vhBackend_UNITTEST_GetFrameBuffer( const std::vector< vhTexture >& colours, vhTexture depth );
+extern nvrhi::FramebufferHandle vhBackend_UNITTEST_FrameBuffer( const std::vector< vhTexture >& colours, vhTexture depth, int mip, int layer );
 
 UTEST( ShaderInternal, StateToDesc )
 {
@@ -244,6 +245,138 @@ UTEST( RHI, RayTracingControl )
     g_vhInit.raytracing = false;
 }
 
+UTEST( RHI, FlushTickets )
+{
+    if ( !g_testInit )
+    {
+        vhInit( g_testInitQuiet );
+        g_testInit = true;
+    }
+
+    // Tickets are monotonic and complete once waited on.
+    vhFlushTicket a = vhFlushAsync();
+    vhFlushTicket b = vhFlushAsync();
+    EXPECT_GT( b, a );
+    vhWaitFlush( b );
+    EXPECT_TRUE( vhIsFlushComplete( a ) );
+    EXPECT_TRUE( vhIsFlushComplete( b ) );
+    EXPECT_FALSE( vhIsFlushComplete( b + 1000 ) );
+
+    // Tickets from several threads all complete, regardless of the order the backend sees them in.
+    std::vector< std::thread > threads;
+    for ( int t = 0; t < 4; t++ )
+    {
+        threads.emplace_back( []()
+        {
+            for ( int i = 0; i < 50; i++ ) vhFlush();
+        } );
+    }
+    for ( auto& thread : threads ) thread.join();
+    vhFlush();
+
+    // No more 1ms sleep floor per synchronous call.
+    auto start = std::chrono::high_resolution_clock::now();
+    for ( int i = 0; i < 200; i++ ) vhFlush();
+    double ms = std::chrono::duration< double, std::milli >( std::chrono::high_resolution_clock::now() - start ).count();
+    VRHI_LOG( "    200x vhFlush: %.3f ms\n", ms );
+    EXPECT_LT( ms, 200.0 );
+}
+
+UTEST( RHI, CmdListPool )
+{
+    if ( !g_testInit )
+    {
+        vhInit( g_testInitQuiet );
+        g_testInit = true;
+    }
+
+    vhBuffer buffer = vhAllocBuffer();
+    vhCreateVertexBuffer( buffer, "CmdListPool", vhAllocMem( 256 ), "float4 POSITION" );
+    vhFinish();
+
+    // Every vhFinish() retires the previous submission, so after warm-up each flush should recycle a pooled list.
+    uint64_t startCreated = g_vhCmdListsCreated.load();
+    uint64_t startReused = g_vhCmdListsReused.load();
+    const int kFlushes = 32;
+    for ( int i = 0; i < kFlushes; i++ )
+    {
+        vhUpdateVertexBuffer( buffer, vhAllocMem( 256 ), 0 );
+        vhFinish();
+    }
+    uint64_t created = g_vhCmdListsCreated.load() - startCreated;
+    uint64_t reused = g_vhCmdListsReused.load() - startReused;
+    VRHI_LOG( "    %d flushes: %llu command lists created, %llu reused\n", kFlushes, ( unsigned long long ) created, ( unsigned long long ) reused );
+    EXPECT_LE( created, ( uint64_t ) nvrhi::CommandQueue::Count );
+    EXPECT_GE( reused, ( uint64_t ) kFlushes - ( uint64_t ) nvrhi::CommandQueue::Count );
+
+    vhDestroyBuffer( buffer );
+    vhFlush();
+}
+
+UTEST( RHI, QueryContention )
+{
+    if ( !g_testInit )
+    {
+        vhInit( g_testInitQuiet );
+        g_testInit = true;
+    }
+    vhFlush();
+    int32_t startErrors = g_vhErrorCounter.load();
+
+    const int kSize = 2048;
+    vhTexture tex = vhAllocTexture();
+    vhCreateTexture2D( tex, glm::ivec2( kSize, kSize ), 1, nvrhi::Format::RGBA8_UNORM );
+    vhBuffer buf = vhAllocBuffer();
+    vhCreateVertexBuffer( buf, "QueryContention", nullptr, "float3 POSITION", 1024, VRHI_BUFFER_ALLOW_RESIZE );
+    vhFlush();
+
+    // Readers hammer the info queries while the backend is busy with large uploads and buffer resizes.
+    std::atomic< bool > stop = false;
+    std::atomic< uint64_t > queries = 0, inconsistent = 0;
+    std::atomic< int64_t > worstNs = 0;
+    std::vector< std::thread > readers;
+    for ( int t = 0; t < 4; t++ )
+    {
+        readers.emplace_back( [&]()
+        {
+            std::vector< vhTextureMipInfo > mipInfo;
+            while ( !stop )
+            {
+                auto start = std::chrono::high_resolution_clock::now();
+                vhTexInfo info = vhGetTextureInfo( tex, &mipInfo );
+                uint32_t stride = 0;
+                uint64_t size = vhGetBufferInfo( buf, &stride );
+                int64_t ns = std::chrono::duration_cast< std::chrono::nanoseconds >( std::chrono::high_resolution_clock::now() - start ).count();
+
+                if ( info.dimensions.x != kSize || mipInfo.size() != 1 || stride != 12 || size % 12 != 0 ) inconsistent++;
+                int64_t worst = worstNs.load();
+                while ( ns > worst && !worstNs.compare_exchange_weak( worst, ns ) ) {}
+                queries++;
+            }
+        } );
+    }
+
+    for ( int i = 0; i < 16; i++ )
+    {
+        vhUpdateTexture( tex, 0, 0, 1, 1, vhAllocMem( ( uint64_t ) kSize * kSize * 4 ) );
+        vhUpdateVertexBuffer( buf, nullptr, 0, 1024 * ( i + 2 ) );
+        vhFlush();
+    }
+    stop = true;
+    for ( auto& reader : readers ) reader.join();
+
+    VRHI_LOG( "    Query contention: %llu queries, worst %.3f ms\n", ( unsigned long long ) queries.load(), worstNs.load() / 1e6 );
+    EXPECT_GT( queries.load(), 0u );
+    EXPECT_EQ( inconsistent.load(), 0u );
+    EXPECT_EQ( vhGetBufferInfo( buf ), 12u * 1024 * 17 );
+
+    vhDestroyTexture( tex );
+    vhDestroyBuffer( buf );
+    vhFlush();
+    EXPECT_EQ( vhGetBufferInfo( buf ), 0u );
+    EXPECT_EQ( g_vhErrorCounter.load(), startErrors );
+}
+
 UTEST( Texture, CreateDestroyError )
 {
     if ( !g_testInit )
@@ -353,6 +486,185 @@ UTEST( Allocator, FreeList )
     EXPECT_EQ( allocator.alloc( 1, 1 ), -1 ); // Alignment not supported
 }
 
+UTEST( Allocator, CmdArena )
+{
+    // Run on a private thread so the arena is fresh and torn down at the end.
+    std::thread worker( [&]()
+    {
+        // Each VIDL_vhDestroyTexture record takes 32 bytes including its arena header.
+        uint64_t perBlock = vhCmdArena::kBlockSize / 32;
+
+        std::vector< VIDL_vhDestroyTexture* > cmds;
+        cmds.push_back( vhCmdAlloc< VIDL_vhDestroyTexture >( ( vhTexture ) 0 ) );
+        vhCmdArenaBlock* firstBlock = g_vhCmdArena.current;
+        for ( uint64_t i = 1; i < perBlock + 1; i++ ) cmds.push_back( vhCmdAlloc< VIDL_vhDestroyTexture >( ( vhTexture ) i ) );
+        EXPECT_NE( g_vhCmdArena.current, firstBlock );
+
+        // Records are placement-constructed, tagged and aligned.
+        EXPECT_EQ( cmds[7]->MAGIC, VIDL_vhDestroyTexture::kMagic );
+        EXPECT_EQ( cmds[7]->texture, 7u );
+        EXPECT_EQ( ( ( uintptr_t ) cmds[7] ) % vhCmdArena::kAlignment, 0u );
+        EXPECT_TRUE( VIDL_vhDestroyTexture::kTrivial );
+        EXPECT_FALSE( VIDL_vhCmdSetStateTextures::kTrivial );
+
+        // Once every record in the first block is released, the arena rewinds and reuses it rather than allocating.
+        for ( auto cmd : cmds ) vhCmdRelease( cmd );
+        cmds.clear();
+        for ( uint64_t i = 0; i < perBlock; i++ ) cmds.push_back( vhCmdAlloc< VIDL_vhDestroyTexture >( ( vhTexture ) i ) );
+        EXPECT_EQ( g_vhCmdArena.current, firstBlock );
+        for ( auto cmd : cmds ) vhCmdRelease( cmd );
+
+        // Non-trivial records run their destructor on release.
+        auto texCmd = vhCmdAlloc< VIDL_vhCmdSetStateTextures >( ( vhStateId ) 0, std::vector< vhState::TextureBinding >( 4 ) );
+        EXPECT_EQ( texCmd->textures.size(), ( size_t ) 4 );
+        vhCmdRelease( texCmd );
+    } );
+    worker.join();
+}
+
+UTEST( Allocator, SlotTable )
+{
+    vhSlotTable< std::unique_ptr< int > > table;
+    EXPECT_EQ( table.find( 3 ), nullptr );
+    EXPECT_EQ( table.find( VRHI_INVALID_HANDLE ), nullptr );
+
+    table[3] = std::make_unique< int >( 30 );
+    table[0] = std::make_unique< int >( 0 );
+    EXPECT_EQ( table.size(), ( size_t ) 2 );
+    ASSERT_NE( table.find( 3 ), nullptr );
+    EXPECT_EQ( **table.find( 3 ), 30 );
+    EXPECT_EQ( table.find( 2 ), nullptr );
+
+    // Erased slots miss, and refilling them starts from a default value.
+    EXPECT_TRUE( table.erase( 3 ) );
+    EXPECT_FALSE( table.erase( 3 ) );
+    EXPECT_EQ( table.find( 3 ), nullptr );
+    EXPECT_FALSE( table[3] );
+    EXPECT_EQ( table.size(), ( size_t ) 2 );
+
+    table.clear();
+    EXPECT_EQ( table.size(), ( size_t ) 0 );
+    EXPECT_FALSE( table.contains( 0 ) );
+}
+
+UTEST( Allocator, HandleGenerations )
+{
+    vhHandleAllocator allocator;
+    uint32_t a = allocator.alloc();
+    uint32_t b = allocator.alloc();
+    EXPECT_NE( a, b );
+    EXPECT_TRUE( allocator.valid( a ) );
+
+    // A recycled slot hands out a new handle; the stale one is rejected everywhere.
+    EXPECT_TRUE( allocator.release( a ) );
+    EXPECT_FALSE( allocator.release( a ) );
+    uint32_t c = allocator.alloc();
+    EXPECT_EQ( vhHandleIndex( c ), vhHandleIndex( a ) );
+    EXPECT_NE( c, a );
+    EXPECT_FALSE( allocator.valid( a ) );
+    EXPECT_TRUE( allocator.valid( c ) );
+
+    vhSlotTable< int > table;
+    table[a] = 1;
+    table[c] = 2;
+    EXPECT_EQ( table.find( a ), nullptr );
+    ASSERT_NE( table.find( c ), nullptr );
+    EXPECT_EQ( *table.find( c ), 2 );
+
+    // No fixed cap, and concurrent allocations never collide.
+    std::vector< std::vector< uint32_t > > perThread( 4 );
+    std::vector< std::thread > threads;
+    for ( int t = 0; t < 4; t++ )
+    {
+        threads.emplace_back( [&, t]()
+        {
+            for ( int i = 0; i < 5000; i++ )
+            {
+                uint32_t h = allocator.alloc();
+                perThread[t].push_back( h );
+                if ( i % 3 == 0 ) EXPECT_TRUE( allocator.release( perThread[t][i / 2] ) );
+            }
+        } );
+    }
+    for ( auto& thread : threads ) thread.join();
+
+    std::set< uint32_t > live;
+    uint32_t liveCount = 0;
+    for ( auto& handles : perThread )
+    {
+        for ( uint32_t h : handles )
+        {
+            EXPECT_NE( h, VRHI_INVALID_HANDLE );
+            if ( allocator.valid( h ) ) { live.insert( vhHandleIndex( h ) ); liveCount++; }
+        }
+    }
+    EXPECT_EQ( ( uint32_t ) live.size(), liveCount );
+    EXPECT_EQ( allocator.count(), liveCount + 2 );
+}
+
+UTEST( Allocator, TLSF )
+{
+    vhAllocatorTLSF allocator( 1024 * 1024, 16 );
+    uint64_t a = 0, b = 0, c = 0;
+    uint32_t ba = allocator.alloc( 100, a );
+    uint32_t bb = allocator.alloc( 1000, b );
+    uint32_t bc = allocator.alloc( 5000, c );
+    ASSERT_NE( ba, vhAllocatorTLSF::kInvalidBlock );
+    ASSERT_NE( bb, vhAllocatorTLSF::kInvalidBlock );
+    ASSERT_NE( bc, vhAllocatorTLSF::kInvalidBlock );
+
+    // Sizes round up to the alignment and ranges never overlap.
+    EXPECT_EQ( a % 16, 0ull );
+    EXPECT_EQ( b % 16, 0ull );
+    EXPECT_EQ( c % 16, 0ull );
+    EXPECT_TRUE( a + 112 <= b || b + 1008 <= a );
+    EXPECT_TRUE( b + 1008 <= c || c + 5008 <= b );
+    EXPECT_EQ( allocator.used(), 112ull + 1008ull + 5008ull );
+
+    // A released range is handed out again.
+    allocator.release( bb );
+    uint64_t d = 0;
+    uint32_t bd = allocator.alloc( 1000, d );
+    EXPECT_EQ( d, b );
+
+    // Freeing everything coalesces back into a single block covering the whole range.
+    allocator.release( ba );
+    allocator.release( bc );
+    allocator.release( bd );
+    EXPECT_EQ( allocator.used(), 0ull );
+    uint64_t whole = 0;
+    EXPECT_NE( allocator.alloc( 1024 * 1024, whole ), vhAllocatorTLSF::kInvalidBlock );
+    EXPECT_EQ( whole, 0ull );
+    EXPECT_EQ( allocator.alloc( 16, whole ), vhAllocatorTLSF::kInvalidBlock );
+
+    // Random churn never hands out overlapping ranges.
+    allocator.reset( 4 * 1024 * 1024, 256 );
+    std::mt19937 rng( 1234 );
+    std::vector< std::pair< uint32_t, std::pair< uint64_t, uint64_t > > > live;
+    bool overlap = false;
+    for ( int i = 0; i < 20000; i++ )
+    {
+        if ( live.empty() || rng() % 3 )
+        {
+            uint64_t size = 1 + rng() % 8192, offset = 0;
+            uint32_t block = allocator.alloc( size, offset );
+            if ( block == vhAllocatorTLSF::kInvalidBlock ) continue;
+            for ( const auto& other : live ) overlap |= !( offset + size <= other.second.first || other.second.first + other.second.second <= offset );
+            overlap |= ( offset % 256 ) != 0;
+            live.push_back( { block, { offset, size } } );
+        }
+        else
+        {
+            size_t idx = rng() % live.size();
+            allocator.release( live[idx].first );
+            live.erase( live.begin() + idx );
+        }
+    }
+    EXPECT_FALSE( overlap );
+    for ( const auto& entry : live ) allocator.release( entry.first );
+    EXPECT_EQ( allocator.used(), 0ull );
+}
+
 UTEST( Texture, CreateDestroy )
 {
     if ( !g_testInit )
@@ -543,6 +855,221 @@ UTEST( Texture, Readback )
     vhDestroyTexture( tex );
 }
 
+UTEST( Texture, ReadbackAsync )
+{
+    if ( !g_testInit )
+    {
+        vhInit( g_testInitQuiet );
+        g_testInit = true;
+    }
+    vhFinish();
+    int32_t startErrors = g_vhErrorCounter.load();
+
+    // Several frames of readbacks in flight at once, each against different contents.
+    const int kSize = 64, kFrames = 4;
+    const size_t dataSize = kSize * kSize * 4;
+    vhTexture tex = vhAllocTexture();
+    vhCreateTexture2D( tex, glm::ivec2( kSize, kSize ), 1, nvrhi::Format::RGBA8_UNORM );
+    vhBuffer buf = vhAllocBuffer();
+    vhCreateStorageBuffer( buf, "ReadbackAsync", nullptr, 1024 );
+
+    std::vector< std::vector< uint8_t > > expected( kFrames );
+    std::vector< vhMem > texOut( kFrames ), bufOut( kFrames );
+    std::vector< vhReadbackTicket > texTickets, bufTickets;
+    for ( int frame = 0; frame < kFrames; frame++ )
+    {
+        expected[frame].resize( dataSize );
+        for ( size_t i = 0; i < dataSize; i++ ) expected[frame][i] = ( uint8_t ) ( i * 7 + frame );
+        vhUpdateTexture( tex, 0, 0, 1, 1, vhAllocMem( expected[frame] ) );
+        vhUpdateStorageBuffer( buf, vhAllocMem( std::vector< uint8_t >( expected[frame].begin(), expected[frame].begin() + 1024 ) ), 0, 1024 );
+        texTickets.push_back( vhReadTextureAsync( tex, 0, 0, 1, 1, &texOut[frame] ) );
+        bufTickets.push_back( vhReadBufferAsync( buf, 256, 512, &bufOut[frame] ) );
+    }
+
+    // Polling alone must make progress, without any flush from us.
+    for ( int i = 0; i < 10000 && !vhIsReadbackComplete( texTickets[0] ); i++ ) std::this_thread::sleep_for( std::chrono::microseconds( 100 ) );
+    EXPECT_TRUE( vhIsReadbackComplete( texTickets[0] ) );
+
+    for ( int frame = 0; frame < kFrames; frame++ )
+    {
+        vhWaitReadback( texTickets[frame] );
+        vhWaitReadback( bufTickets[frame] );
+        EXPECT_TRUE( texOut[frame] == expected[frame] );
+        EXPECT_TRUE( bufOut[frame] == std::vector< uint8_t >( expected[frame].begin() + 256, expected[frame].begin() + 768 ) );
+    }
+    EXPECT_EQ( g_vhErrorCounter.load(), startErrors );
+
+    // Bad requests still complete their tickets, so nobody waits forever.
+    vhMem unused;
+    vhWaitReadback( vhReadTextureAsync( tex, 3, 0, 1, 1, &unused ) );
+    vhWaitReadback( vhReadBufferAsync( buf, 1000, 100, &unused ) );
+    EXPECT_TRUE( unused.empty() );
+    EXPECT_EQ( g_vhErrorCounter.load(), startErrors + 2 );
+
+    vhDestroyTexture( tex );
+    vhDestroyBuffer( buf );
+    vhFlush();
+}
+
+UTEST( Buffer, ZeroCopyMem )
+{
+    if ( !g_testInit )
+    {
+        vhInit( g_testInitQuiet );
+        g_testInit = true;
+    }
+    vhFinish();
+    int32_t startErrors = g_vhErrorCounter.load();
+
+    const int kSize = 4096;
+    std::vector< uint8_t > source( kSize );
+    for ( int i = 0; i < kSize; i++ ) source[i] = ( uint8_t ) ( i * 13 + 5 );
+
+    // Caller-owned memory: the backend reads it in place and tells us exactly once when it is done.
+    std::atomic< int > released = 0;
+    const uint8_t* releasedPtr = nullptr;
+    vhBuffer viewBuf = vhAllocBuffer();
+    vhCreateStorageBuffer( viewBuf, "ZeroCopyView", vhAllocMemView( source.data(), kSize, [&]( const uint8_t* data, size_t size ) {
+        releasedPtr = data;
+        EXPECT_EQ( size, ( size_t ) kSize );
+        released++;
+    } ), kSize );
+
+    // Memory-mapped file, at an offset that is not page aligned.
+    std::filesystem::path path = std::filesystem::temp_directory_path() / "vrhi_test_zero_copy.bin";
+    {
+        std::ofstream file( path, std::ios::binary );
+        file.write( ( const char* ) source.data(), kSize );
+    }
+    vhBuffer fileBuf = vhAllocBuffer();
+    vhMem* mapped = vhMapFileMem( path, 100, 1000 );
+    ASSERT_TRUE( mapped != nullptr );
+    EXPECT_TRUE( mapped->isExternal() );
+    EXPECT_EQ( mapped->size(), ( size_t ) 1000 );
+    vhCreateStorageBuffer( fileBuf, "ZeroCopyFile", mapped, 1000 );
+
+    vhMem viewOut, fileOut;
+    vhReadbackTicket viewTicket = vhReadBufferAsync( viewBuf, 0, 0, &viewOut );
+    vhReadbackTicket fileTicket = vhReadBufferAsync( fileBuf, 0, 0, &fileOut );
+    vhFinish();
+    vhWaitReadback( viewTicket );
+    vhWaitReadback( fileTicket );
+
+    EXPECT_EQ( released.load(), 1 );
+    EXPECT_TRUE( releasedPtr == source.data() );
+    EXPECT_TRUE( viewOut == source );
+    EXPECT_TRUE( fileOut == std::vector< uint8_t >( source.begin() + 100, source.begin() + 1100 ) );
+    EXPECT_EQ( g_vhErrorCounter.load(), startErrors );
+
+    // Copies own their bytes, so they outlive the referenced memory.
+    {
+        vhMem view( source.data(), 16, nullptr );
+        vhMem copy = view;
+        EXPECT_FALSE( copy.isExternal() );
+        EXPECT_TRUE( std::equal( copy.begin(), copy.end(), source.begin() ) );
+    }
+
+    // Const access sees the referenced bytes; writing copies them out first and lets the reference go.
+    {
+        int viewReleased = 0;
+        vhMem view( source.data(), 16, [&]( const uint8_t*, size_t ) { viewReleased++; } );
+        const vhMem& constView = view;
+        EXPECT_TRUE( constView.begin() == source.data() );
+        EXPECT_EQ( constView[5], source[5] );
+        EXPECT_TRUE( view == vhMem( source.begin(), source.begin() + 16 ) );
+        EXPECT_EQ( viewReleased, 0 );
+
+        view[0] = ( uint8_t ) ~source[0];
+        EXPECT_FALSE( view.isExternal() );
+        EXPECT_EQ( viewReleased, 1 );
+        EXPECT_EQ( view.size(), ( size_t ) 16 );
+        EXPECT_EQ( view[0], ( uint8_t ) ~source[0] );
+        EXPECT_EQ( view[15], source[15] );
+        EXPECT_EQ( source[0], ( uint8_t ) 5 );
+    }
+
+    // Bad maps fail cleanly, and external memory can't be a readback destination.
+    EXPECT_TRUE( vhMapFileMem( path.string() + ".missing" ) == nullptr );
+    EXPECT_TRUE( vhMapFileMem( path, kSize - 10, 100 ) == nullptr );
+    vhMem externalOut( source.data(), kSize, nullptr );
+    vhWaitReadback( vhReadBufferAsync( viewBuf, 0, 0, &externalOut ) );
+    EXPECT_EQ( g_vhErrorCounter.load(), startErrors + 3 );
+
+    vhDestroyBuffer( viewBuf );
+    vhDestroyBuffer( fileBuf );
+    vhFlush();
+    std::filesystem::remove( path );
+}
+
+UTEST( Texture, MappedUpload )
+{
+    if ( !g_testInit )
+    {
+        vhInit( g_testInitQuiet );
+        g_testInit = true;
+    }
+    vhFinish();
+    int32_t startErrors = g_vhErrorCounter.load();
+
+    // Map straight after creation, before the backend has necessarily seen the texture.
+    const int kSize = 64;
+    vhTexture tex = vhAllocTexture();
+    vhCreateTexture2DArray( tex, glm::ivec2( kSize, kSize ), 2, 2, nvrhi::Format::RGBA8_UNORM );
+    vhUploadMapping texMap = vhMapTextureUpload( tex, 1, 1 );
+    ASSERT_TRUE( texMap.data != nullptr );
+    EXPECT_EQ( texMap.size, ( uint64_t ) ( kSize / 2 ) * ( kSize / 2 ) * 4 );
+    EXPECT_EQ( texMap.rowPitch, ( uint32_t ) ( kSize / 2 ) * 4 );
+    for ( uint64_t i = 0; i < texMap.size; i++ ) texMap.data[i] = ( uint8_t ) ( i * 3 + 1 );
+    vhCommitUpload( texMap );
+
+    vhBuffer buf = vhAllocBuffer();
+    vhCreateStorageBuffer( buf, "MappedUpload", nullptr, 1024 );
+    vhUploadMapping bufMap = vhMapBufferUpload( buf, 256, 512 );
+    ASSERT_TRUE( bufMap.data != nullptr );
+    for ( uint64_t i = 0; i < bufMap.size; i++ ) bufMap.data[i] = ( uint8_t ) ( i * 5 + 2 );
+    vhCommitUpload( bufMap );
+
+    vhMem texOut, bufOut;
+    vhWaitReadback( vhReadTextureAsync( tex, 1, 1, 1, 1, &texOut ) );
+    vhWaitReadback( vhReadBufferAsync( buf, 256, 512, &bufOut ) );
+    ASSERT_EQ( texOut.size(), ( size_t ) texMap.size );
+    ASSERT_EQ( bufOut.size(), ( size_t ) 512 );
+    bool texMatch = true, bufMatch = true;
+    for ( size_t i = 0; i < texOut.size(); i++ ) texMatch &= texOut[i] == ( uint8_t ) ( i * 3 + 1 );
+    for ( size_t i = 0; i < bufOut.size(); i++ ) bufMatch &= bufOut[i] == ( uint8_t ) ( i * 5 + 2 );
+    EXPECT_TRUE( texMatch );
+    EXPECT_TRUE( bufMatch );
+    EXPECT_EQ( g_vhErrorCounter.load(), startErrors );
+
+    // Stream several chunks worth through the arena, so full chunks get recycled, including an oversized one.
+    vhBuffer big = vhAllocBuffer();
+    vhCreateStorageBuffer( big, "MappedUploadBig", nullptr, 20 * 1024 * 1024, VRHI_BUFFER_COMPUTE_READ_WRITE | VRHI_BUFFER_ALLOW_RESIZE );
+    for ( int i = 0; i < 40; i++ )
+    {
+        uint64_t size = ( i == 20 ) ? 20 * 1024 * 1024 : 1024 * 1024;
+        vhUploadMapping map = vhMapBufferUpload( big, 0, size );
+        ASSERT_TRUE( map.data != nullptr );
+        memset( map.data, i, size );
+        vhCommitUpload( map );
+        if ( i % 8 == 7 ) vhFinish();
+    }
+    vhMem bigOut;
+    vhWaitReadback( vhReadBufferAsync( big, 0, 16, &bigOut ) );
+    EXPECT_TRUE( bigOut == std::vector< uint8_t >( 16, 39 ) );
+    EXPECT_EQ( g_vhErrorCounter.load(), startErrors );
+
+    // Bad subresources fail to map; out of range commits are rejected by the backend.
+    EXPECT_TRUE( vhMapTextureUpload( tex, 2, 0 ).data == nullptr );
+    vhCommitUpload( vhMapBufferUpload( buf, 1000, 100 ) );
+    vhFinish();
+    EXPECT_EQ( g_vhErrorCounter.load(), startErrors + 2 );
+
+    vhDestroyTexture( tex );
+    vhDestroyBuffer( buf );
+    vhDestroyBuffer( big );
+    vhFlush();
+}
+
 UTEST( Buffer, ValidateLayout )
 {
     // Valid cases
@@ -615,6 +1142,19 @@ UTEST( Buffer, VertexLayoutInternals )
         
         // Total Stride = 24
         EXPECT_EQ( vhVertexLayoutDefSize( defs ), 24 );
+
+        EXPECT_EQ( vhVertexLayoutDefFormat( defs[0] ), nvrhi::Format::RGB32_FLOAT );
+        EXPECT_EQ( vhVertexLayoutDefFormat( defs[1] ), nvrhi::Format::RG32_FLOAT );
+        EXPECT_EQ( vhVertexLayoutDefFormat( defs[2] ), nvrhi::Format::RGBA8_UINT );
+    }
+
+    // Test 3: 16 and 8-bit types have no 3 component vertex formats.
+    {
+        std::vector< vhVertexLayoutDef > defs;
+        EXPECT_TRUE( vhParseVertexLayoutInternal( "half3 NORMAL half4 TANGENT", defs ) );
+        EXPECT_EQ( defs.size(), 2 );
+        EXPECT_EQ( vhVertexLayoutDefFormat( defs[0] ), nvrhi::Format::UNKNOWN );
+        EXPECT_EQ( vhVertexLayoutDefFormat( defs[1] ), nvrhi::Format::RGBA16_FLOAT );
     }
 }
 
@@ -1276,6 +1816,31 @@ UTEST( Backend, FramebufferCaching )
     // Verify caching/deduplication
     EXPECT_TRUE( vhBackend_UNITTEST_GetFrameBuffer( { colour }, depth ) );
 
+    // Another mip is another framebuffer, with both attachments at that mip.
+    nvrhi::FramebufferHandle mip0 = vhBackend_UNITTEST_FrameBuffer( { colour }, depth, 0, 0 );
+    nvrhi::FramebufferHandle mip1 = vhBackend_UNITTEST_FrameBuffer( { colour }, depth, 1, 0 );
+    ASSERT_TRUE( mip0 && mip1 );
+    EXPECT_TRUE( mip0.Get() != mip1.Get() );
+    EXPECT_EQ( mip1->getDesc().colorAttachments.size(), ( size_t ) 1 );
+    EXPECT_EQ( mip1->getDesc().colorAttachments[0].subresources.baseMipLevel, 1u );
+    EXPECT_EQ( mip1->getDesc().depthAttachment.subresources.baseMipLevel, 1u );
+    EXPECT_EQ( mip1->getFramebufferInfo().width, 64u );
+
+    // Creating the texture again under the same handle doesn't hand back a framebuffer of the old one.
+    vhCreateTexture2D( colour, glm::ivec2( 32, 32 ), 1, nvrhi::Format::RGBA8_UNORM, VRHI_TEXTURE_RT );
+    vhCreateTexture2D( depth, glm::ivec2( 32, 32 ), 1, nvrhi::Format::D24S8, VRHI_TEXTURE_RT );
+    vhFinish();
+    nvrhi::FramebufferHandle recreated = vhBackend_UNITTEST_FrameBuffer( { colour }, depth, 0, 0 );
+    ASSERT_TRUE( recreated );
+    EXPECT_TRUE( recreated->getDesc().colorAttachments[0].texture != mip0->getDesc().colorAttachments[0].texture );
+    EXPECT_EQ( recreated->getFramebufferInfo().width, 32u );
+
+    // Missing attachments and more colour attachments than NVRHI supports get no framebuffer.
+    vhTexture missing = vhAllocTexture();
+    EXPECT_FALSE( vhBackend_UNITTEST_FrameBuffer( { colour, missing }, depth, 0, 0 ) );
+    EXPECT_FALSE( vhBackend_UNITTEST_FrameBuffer( std::vector< vhTexture >( nvrhi::c_MaxRenderTargets + 1, colour ), VRHI_INVALID_HANDLE, 0, 0 ) );
+    vhDestroyTexture( missing );
+
     vhDestroyTexture( colour );
     vhDestroyTexture( depth );
     vhFinish();
@@ -1715,23 +2280,70 @@ UTEST( Texture, Type_3D )
     vhUpdateTexture( tex, 0, 0, 1, 1, data );
     vhFinish();
 
-    // Verify: Readback (Slow path reads depth slices as array layers for 3D)
-    // 3D texture readback not supported yet. This test doesnt work.
-    /*vhMem readData;
+    // Verify: Readback returns every depth slice of the mip.
+    vhMem readData;
     vhReadTextureSlow( tex, 0, 0, &readData );
-    vhFinish();
 
     ASSERT_EQ( readData.size(), totalSize );
     for ( size_t i = 0; i < totalSize; ++i )
     {
         EXPECT_EQ( readData[i], ( uint8_t )( i % 256 ) );
         if ( readData[i] != ( uint8_t )( i % 256 ) ) break;
-    }*/
+    }
 
     vhDestroyTexture( tex );
     vhFlush();
 }
 
+UTEST( Texture, ReadbackRange )
+{
+    if ( !g_testInit )
+    {
+        vhInit( g_testInitQuiet );
+        g_testInit = true;
+    }
+    int32_t startErrors = g_vhErrorCounter.load();
+
+    // Whole mip chain of a volume in one call.
+    vhTexture volume = vhAllocTexture();
+    vhTexInfo volumeInfo = { .target = nvrhi::TextureDimension::Texture3D, .format = nvrhi::Format::RGBA8_UNORM, .dimensions = glm::ivec3( 16, 16, 8 ), .arrayLayers = 1, .mipLevels = 4 };
+    std::vector< vhTextureMipInfo > volumeMips;
+    int64_t volumePitch = 0, volumeSize = 0;
+    vhTextureMiplevelInfo( volumeMips, volumePitch, volumeSize, volumeInfo );
+    std::vector< uint8_t > volumeData( volumeSize );
+    for ( size_t i = 0; i < volumeData.size(); i++ ) volumeData[i] = ( uint8_t ) ( i * 13 );
+    vhCreateTexture3D( volume, volumeInfo.dimensions, volumeInfo.mipLevels, volumeInfo.format, VRHI_TEXTURE_NONE, vhAllocMem( volumeData ) );
+
+    vhMem volumeRead;
+    vhWaitReadback( vhReadTextureAsync( volume, 0, 0, 0, 0, &volumeRead ) );
+    EXPECT_TRUE( volumeRead == volumeData );
+
+    // A sub-range of mips and layers of an array, packed the way vhUpdateTexture() takes it.
+    vhTexture array = vhAllocTexture();
+    vhTexInfo arrayInfo = { .target = nvrhi::TextureDimension::Texture2DArray, .format = nvrhi::Format::R8_UNORM, .dimensions = glm::ivec3( 32, 32, 1 ), .arrayLayers = 3, .mipLevels = 4 };
+    std::vector< vhTextureMipInfo > arrayMips;
+    int64_t arrayPitch = 0, arrayLayerSize = 0;
+    vhTextureMiplevelInfo( arrayMips, arrayPitch, arrayLayerSize, arrayInfo );
+    std::vector< uint8_t > arrayData( arrayPitch );
+    for ( size_t i = 0; i < arrayData.size(); i++ ) arrayData[i] = ( uint8_t ) ( i * 7 + i / arrayLayerSize );
+    vhCreateTexture2DArray( array, glm::ivec2( 32, 32 ), arrayInfo.arrayLayers, arrayInfo.mipLevels, arrayInfo.format, VRHI_TEXTURE_NONE, vhAllocMem( arrayData ) );
+
+    vhMem arrayRead;
+    vhWaitReadback( vhReadTextureAsync( array, 1, 1, 2, 2, &arrayRead ) );
+    std::vector< uint8_t > expected;
+    for ( int layer = 1; layer < 3; layer++ )
+    {
+        auto first = arrayData.begin() + layer * arrayLayerSize + arrayMips[1].offset;
+        expected.insert( expected.end(), first, first + arrayMips[1].size + arrayMips[2].size );
+    }
+    EXPECT_TRUE( arrayRead == expected );
+    EXPECT_EQ( g_vhErrorCounter.load(), startErrors );
+
+    vhDestroyTexture( volume );
+    vhDestroyTexture( array );
+    vhFlush();
+}
+
 UTEST( Texture, MipChain )
 {
     if ( !g_testInit )
@@ -1807,6 +2419,53 @@ UTEST( Texture, MipChain )
     vhFlush();
 }
 
+// 12 byte texel blocks: mip offsets in the staging memory must be multiples of 12 rather than of a power of two.
+UTEST( Texture, MipChainRGB32 )
+{
+    if ( !g_testInit )
+    {
+        vhInit( g_testInitQuiet );
+        g_testInit = true;
+    }
+
+    int32_t startErrors = g_vhErrorCounter.load();
+
+    const int dim = 5;
+    const int mips = 3; // 5, 2, 1
+    std::vector<size_t> mipSizes;
+    size_t totalSize = 0;
+    for ( int i = 0; i < mips; ++i )
+    {
+        int mDim = std::max( 1, dim >> i );
+        mipSizes.push_back( ( size_t ) mDim * mDim * 12 );
+        totalSize += mipSizes.back();
+    }
+
+    vhTexture tex = vhAllocTexture();
+    vhCreateTexture2D( tex, glm::ivec2( dim, dim ), mips, nvrhi::Format::RGB32_FLOAT );
+
+    auto fullData = vhAllocMem( totalSize );
+    for ( size_t i = 0; i < totalSize; ++i ) ( *fullData )[i] = ( uint8_t )( i % 251 );
+    std::vector<uint8_t> refData = *fullData;
+    vhUpdateTexture( tex, 0, 0, mips, 1, fullData );
+    vhFinish();
+
+    size_t offset = 0;
+    for ( int i = 0; i < mips; ++i )
+    {
+        vhMem readData;
+        vhReadTextureSlow( tex, i, 0, &readData );
+        vhFinish();
+        ASSERT_EQ( readData.size(), mipSizes[i] );
+        EXPECT_EQ( memcmp( readData.data(), refData.data() + offset, mipSizes[i] ), 0 );
+        offset += mipSizes[i];
+    }
+
+    EXPECT_EQ( g_vhErrorCounter.load(), startErrors );
+    vhDestroyTexture( tex );
+    vhFlush();
+}
+
 UTEST( Texture, Type_1D )
 {
     if ( !g_testInit )
@@ -2052,6 +2711,78 @@ UTEST( Buffer, StorageAlignment )
     vhFlush();
 }
 
+UTEST( Buffer, Pooled )
+{
+    if ( !g_testInit )
+    {
+        vhInit( g_testInitQuiet );
+        g_testInit = true;
+    }
+    vhFinish();
+    int32_t startErrors = g_vhErrorCounter.load();
+
+    // Lots of small meshes end up sharing backing buffers, each at its own offset.
+    const int kBuffers = 2000;
+    std::vector< vhBuffer > buffers( kBuffers );
+    for ( int i = 0; i < kBuffers; i++ )
+    {
+        buffers[i] = vhAllocBuffer();
+        std::vector< uint8_t > verts( 12 * ( 1 + i % 7 ), ( uint8_t ) i );
+        vhCreateVertexBuffer( buffers[i], "PooledMesh", vhAllocMem( verts ), "float3 POSITION", 0, VRHI_BUFFER_POOLED );
+    }
+    vhBuffer indices = vhAllocBuffer();
+    vhCreateIndexBuffer( indices, "PooledIndices", vhAllocMem( std::vector< uint8_t >( 36, 7 ) ), 0, VRHI_BUFFER_POOLED );
+    vhFinish();
+
+    std::set< void* > backing;
+    std::set< uint64_t > offsets;
+    for ( int i = 0; i < kBuffers; i++ )
+    {
+        uint64_t offset = 0;
+        backing.insert( vhGetBufferNvrhiHandle( buffers[i], &offset ) );
+        offsets.insert( offset );
+        EXPECT_EQ( vhGetBufferInfo( buffers[i] ), ( uint64_t ) 12 * ( 1 + i % 7 ) );
+    }
+    EXPECT_EQ( backing.size(), ( size_t ) 1 );
+    EXPECT_EQ( offsets.size(), ( size_t ) kBuffers );
+    uint64_t indexOffset = 0;
+    EXPECT_TRUE( backing.count( vhGetBufferNvrhiHandle( indices, &indexOffset ) ) == 0 ); // Different usage, different pool.
+
+    // Reads, updates and blits all go to the buffer's own range.
+    vhUpdateVertexBuffer( buffers[5], vhAllocMem( std::vector< uint8_t >( 12, 0xAB ) ), 1 );
+    vhMem out;
+    vhWaitReadback( vhReadBufferAsync( buffers[5], 0, 0, &out ) );
+    std::vector< uint8_t > expected( 12 * 6, 5 );
+    std::fill( expected.begin() + 12, expected.begin() + 24, 0xAB );
+    EXPECT_TRUE( out == expected );
+    vhWaitReadback( vhReadBufferAsync( buffers[6], 0, 0, &out ) );
+    EXPECT_TRUE( out == std::vector< uint8_t >( 12 * 7, 6 ) );
+    vhWaitReadback( vhReadBufferAsync( indices, 0, 0, &out ) );
+    EXPECT_TRUE( out == std::vector< uint8_t >( 36, 7 ) );
+
+    // Resizable buffers always get their own allocation.
+    vhBuffer resizable = vhAllocBuffer();
+    vhCreateVertexBuffer( resizable, "PooledResizable", vhAllocMem( 24 ), "float3 POSITION", 0, VRHI_BUFFER_POOLED | VRHI_BUFFER_ALLOW_RESIZE );
+    vhFinish();
+    EXPECT_TRUE( backing.count( vhGetBufferNvrhiHandle( resizable ) ) == 0 );
+
+    // Destroyed ranges are recycled once the GPU is done with them.
+    for ( int i = 0; i < kBuffers; i++ ) vhDestroyBuffer( buffers[i] );
+    vhFinish();
+    vhBuffer reused = vhAllocBuffer();
+    vhCreateVertexBuffer( reused, "PooledReused", vhAllocMem( 12 ), "float3 POSITION", 0, VRHI_BUFFER_POOLED );
+    vhFinish();
+    uint64_t reusedOffset = UINT64_MAX;
+    EXPECT_TRUE( backing.count( vhGetBufferNvrhiHandle( reused, &reusedOffset ) ) == 1 );
+    EXPECT_TRUE( offsets.count( reusedOffset ) == 1 );
+
+    EXPECT_EQ( g_vhErrorCounter.load(), startErrors );
+    vhDestroyBuffer( indices );
+    vhDestroyBuffer( resizable );
+    vhDestroyBuffer( reused );
+    vhFlush();
+}
+
 UTEST( Shader, Lifecycle )
 {
     if ( !g_testInit )
@@ -2626,11 +3357,92 @@ UTEST( State, BackendPropagation )
     EXPECT_FALSE( vhGetState( 999, otherState ) );
 }
 
-UTEST( State, IndividualAccessors )
+UTEST( State, PackedBlock )
 {
-    vhState state;
-    
-    // Texture with auto-resize
+    if ( !g_testInit )
+    {
+        vhInit( g_testInitQuiet );
+        g_testInit = true;
+    }
+    vhFlush();
+    int32_t startErrors = g_vhErrorCounter.load();
+
+    vhStateId id = 124;
+    vhState state;
+    state.SetViewRect( glm::vec4( 1, 2, 3, 4 ) ).SetViewScissor( glm::vec4( 5, 6, 7, 8 ) ).SetViewClear( 3, 0xFF00FF00u, 0.5f, 7 );
+    state.SetViewTransform( glm::mat4( 2.0f ), glm::mat4( 3.0f ) ).SetWorldTransform( glm::mat4( 4.0f ), 3 );
+    state.SetStateFlags( 0x1234 ).SetDebugFlags( VRHI_STATE_DEBUG_LOG_MISSING_BINDINGS ).SetStencil( 11, 12 );
+    state.SetVertexBuffer( 21, 0 ).SetVertexBuffer( 22, 2, 64 ).SetIndexBuffer( 23, 16, 1, 99 );
+    state.SetTexture( 1, { .name = "BlockTex", .texture = 31 } ).SetSampler( 0, { .slot = 2, .flags = 5 } );
+    state.SetBuffer( 0, { .slot = 4, .buffer = 41, .byteSize = 256 } );
+    state.SetConstants( { { .name = "g_A", .data = { glm::vec4( 1.0f ), glm::vec4( 2.0f ) } } } );
+    state.SetUniform( 1, { .name = "g_B", .data = { glm::vec4( 3.0f ) } } );
+    state.SetPushConstants( glm::vec4( 9.0f ) ).SetProgram( { 51, 52 } ).SetColourAttachment( 1, 61 ).SetDepthAttachment( 62 );
+
+    // Every dirty field travels in a single command.
+    uint64_t startBytes = g_vhStateBytesEnqueued.load();
+    vhSetState( id, state );
+    uint64_t blockBytes = g_vhStateBytesEnqueued.load() - startBytes;
+    EXPECT_GT( blockBytes, sizeof( VIDL_vhCmdSetStateBlock ) );
+    vhFlush();
+
+    vhState result;
+    ASSERT_TRUE( vhGetState( id, result ) );
+    EXPECT_EQ( result.viewRect, state.viewRect );
+    EXPECT_EQ( result.viewScissor, state.viewScissor );
+    EXPECT_EQ( result.clearFlags, 3 );
+    EXPECT_EQ( result.clearRgba, 0xFF00FF00u );
+    EXPECT_EQ( result.clearStencil, 7 );
+    EXPECT_EQ( result.projMatrix, glm::mat4( 3.0f ) );
+    ASSERT_EQ( result.worldMatrix.size(), 3u );
+    EXPECT_EQ( result.worldMatrix[2], glm::mat4( 4.0f ) );
+    EXPECT_EQ( result.stateFlags, 0x1234u );
+    EXPECT_EQ( result.backStencil, 12u );
+    ASSERT_EQ( result.vertexBindings.size(), 3u );
+    EXPECT_EQ( result.vertexBindings[2].buffer, 22u );
+    EXPECT_EQ( result.vertexBindings[2].byteOffset, 64u );
+    EXPECT_EQ( result.indexBinding.numIndices, 99u );
+    ASSERT_EQ( result.textures.size(), 2u );
+    EXPECT_STREQ( result.textures[1].name, "BlockTex" );
+    EXPECT_EQ( result.textures[1].texture, 31u );
+    ASSERT_EQ( result.samplers.size(), 1u );
+    EXPECT_EQ( result.samplers[0].flags, 5u );
+    ASSERT_EQ( result.buffers.size(), 1u );
+    EXPECT_EQ( result.buffers[0].byteSize, 256u );
+    ASSERT_EQ( result.constants.size(), 1u );
+    ASSERT_EQ( result.constants[0].data.size(), 2u );
+    EXPECT_EQ( result.constants[0].data[1], glm::vec4( 2.0f ) );
+    ASSERT_EQ( result.uniforms.size(), 2u );
+    EXPECT_STREQ( result.uniforms[1].name, "g_B" );
+    EXPECT_EQ( result.pushConstants, glm::vec4( 9.0f ) );
+    EXPECT_EQ( result.program, ( vhProgram { 51, 52 } ) );
+    ASSERT_EQ( result.colourAttachment.size(), 2u );
+    EXPECT_EQ( result.colourAttachment[1].texture, 61u );
+    EXPECT_EQ( result.depthAttachment.texture, 62u );
+
+    // A clean state sends nothing, a single field sends a much smaller block.
+    startBytes = g_vhStateBytesEnqueued.load();
+    vhSetState( id, state );
+    EXPECT_EQ( g_vhStateBytesEnqueued.load(), startBytes );
+    state.SetPushConstants( glm::vec4( 10.0f ) );
+    vhSetState( id, state );
+    EXPECT_EQ( g_vhStateBytesEnqueued.load() - startBytes, sizeof( VIDL_vhCmdSetStateBlock ) + sizeof( glm::vec4 ) );
+
+    // Truncated blocks are rejected.
+    uint8_t truncated[4] = {};
+    vhState scratch;
+    EXPECT_FALSE( vhApplyStateBlock( scratch, VRHI_DIRTY_PUSH_CONSTANTS, truncated, sizeof( truncated ) ) );
+    EXPECT_TRUE( vhApplyStateBlock( scratch, 0, nullptr, 0 ) );
+
+    vhFlush();
+    EXPECT_EQ( g_vhErrorCounter.load(), startErrors );
+}
+
+UTEST( State, IndividualAccessors )
+{
+    vhState state;
+    
+    // Texture with auto-resize
     {
         vhState::TextureBinding tex;
         tex.name = "ResizeTex";
@@ -2925,6 +3737,1492 @@ UTEST( Hashing, ShaderBytecode )
     EXPECT_NE( h1, 0 );
     EXPECT_EQ( h1, h2 );
     EXPECT_NE( h1, h3 );
+
+    // Other entry points and stages of the same module are different shaders.
+    MockShader* raw4 = new MockShader( { 1, 2, 3, 4 } );
+    raw4->d.entryName = "other";
+    nvrhi::ShaderHandle s4(raw4);
+    raw4->Release();
+
+    MockShader* raw5 = new MockShader( { 1, 2, 3, 4 } );
+    raw5->d.shaderType = nvrhi::ShaderType::Pixel;
+    nvrhi::ShaderHandle s5(raw5);
+    raw5->Release();
+
+    EXPECT_NE( vhHashShaderBytecode( s4 ), h1 );
+    EXPECT_NE( vhHashShaderBytecode( s5 ), h1 );
+    EXPECT_TRUE( vhShaderMatches( s1, s2 ) );
+    EXPECT_FALSE( vhShaderMatches( s1, s3 ) );
+    EXPECT_FALSE( vhShaderMatches( s1, s4 ) );
+    EXPECT_FALSE( vhShaderMatches( s1, s5 ) );
+    EXPECT_FALSE( vhShaderMatches( s1, nullptr ) );
+}
+
+UTEST( PSOCache, ComputeHitMissEvict )
+{
+    if ( !g_testInit )
+    {
+        vhInit( g_testInitQuiet );
+        g_testInit = true;
+    }
+    vhFlush();
+    int32_t baseline = g_vhErrorCounter.load();
+
+    const char* c_shaderSource = R"(
+        struct Data { float4 val; };
+        RWStructuredBuffer<Data> g_Output;
+
+        [numthreads(8, 1, 1)]
+        void main(uint3 threadID : SV_DispatchThreadID)
+        {
+            g_Output[threadID.x].val = float4(1, 2, 3, 4);
+        }
+    )";
+
+    std::vector<uint32_t> spirv;
+    std::string error;
+    bool compiled = vhCompileShader( "PSOCacheShader", c_shaderSource, VRHI_SHADER_STAGE_COMPUTE | VRHI_SHADER_SM_6_0, spirv, "main", {}, {}, &error );
+    ASSERT_TRUE( compiled );
+
+    vhShader shader = vhAllocShader();
+    vhCreateShader( shader, "PSOCacheShader", VRHI_SHADER_STAGE_COMPUTE | VRHI_SHADER_SM_6_0, spirv, "main" );
+
+    vhStateId id = 4001;
+    vhState state;
+    state.SetProgram( { shader } );
+    vhSetState( id, state );
+    vhFlush();
+
+    vhPipelineCacheStats before = vhGetPipelineCacheStats();
+    for ( int i = 0; i < 8; i++ ) vhDispatch( id, glm::uvec3( 1, 1, 1 ) );
+    vhFinish();
+
+    // Identical state only builds the pipeline once.
+    vhPipelineCacheStats after = vhGetPipelineCacheStats();
+    EXPECT_EQ( after.misses - before.misses, 1u );
+    EXPECT_EQ( after.hits - before.hits, 7u );
+    EXPECT_EQ( after.pipelines, before.pipelines + 1 );
+
+    // Destroying the shader evicts the pipelines built from it.
+    vhDestroyShader( shader );
+    vhFlush();
+    EXPECT_EQ( vhGetPipelineCacheStats().pipelines, before.pipelines );
+    EXPECT_EQ( g_vhErrorCounter.load(), baseline );
+}
+
+UTEST( PSOCache, BindingSetReuseEvict )
+{
+    if ( !g_testInit )
+    {
+        vhInit( g_testInitQuiet );
+        g_testInit = true;
+    }
+    vhFlush();
+    int32_t baseline = g_vhErrorCounter.load();
+
+    const char* c_shaderSource = R"(
+        RWTexture2D<float4> g_Output;
+
+        [numthreads(8, 8, 1)]
+        void main(uint3 threadID : SV_DispatchThreadID)
+        {
+            g_Output[threadID.xy] = float4(1, 2, 3, 4);
+        }
+    )";
+
+    std::vector<uint32_t> spirv;
+    std::string error;
+    bool compiled = vhCompileShader( "BindingSetShader", c_shaderSource, VRHI_SHADER_STAGE_COMPUTE | VRHI_SHADER_SM_6_0, spirv, "main", {}, {}, &error );
+    ASSERT_TRUE( compiled );
+
+    vhShader shader = vhAllocShader();
+    vhCreateShader( shader, "BindingSetShader", VRHI_SHADER_STAGE_COMPUTE | VRHI_SHADER_SM_6_0, spirv, "main" );
+
+    vhTexture tex = vhAllocTexture();
+    vhCreateTexture2D( tex, glm::ivec2( 16, 16 ), 1, nvrhi::Format::RGBA32_FLOAT, VRHI_TEXTURE_COMPUTE_WRITE );
+
+    vhStateId id = 4002;
+    vhState state;
+    state.SetProgram( { shader } );
+    vhState::TextureBinding binding;
+    binding.name = "g_Output";
+    binding.texture = tex;
+    binding.computeUAV = true;
+    state.SetTextures( { binding } );
+    vhSetState( id, state );
+    vhFlush();
+
+    vhPipelineCacheStats before = vhGetPipelineCacheStats();
+    for ( int i = 0; i < 8; i++ ) vhDispatch( id, glm::uvec3( 2, 2, 1 ) );
+    vhFinish();
+
+    // Steady-state dispatches with the same resources create a single binding set.
+    vhPipelineCacheStats after = vhGetPipelineCacheStats();
+    EXPECT_EQ( after.bindingSetMisses - before.bindingSetMisses, 1u );
+    EXPECT_EQ( after.bindingSetHits - before.bindingSetHits, 7u );
+    EXPECT_EQ( after.bindingSets, before.bindingSets + 1 );
+
+    // Destroying the texture evicts the binding sets that reference it.
+    vhDestroyTexture( tex );
+    vhFlush();
+    EXPECT_EQ( vhGetPipelineCacheStats().bindingSets, before.bindingSets );
+
+    vhDestroyShader( shader );
+    vhFlush();
+    EXPECT_EQ( g_vhErrorCounter.load(), baseline );
+}
+
+UTEST( PSOCache, ConstantRing )
+{
+    if ( !g_testInit )
+    {
+        vhInit( g_testInitQuiet );
+        g_testInit = true;
+    }
+    vhFlush();
+    int32_t baseline = g_vhErrorCounter.load();
+
+    const char* c_shaderSource = R"(
+        struct Params { float4 color; };
+        ConstantBuffer<Params> g_Params;
+        RWTexture2D<float4> g_Output;
+
+        [numthreads(8, 8, 1)]
+        void main(uint3 threadID : SV_DispatchThreadID)
+        {
+            g_Output[threadID.xy] = g_Params.color;
+        }
+    )";
+
+    std::vector<uint32_t> spirv;
+    std::string error;
+    bool compiled = vhCompileShader( "ConstantRingShader", c_shaderSource, VRHI_SHADER_STAGE_COMPUTE | VRHI_SHADER_SM_6_0, spirv, "main", {}, {}, &error );
+    ASSERT_TRUE( compiled );
+
+    vhShader shader = vhAllocShader();
+    vhCreateShader( shader, "ConstantRingShader", VRHI_SHADER_STAGE_COMPUTE | VRHI_SHADER_SM_6_0, spirv, "main" );
+
+    vhTexture tex = vhAllocTexture();
+    vhCreateTexture2D( tex, glm::ivec2( 8, 8 ), 1, nvrhi::Format::RGBA32_FLOAT, VRHI_TEXTURE_COMPUTE_WRITE );
+
+    vhStateId id = 4003;
+    vhState state;
+    state.SetProgram( { shader } );
+    vhState::TextureBinding binding;
+    binding.name = "g_Output";
+    binding.texture = tex;
+    binding.computeUAV = true;
+    state.SetTextures( { binding } );
+    state.SetConstants( { { .name = "g_Params", .data = { glm::vec4( 9.0f ) } } } );
+    vhSetState( id, state );
+    vhFlush();
+
+    auto fnReadFirstTexel = [&]() -> glm::vec4
+    {
+        vhMem readData;
+        vhReadTextureSlow( tex, 0, 0, &readData );
+        vhFinish();
+        glm::vec4 texel( -1.0f );
+        if ( readData.size() >= sizeof( texel ) ) std::memcpy( &texel, readData.data(), sizeof( texel ) );
+        return texel;
+    };
+
+    // Without a uniform the global constant is used.
+    vhDispatch( id, glm::uvec3( 1, 1, 1 ) );
+    EXPECT_EQ( fnReadFirstTexel(), glm::vec4( 9.0f ) );
+
+    // Per-draw uniforms override it, and every dispatch sees its own values while the binding set stays cached.
+    vhPipelineCacheStats before = vhGetPipelineCacheStats();
+    for ( int i = 0; i < 8; i++ )
+    {
+        state.SetUniforms( { { .name = "g_Params", .data = { glm::vec4( 1.0f, 2.0f, 3.0f, ( float ) i ) } } } );
+        vhSetState( id, state );
+        vhDispatch( id, glm::uvec3( 1, 1, 1 ) );
+    }
+    EXPECT_EQ( fnReadFirstTexel(), glm::vec4( 1.0f, 2.0f, 3.0f, 7.0f ) );
+    vhPipelineCacheStats after = vhGetPipelineCacheStats();
+    EXPECT_EQ( after.bindingSetMisses, before.bindingSetMisses );
+    EXPECT_EQ( after.bindingSetHits - before.bindingSetHits, 8u );
+
+    // Many more writes than a single command list's worth of versions recycle across flushes.
+    for ( int frame = 0; frame < 4; frame++ )
+    {
+        for ( int i = 0; i < 256; i++ )
+        {
+            state.SetUniforms( { { .name = "g_Params", .data = { glm::vec4( ( float ) frame, ( float ) i, 0.0f, 1.0f ) } } } );
+            vhSetState( id, state );
+            vhDispatch( id, glm::uvec3( 1, 1, 1 ) );
+        }
+        vhFlush();
+    }
+    EXPECT_EQ( fnReadFirstTexel(), glm::vec4( 3.0f, 255.0f, 0.0f, 1.0f ) );
+
+    vhDestroyTexture( tex );
+    vhDestroyShader( shader );
+    vhFlush();
+    EXPECT_EQ( g_vhErrorCounter.load(), baseline );
+}
+
+UTEST( PSOCache, StateBlock )
+{
+    if ( !g_testInit )
+    {
+        vhInit( g_testInitQuiet );
+        g_testInit = true;
+    }
+    vhFlush();
+    int32_t baseline = g_vhErrorCounter.load();
+
+    const char* c_shaderSource = R"(
+        RWTexture2D<float4> g_Output;
+
+        [numthreads(8, 8, 1)]
+        void main(uint3 threadID : SV_DispatchThreadID)
+        {
+            g_Output[threadID.xy] = float4(5, 6, 7, 8);
+        }
+    )";
+
+    std::vector<uint32_t> spirv;
+    std::string error;
+    bool compiled = vhCompileShader( "StateBlockShader", c_shaderSource, VRHI_SHADER_STAGE_COMPUTE | VRHI_SHADER_SM_6_0, spirv, "main", {}, {}, &error );
+    ASSERT_TRUE( compiled );
+
+    vhShader shader = vhAllocShader();
+    vhCreateShader( shader, "StateBlockShader", VRHI_SHADER_STAGE_COMPUTE | VRHI_SHADER_SM_6_0, spirv, "main" );
+
+    vhTexture tex = vhAllocTexture();
+    vhCreateTexture2D( tex, glm::ivec2( 8, 8 ), 1, nvrhi::Format::RGBA32_FLOAT, VRHI_TEXTURE_COMPUTE_WRITE );
+
+    vhStateId id = 4004;
+    vhState state;
+    state.SetProgram( { shader } );
+    state.SetTextures( { { .name = "g_Output", .texture = tex, .computeUAV = true } } );
+    vhPipelineCacheStats before = vhGetPipelineCacheStats();
+    vhCreateStateBlock( id, state );
+    vhFlush();
+
+    // The pipeline is built once at creation, and the name is already resolved to a slot.
+    vhPipelineCacheStats created = vhGetPipelineCacheStats();
+    EXPECT_EQ( created.misses - before.misses, 1u );
+    vhState baked;
+    ASSERT_TRUE( vhGetState( id, baked ) );
+    ASSERT_EQ( baked.textures.size(), 1u );
+    EXPECT_EQ( baked.textures[0].name, nullptr );
+    EXPECT_NE( baked.textures[0].slot, -1 );
+
+    // Dispatches don't go through the pipeline cache at all.
+    for ( int i = 0; i < 8; i++ ) vhDispatch( id, glm::uvec3( 1, 1, 1 ) );
+    vhMem readData;
+    vhReadTextureSlow( tex, 0, 0, &readData );
+    vhFinish();
+    vhPipelineCacheStats after = vhGetPipelineCacheStats();
+    EXPECT_EQ( after.hits, created.hits );
+    EXPECT_EQ( after.misses, created.misses );
+    glm::vec4 texel( 0.0f );
+    ASSERT_GE( readData.size(), sizeof( texel ) );
+    std::memcpy( &texel, readData.data(), sizeof( texel ) );
+    EXPECT_EQ( texel, glm::vec4( 5, 6, 7, 8 ) );
+
+    // State blocks are immutable until destroyed.
+    state.SetPushConstants( glm::vec4( 1.0f ) );
+    vhSetState( id, state );
+    vhFlush();
+    EXPECT_EQ( g_vhErrorCounter.load(), baseline + 1 );
+    vhDestroyStateBlock( id );
+    vhSetState( id, state, VRHI_DIRTY_ALL );
+    vhFlush();
+    EXPECT_EQ( g_vhErrorCounter.load(), baseline + 1 );
+    ASSERT_TRUE( vhGetState( id, baked ) );
+    EXPECT_EQ( baked.pushConstants, glm::vec4( 1.0f ) );
+
+    vhDestroyTexture( tex );
+    vhDestroyShader( shader );
+    vhFlush();
+    EXPECT_EQ( g_vhErrorCounter.load(), baseline + 1 );
+}
+
+// Creates a compute pipeline from scratch and returns how long the dispatch that built it took, in milliseconds.
+static double vhBenchmarkColdPipelineCreate()
+{
+    const char* c_shaderSource = R"(
+        RWStructuredBuffer<float4> g_Output;
+
+        [numthreads(64, 1, 1)]
+        void main(uint3 threadID : SV_DispatchThreadID)
+        {
+            float4 v = float4(threadID.x, 0, 0, 1);
+            for (int i = 0; i < 16; i++) v = sin(v) * cos(v.yzwx) + v;
+            g_Output[threadID.x] = v;
+        }
+    )";
+
+    std::vector<uint32_t> spirv;
+    std::string error;
+    if ( !vhCompileShader( "PipelineCacheShader", c_shaderSource, VRHI_SHADER_STAGE_COMPUTE | VRHI_SHADER_SM_6_0, spirv, "main", {}, {}, &error ) ) return -1.0;
+
+    vhShader shader = vhAllocShader();
+    vhCreateShader( shader, "PipelineCacheShader", VRHI_SHADER_STAGE_COMPUTE | VRHI_SHADER_SM_6_0, spirv, "main" );
+    vhState state;
+    state.SetProgram( { shader } );
+    vhSetState( 4100, state );
+    vhFlush();
+
+    auto start = std::chrono::high_resolution_clock::now();
+    vhDispatch( 4100, glm::uvec3( 1, 1, 1 ) );
+    vhFlush();
+    double ms = std::chrono::duration< double, std::milli >( std::chrono::high_resolution_clock::now() - start ).count();
+
+    vhDestroyShader( shader );
+    vhFinish();
+    return ms;
+}
+
+UTEST( RHI, QueueTokens )
+{
+    if ( !g_testInit )
+    {
+        vhInit( g_testInitQuiet );
+        g_testInit = true;
+    }
+    vhFlush();
+    int32_t baseline = g_vhErrorCounter.load();
+
+    const char* c_shaderSource = R"(
+        RWStructuredBuffer<float4> g_Output;
+
+        [numthreads(8, 1, 1)]
+        void main(uint3 threadID : SV_DispatchThreadID)
+        {
+            g_Output[threadID.x] = float4(1, 2, 3, 4);
+        }
+    )";
+
+    std::vector<uint32_t> spirv;
+    std::string error;
+    bool compiled = vhCompileShader( "QueueTokenShader", c_shaderSource, VRHI_SHADER_STAGE_COMPUTE | VRHI_SHADER_SM_6_0, spirv, "main", {}, {}, &error );
+    ASSERT_TRUE( compiled );
+
+    vhShader shader = vhAllocShader();
+    vhCreateShader( shader, "QueueTokenShader", VRHI_SHADER_STAGE_COMPUTE | VRHI_SHADER_SM_6_0, spirv, "main" );
+
+    vhStateId id = 4005;
+    vhState state;
+    state.SetProgram( { shader } );
+    vhSetState( id, state );
+
+    // Every dispatch gets its own token.
+    vhQueueToken a = vhDispatch( id, glm::uvec3( 1, 1, 1 ) );
+    vhQueueToken b = vhDispatch( id, glm::uvec3( 1, 1, 1 ) );
+    EXPECT_NE( a, 0u );
+    EXPECT_GT( b, a );
+
+    // Another queue waiting on it forces the producer out first; waiting on the producer's own queue is a no-op.
+    vhQueueWait( nvrhi::CommandQueue::Compute, b );
+    vhQueueWait( nvrhi::CommandQueue::Graphics, b );
+
+    // Tokens for a whole queue, including one with nothing recorded, and tokens that were never issued.
+    vhQueueToken graphics = vhQueueSignal( nvrhi::CommandQueue::Graphics );
+    vhQueueToken compute = vhQueueSignal( nvrhi::CommandQueue::Compute );
+    EXPECT_GT( compute, graphics );
+    vhQueueWait( nvrhi::CommandQueue::Compute, graphics );
+    vhQueueWait( nvrhi::CommandQueue::Graphics, compute );
+    vhQueueWait( nvrhi::CommandQueue::Graphics, compute + 1000 );
+    vhQueueWait( nvrhi::CommandQueue::Graphics, 0 );
+    vhFinish();
+
+    // Completed tokens stay valid to wait on.
+    vhQueueWait( nvrhi::CommandQueue::Compute, a );
+    vhDispatch( id, glm::uvec3( 1, 1, 1 ) );
+    vhFinish();
+
+    vhDestroyShader( shader );
+    vhFlush();
+    EXPECT_EQ( g_vhErrorCounter.load(), baseline );
+}
+
+UTEST( RHI, AsyncComputeOverlap )
+{
+    if ( !g_testInit )
+    {
+        vhInit( g_testInitQuiet );
+        g_testInit = true;
+    }
+    vhFlush();
+    int32_t baseline = g_vhErrorCounter.load();
+
+    // Long running job: every thread iterates x = x / 2 + 1, which settles on exactly 2.
+    const char* c_shaderSource = R"(
+        struct Params { float4 iterations; };
+        ConstantBuffer<Params> g_Params;
+        RWTexture2D<float4> g_Output;
+
+        [numthreads(8, 8, 1)]
+        void main(uint3 threadID : SV_DispatchThreadID)
+        {
+            float x = 0.0;
+            uint count = (uint) g_Params.iterations.x;
+            for (uint i = 0; i < count; i++) x = x * 0.5 + 1.0;
+            g_Output[threadID.xy] = float4(x, x, x, 1.0);
+        }
+    )";
+
+    std::vector<uint32_t> spirv;
+    std::string error;
+    bool compiled = vhCompileShader( "AsyncComputeShader", c_shaderSource, VRHI_SHADER_STAGE_COMPUTE | VRHI_SHADER_SM_6_0, spirv, "main", {}, {}, &error );
+    ASSERT_TRUE( compiled );
+
+    vhShader shader = vhAllocShader();
+    vhCreateShader( shader, "AsyncComputeShader", VRHI_SHADER_STAGE_COMPUTE | VRHI_SHADER_SM_6_0, spirv, "main" );
+
+    const int kSize = 128;
+    const size_t texBytes = kSize * kSize * sizeof( glm::vec4 );
+    vhTexture tex = vhAllocTexture();
+    vhCreateTexture2D( tex, glm::ivec2( kSize ), 1, nvrhi::Format::RGBA32_FLOAT, VRHI_TEXTURE_COMPUTE_WRITE );
+
+    // Graphics side: buffer to buffer copies that don't touch anything the compute job uses.
+    const size_t copyBytes = 1024 * 1024;
+    vhBuffer src = vhAllocBuffer();
+    vhBuffer dst = vhAllocBuffer();
+    vhCreateVertexBuffer( src, "AsyncComputeSrc", vhAllocMem( copyBytes ), "float4 POSITION" );
+    vhCreateVertexBuffer( dst, "AsyncComputeDst", vhAllocMem( copyBytes ), "float4 POSITION" );
+
+    vhStateId id = 4006;
+    vhState state;
+    state.SetProgram( { shader } );
+    vhState::TextureBinding binding;
+    binding.name = "g_Output";
+    binding.texture = tex;
+    binding.computeUAV = true;
+    state.SetTextures( { binding } );
+    state.SetConstants( { { .name = "g_Params", .data = { glm::vec4( 4096.0f ) } } } );
+
+    auto fnRun = [&]( uint64_t stateFlags ) -> double
+    {
+        // Clearing the texture also checks uploads wait for async compute that last touched it.
+        vhMem* zeros = vhAllocMem( texBytes );
+        std::fill( zeros->begin(), zeros->end(), 0 );
+        vhUpdateTexture( tex, 0, 0, 1, 1, zeros );
+        state.SetStateFlags( stateFlags );
+        vhSetState( id, state );
+        vhFinish();
+
+        auto start = std::chrono::high_resolution_clock::now();
+        vhQueueToken token = vhDispatch( id, glm::uvec3( kSize / 8, kSize / 8, 1 ) );
+        for ( int i = 0; i < 64; i++ ) vhBlitBuffer( dst, src, 0, 0, copyBytes );
+        vhQueueWait( nvrhi::CommandQueue::Graphics, token );
+        vhFinish();
+        return std::chrono::duration< double, std::milli >( std::chrono::high_resolution_clock::now() - start ).count();
+    };
+    auto fnReadFirstTexel = [&]() -> glm::vec4
+    {
+        vhMem readData;
+        vhReadTextureSlow( tex, 0, 0, &readData );
+        vhFinish();
+        glm::vec4 texel( -1.0f );
+        if ( readData.size() >= sizeof( texel ) ) std::memcpy( &texel, readData.data(), sizeof( texel ) );
+        return texel;
+    };
+
+    double serialMs = fnRun( VRHI_STATE_NONE );
+    EXPECT_EQ( fnReadFirstTexel(), glm::vec4( 2.0f, 2.0f, 2.0f, 1.0f ) );
+    uint64_t computeSerial = vhCmdListOpenSerial( nvrhi::CommandQueue::Compute );
+    double asyncMs = fnRun( VRHI_STATE_ASYNC_COMPUTE );
+    EXPECT_EQ( fnReadFirstTexel(), glm::vec4( 2.0f, 2.0f, 2.0f, 1.0f ) );
+    EXPECT_GT( vhCmdListOpenSerial( nvrhi::CommandQueue::Compute ), computeSerial );
+    VRHI_LOG( "    Compute job + 64 graphics copies: %.3f ms on one queue, %.3f ms with async compute\n", serialMs, asyncMs );
+
+    // Without vhQueueWait() the readback still waits for the async dispatch that wrote the texture.
+    vhMem* zeros = vhAllocMem( texBytes );
+    std::fill( zeros->begin(), zeros->end(), 0 );
+    vhUpdateTexture( tex, 0, 0, 1, 1, zeros );
+    vhDispatch( id, glm::uvec3( kSize / 8, kSize / 8, 1 ) );
+    EXPECT_EQ( fnReadFirstTexel(), glm::vec4( 2.0f, 2.0f, 2.0f, 1.0f ) );
+
+    // A compute queue in another queue family would need ownership transfers, so async dispatches use graphics then.
+    uint32_t computeFamily = g_QueueFamilyCompute;
+    g_QueueFamilyCompute = g_QueueFamilyGraphics + 1;
+    computeSerial = vhCmdListOpenSerial( nvrhi::CommandQueue::Compute );
+    fnRun( VRHI_STATE_ASYNC_COMPUTE );
+    EXPECT_EQ( fnReadFirstTexel(), glm::vec4( 2.0f, 2.0f, 2.0f, 1.0f ) );
+    EXPECT_EQ( vhCmdListOpenSerial( nvrhi::CommandQueue::Compute ), computeSerial );
+    g_QueueFamilyCompute = computeFamily;
+
+    vhDestroyBuffer( src );
+    vhDestroyBuffer( dst );
+    vhDestroyTexture( tex );
+    vhDestroyShader( shader );
+    vhFlush();
+    EXPECT_EQ( g_vhErrorCounter.load(), baseline );
+}
+
+UTEST( RHI, DispatchBufferBindings )
+{
+    if ( !g_testInit )
+    {
+        vhInit( g_testInitQuiet );
+        g_testInit = true;
+    }
+    vhFlush();
+    int32_t baseline = g_vhErrorCounter.load();
+
+    const char* c_shaderSource = R"(
+        StructuredBuffer<float4> g_Input;
+        RWStructuredBuffer<float4> g_Output;
+
+        [numthreads(8, 1, 1)]
+        void main(uint3 threadID : SV_DispatchThreadID) { g_Output[threadID.x] = g_Input[threadID.x] * 2.0; }
+    )";
+    std::vector<uint32_t> spirv;
+    std::string error;
+    ASSERT_TRUE( vhCompileShader( "DispatchBufferBindings", c_shaderSource, VRHI_SHADER_STAGE_COMPUTE | VRHI_SHADER_SM_6_0, spirv, "main", {}, {}, &error ) );
+    vhShader shader = vhAllocShader();
+    vhCreateShader( shader, "DispatchBufferBindings", VRHI_SHADER_STAGE_COMPUTE | VRHI_SHADER_SM_6_0, spirv, "main" );
+
+    // The output is bound one element in, so the first element keeps its zeroes.
+    std::vector< glm::vec4 > input( 8 );
+    for ( int i = 0; i < 8; i++ ) input[i] = glm::vec4( ( float ) i, 1.0f, 2.0f, 3.0f );
+    const uint8_t* inputBytes = ( const uint8_t* ) input.data();
+    vhBuffer inBuf = vhAllocBuffer(), outBuf = vhAllocBuffer();
+    vhCreateStorageBuffer( inBuf, "DispatchBufferInput", vhAllocMem( std::vector< uint8_t >( inputBytes, inputBytes + input.size() * sizeof( glm::vec4 ) ) ) );
+    vhCreateStorageBuffer( outBuf, "DispatchBufferOutput", vhAllocMem( std::vector< uint8_t >( 9 * sizeof( glm::vec4 ), 0 ) ) );
+
+    vhState state;
+    state.SetProgram( { shader } );
+    state.SetBuffers( {
+        { .name = "g_Input", .buffer = inBuf },
+        { .name = "g_Output", .buffer = outBuf, .byteOffset = sizeof( glm::vec4 ), .byteSize = 8 * sizeof( glm::vec4 ) }
+    } );
+    vhSetState( 4320, state );
+    vhDispatch( 4320, glm::uvec3( 1, 1, 1 ) );
+
+    vhMem readData;
+    vhWaitReadback( vhReadBufferAsync( outBuf, 0, 0, &readData ) );
+    ASSERT_EQ( readData.size(), 9 * sizeof( glm::vec4 ) );
+    std::vector< glm::vec4 > output( 9 );
+    std::memcpy( output.data(), readData.data(), readData.size() );
+    EXPECT_EQ( output[0], glm::vec4( 0.0f ) );
+    for ( int i = 0; i < 8; i++ ) EXPECT_EQ( output[i + 1], input[i] * 2.0f );
+    EXPECT_EQ( g_vhErrorCounter.load(), baseline );
+
+    // Ranges past the end of the buffer are reported and left unbound.
+    state.SetBuffers( { { .name = "g_Input", .buffer = inBuf, .byteOffset = 64, .byteSize = 128 } } );
+    vhSetState( 4320, state );
+    vhDispatch( 4320, glm::uvec3( 1, 1, 1 ) );
+    vhFinish();
+    EXPECT_EQ( g_vhErrorCounter.load(), baseline + 1 );
+
+    vhDestroyBuffer( inBuf );
+    vhDestroyBuffer( outBuf );
+    vhDestroyShader( shader );
+    vhFlush();
+    EXPECT_EQ( g_vhErrorCounter.load(), baseline + 1 );
+}
+
+UTEST( RHI, DispatchBatch )
+{
+    if ( !g_testInit )
+    {
+        vhInit( g_testInitQuiet );
+        g_testInit = true;
+    }
+    vhFlush();
+    int32_t baseline = g_vhErrorCounter.load();
+
+    // Two pipelines: one writes the constant as is, the other doubles it.
+    const char* c_shaderSources[2] = {
+        R"(
+            struct Params { float4 color; };
+            ConstantBuffer<Params> g_Params;
+            RWTexture2D<float4> g_Output;
+
+            [numthreads(8, 8, 1)]
+            void main(uint3 threadID : SV_DispatchThreadID) { g_Output[threadID.xy] = g_Params.color; }
+        )",
+        R"(
+            struct Params { float4 color; };
+            ConstantBuffer<Params> g_Params;
+            RWTexture2D<float4> g_Output;
+
+            [numthreads(8, 8, 1)]
+            void main(uint3 threadID : SV_DispatchThreadID) { g_Output[threadID.xy] = g_Params.color * 2.0; }
+        )"
+    };
+    vhShader shaders[2];
+    for ( int i = 0; i < 2; i++ )
+    {
+        std::vector<uint32_t> spirv;
+        std::string error;
+        bool compiled = vhCompileShader( "DispatchBatchShader", c_shaderSources[i], VRHI_SHADER_STAGE_COMPUTE | VRHI_SHADER_SM_6_0, spirv, "main", {}, {}, &error );
+        ASSERT_TRUE( compiled );
+        shaders[i] = vhAllocShader();
+        vhCreateShader( shaders[i], "DispatchBatchShader", VRHI_SHADER_STAGE_COMPUTE | VRHI_SHADER_SM_6_0, spirv, "main" );
+    }
+
+    // Alternating pipelines, so the batch has to regroup them. Every state writes its own texture.
+    const int kStates = 8;
+    const vhStateId firstID = 4300;
+    vhTexture textures[kStates];
+    for ( int i = 0; i < kStates; i++ )
+    {
+        textures[i] = vhAllocTexture();
+        vhCreateTexture2D( textures[i], glm::ivec2( 8, 8 ), 1, nvrhi::Format::RGBA32_FLOAT, VRHI_TEXTURE_COMPUTE_WRITE );
+
+        vhState state;
+        state.SetProgram( { shaders[i % 2] } );
+        vhState::TextureBinding binding;
+        binding.name = "g_Output";
+        binding.texture = textures[i];
+        binding.computeUAV = true;
+        state.SetTextures( { binding } );
+        state.SetConstants( { { .name = "g_Params", .data = { glm::vec4( ( float ) i ) } } } );
+        vhSetState( firstID + i, state );
+    }
+    vhFlush();
+
+    std::vector< vhDispatchDesc > descs;
+    for ( int i = 0; i < kStates; i++ ) descs.push_back( { .stateID = firstID + i, .workGroupCount = glm::uvec3( 1, 1, 1 ) } );
+    descs.push_back( { .stateID = firstID, .workGroupCount = glm::uvec3( 0, 1, 1 ) } ); // Empty, skipped quietly.
+    vhQueueToken token = vhDispatchBatch( descs.data(), descs.size() );
+    EXPECT_NE( token, 0u );
+    vhQueueWait( nvrhi::CommandQueue::Graphics, token );
+    vhFinish();
+
+    for ( int i = 0; i < kStates; i++ )
+    {
+        vhMem readData;
+        vhReadTextureSlow( textures[i], 0, 0, &readData );
+        vhFinish();
+        glm::vec4 texel( -1.0f );
+        if ( readData.size() >= sizeof( texel ) ) std::memcpy( &texel, readData.data(), sizeof( texel ) );
+        EXPECT_EQ( texel, glm::vec4( ( float ) ( i * ( 1 + i % 2 ) ) ) );
+    }
+    EXPECT_EQ( g_vhErrorCounter.load(), baseline );
+
+    // Entries writing the same texture keep their UAV barriers, so accumulating into it adds every entry up.
+    const char* c_accumulateSource = R"(
+        struct Params { float4 color; };
+        ConstantBuffer<Params> g_Params;
+        RWTexture2D<float4> g_Output;
+
+        [numthreads(8, 8, 1)]
+        void main(uint3 threadID : SV_DispatchThreadID) { g_Output[threadID.xy] += g_Params.color; }
+    )";
+    std::vector<uint32_t> accumulateSpirv;
+    std::string accumulateError;
+    ASSERT_TRUE( vhCompileShader( "DispatchBatchAccumulate", c_accumulateSource, VRHI_SHADER_STAGE_COMPUTE | VRHI_SHADER_SM_6_0, accumulateSpirv, "main", {}, {}, &accumulateError ) );
+    vhShader accumulate = vhAllocShader();
+    vhCreateShader( accumulate, "DispatchBatchAccumulate", VRHI_SHADER_STAGE_COMPUTE | VRHI_SHADER_SM_6_0, accumulateSpirv, "main" );
+
+    const vhStateId accumulateID = 4310;
+    for ( int i = 0; i < 3; i++ )
+    {
+        vhState state;
+        state.SetProgram( { i == 0 ? shaders[0] : accumulate } );
+        vhState::TextureBinding binding;
+        binding.name = "g_Output";
+        binding.texture = textures[0];
+        binding.computeUAV = true;
+        state.SetTextures( { binding } );
+        state.SetConstants( { { .name = "g_Params", .data = { glm::vec4( ( float ) i ) } } } );
+        vhSetState( accumulateID + i, state );
+    }
+    vhDispatch( accumulateID, glm::uvec3( 1, 1, 1 ) );
+    vhDispatchDesc accumulateDescs[4] = { { .stateID = accumulateID + 2 }, { .stateID = accumulateID + 1 }, { .stateID = accumulateID + 2 }, { .stateID = accumulateID + 1 } };
+    vhDispatchBatch( accumulateDescs, 4 );
+    vhFinish();
+    {
+        vhMem readData;
+        vhReadTextureSlow( textures[0], 0, 0, &readData );
+        vhFinish();
+        glm::vec4 texel( -1.0f );
+        if ( readData.size() >= sizeof( texel ) ) std::memcpy( &texel, readData.data(), sizeof( texel ) );
+        EXPECT_EQ( texel, glm::vec4( 6.0f ) );
+    }
+    vhDestroyShader( accumulate );
+    EXPECT_EQ( g_vhErrorCounter.load(), baseline );
+
+    // Unknown states are reported without dropping the rest of the batch, and empty batches do nothing.
+    vhDispatchDesc bad[2] = { { .stateID = 4999 }, { .stateID = firstID } };
+    vhDispatchBatch( bad, 2 );
+    EXPECT_EQ( vhDispatchBatch( nullptr, 0 ), 0u );
+    vhFinish();
+    EXPECT_EQ( g_vhErrorCounter.load(), baseline + 1 );
+
+    // Many small dispatches, one command each versus one batch.
+    const int kDispatches = 4096;
+    descs.clear();
+    for ( int i = 0; i < kDispatches; i++ ) descs.push_back( { .stateID = firstID + ( i % kStates ), .workGroupCount = glm::uvec3( 1, 1, 1 ) } );
+    auto start = std::chrono::high_resolution_clock::now();
+    for ( const auto& desc : descs ) vhDispatch( desc.stateID, desc.workGroupCount );
+    vhFinish();
+    double singleMs = std::chrono::duration< double, std::milli >( std::chrono::high_resolution_clock::now() - start ).count();
+    start = std::chrono::high_resolution_clock::now();
+    vhDispatchBatch( descs.data(), descs.size() );
+    vhFinish();
+    double batchMs = std::chrono::duration< double, std::milli >( std::chrono::high_resolution_clock::now() - start ).count();
+    VRHI_LOG( "    %d dispatches: %.3f ms one by one, %.3f ms batched\n", kDispatches, singleMs, batchMs );
+
+    for ( int i = 0; i < kStates; i++ ) vhDestroyTexture( textures[i] );
+    for ( int i = 0; i < 2; i++ ) vhDestroyShader( shaders[i] );
+    vhFlush();
+    EXPECT_EQ( g_vhErrorCounter.load(), baseline + 1 );
+}
+
+UTEST( Draw, RadixSort )
+{
+    std::mt19937_64 rng( 42 );
+    for ( uint64_t mask : { UINT64_MAX, UINT64_C( 0xFF00000000000000 ), UINT64_C( 0x0000000000000F0F ), UINT64_C( 0 ) } )
+    {
+        const size_t kCount = 5000;
+        std::vector< uint64_t > keys( kCount ), tempKeys( kCount );
+        std::vector< uint32_t > values( kCount ), tempValues( kCount );
+        std::vector< std::pair< uint64_t, uint32_t > > expected( kCount );
+        for ( size_t i = 0; i < kCount; i++ )
+        {
+            keys[i] = rng() & mask;
+            values[i] = ( uint32_t ) i;
+            expected[i] = { keys[i], values[i] };
+        }
+        std::stable_sort( expected.begin(), expected.end(), []( const auto& a, const auto& b ) { return a.first < b.first; } );
+
+        // Stable, so equal keys keep their order.
+        vhRadixSort64( keys.data(), values.data(), tempKeys.data(), tempValues.data(), kCount );
+        for ( size_t i = 0; i < kCount; i++ )
+        {
+            ASSERT_EQ( keys[i], expected[i].first );
+            ASSERT_EQ( values[i], expected[i].second );
+        }
+    }
+
+    EXPECT_EQ( vhMakeSortKey( 1, 2, 3, 4 ), UINT64_C( 0x0100002000030004 ) );
+    EXPECT_LT( vhMakeSortKey( 0, 0xFFFFF, 0xFFFFF, 0xFFFF ), vhMakeSortKey( 1, 0, 0, 0 ) );
+}
+
+UTEST( Draw, SortedSubmit )
+{
+    if ( !g_testInit )
+    {
+        vhInit( g_testInitQuiet );
+        g_testInit = true;
+    }
+    vhFlush();
+    int32_t baseline = g_vhErrorCounter.load();
+
+    // A fullscreen triangle in a constant colour.
+    const char* c_vertexSource = R"(
+        float4 main(uint vertexID : SV_VertexID) : SV_Position
+        {
+            float2 uv = float2((vertexID << 1) & 2, vertexID & 2);
+            return float4(uv * 2.0 - 1.0, 0.0, 1.0);
+        }
+    )";
+    const char* c_pixelSource = R"(
+        struct Params { float4 color; };
+        ConstantBuffer<Params> g_Params;
+        float4 main() : SV_Target { return g_Params.color; }
+    )";
+
+    std::vector<uint32_t> spirv;
+    std::string error;
+    vhShader vs = vhAllocShader(), ps = vhAllocShader();
+    ASSERT_TRUE( vhCompileShader( "SortedSubmitVS", c_vertexSource, VRHI_SHADER_STAGE_VERTEX | VRHI_SHADER_SM_6_0, spirv, "main", {}, {}, &error ) );
+    vhCreateShader( vs, "SortedSubmitVS", VRHI_SHADER_STAGE_VERTEX | VRHI_SHADER_SM_6_0, spirv, "main" );
+    ASSERT_TRUE( vhCompileShader( "SortedSubmitPS", c_pixelSource, VRHI_SHADER_STAGE_PIXEL | VRHI_SHADER_SM_6_0, spirv, "main", {}, {}, &error ) );
+    vhCreateShader( ps, "SortedSubmitPS", VRHI_SHADER_STAGE_PIXEL | VRHI_SHADER_SM_6_0, spirv, "main" );
+
+    vhTexture target = vhAllocTexture();
+    vhCreateTexture2D( target, glm::ivec2( 8, 8 ), 1, nvrhi::Format::RGBA32_FLOAT, VRHI_TEXTURE_RT );
+
+    // The first state clears the target, so it only works out if the backend sorts its draw first.
+    const vhStateId firstID = 4400;
+    const glm::vec4 colours[3] = { glm::vec4( 1.0f, 0.0f, 0.0f, 1.0f ), glm::vec4( 0.0f, 1.0f, 0.0f, 1.0f ), glm::vec4( 0.0f, 0.0f, 1.0f, 1.0f ) };
+    for ( int i = 0; i < 3; i++ )
+    {
+        vhState state;
+        state.SetProgram( { vs, ps } );
+        state.SetStateFlags( VRHI_STATE_WRITE_RGB | VRHI_STATE_WRITE_A );
+        state.SetColourAttachment( 0, target );
+        state.SetConstants( { { .name = "g_Params", .data = { colours[i] } } } );
+        if ( i == 0 ) state.SetViewClear( VRHI_CLEAR_COLOR, 0x000000FF );
+        vhSetState( firstID + i, state );
+    }
+    vhFlush();
+
+    auto fnReadFirstTexel = [&]() -> glm::vec4
+    {
+        vhMem readData;
+        vhReadTextureSlow( target, 0, 0, &readData );
+        vhFinish();
+        glm::vec4 texel( -1.0f );
+        if ( readData.size() >= sizeof( texel ) ) std::memcpy( &texel, readData.data(), sizeof( texel ) );
+        return texel;
+    };
+
+    vhEncoder* encoder = vhBeginEncoder();
+    vhSubmit( encoder, { .sortKey = vhMakeSortKey( 0, 0, 1, 0 ), .stateID = firstID + 1, .vertexCount = 3 } );
+    vhSubmit( encoder, { .sortKey = vhMakeSortKey( 0, 0, 0, 0 ), .stateID = firstID, .vertexCount = 3 } );
+    vhSubmit( encoder, { .sortKey = vhMakeSortKey( 0, 0, 1, 0 ), .stateID = firstID + 1, .vertexCount = 0 } ); // Empty, skipped.
+    vhEndEncoder( encoder );
+    vhFrame();
+    EXPECT_EQ( fnReadFirstTexel(), colours[1] );
+
+    vhFrameStats stats = vhGetFrameStats();
+    EXPECT_EQ( stats.draws, 2u );
+    EXPECT_EQ( stats.stateChanges, 2u );
+    EXPECT_EQ( stats.pipelineChanges, 1u );
+    EXPECT_EQ( g_vhErrorCounter.load(), baseline );
+
+    // Encoders from several threads make up one frame, sorted together. The highest key is drawn last.
+    std::vector< std::thread > threads;
+    for ( int t = 0; t < 4; t++ )
+    {
+        threads.emplace_back( [&, t]()
+        {
+            vhEncoder* threadEncoder = vhBeginEncoder();
+            for ( int i = 0; i < 64; i++ )
+            {
+                bool last = t == 0 && i == 0;
+                int stateIdx = last ? 2 : ( t + i ) % 2;
+                vhSubmit( threadEncoder, { .sortKey = vhMakeSortKey( 0, 0, 0, last ? 0xFFFF : t * 64 + i ), .stateID = firstID + stateIdx, .vertexCount = 3 } );
+            }
+            vhEndEncoder( threadEncoder );
+        } );
+    }
+    for ( auto& thread : threads ) thread.join();
+    vhFrame();
+    EXPECT_EQ( fnReadFirstTexel(), colours[2] );
+    stats = vhGetFrameStats();
+    EXPECT_EQ( stats.draws, 256u );
+    EXPECT_EQ( g_vhErrorCounter.load(), baseline );
+
+    // Unknown states are reported, the rest of the frame still draws. Empty frames do nothing.
+    encoder = vhBeginEncoder();
+    vhSubmit( encoder, { .sortKey = 0, .stateID = 4998, .vertexCount = 3 } );
+    vhSubmit( encoder, { .sortKey = 1, .stateID = firstID + 1, .vertexCount = 3 } );
+    vhEndEncoder( encoder );
+    vhFrame();
+    vhFrame();
+    EXPECT_EQ( fnReadFirstTexel(), colours[1] );
+    EXPECT_EQ( g_vhErrorCounter.load(), baseline + 1 );
+
+    // A state sorted after another one clears before any draw, not between them. The clearing state draws off the
+    // first texel, so that keeps the colour of the draw sorted before the clear.
+    vhState clearing;
+    clearing.SetProgram( { vs, ps } );
+    clearing.SetStateFlags( VRHI_STATE_WRITE_RGB | VRHI_STATE_WRITE_A );
+    clearing.SetColourAttachment( 0, target );
+    clearing.SetConstants( { { .name = "g_Params", .data = { colours[0] } } } );
+    clearing.SetViewRect( glm::vec4( 4.0f, 4.0f, 4.0f, 4.0f ) );
+    clearing.SetViewClear( VRHI_CLEAR_COLOR, 0xFFFFFFFF );
+    vhSetState( firstID + 3, clearing );
+    encoder = vhBeginEncoder();
+    vhSubmit( encoder, { .sortKey = 1, .stateID = firstID + 3, .vertexCount = 3 } );
+    vhSubmit( encoder, { .sortKey = 0, .stateID = firstID + 2, .vertexCount = 3 } );
+    vhEndEncoder( encoder );
+    vhFrame();
+    EXPECT_EQ( fnReadFirstTexel(), colours[2] );
+    EXPECT_EQ( g_vhErrorCounter.load(), baseline + 1 );
+
+    vhDestroyTexture( target );
+    vhDestroyShader( vs );
+    vhDestroyShader( ps );
+    vhFlush();
+    EXPECT_EQ( g_vhErrorCounter.load(), baseline + 1 );
+}
+
+UTEST( Draw, VertexBuffer )
+{
+    if ( !g_testInit )
+    {
+        vhInit( g_testInitQuiet );
+        g_testInit = true;
+    }
+    vhFlush();
+    int32_t baseline = g_vhErrorCounter.load();
+
+    // Positions and colours come from two streams, in that order.
+    const char* c_vertexSource = R"(
+        struct VSOut { float4 pos : SV_Position; float4 colour : COLOR; };
+        VSOut main(float2 pos : POSITION, float4 colour : COLOR)
+        {
+            VSOut o;
+            o.pos = float4(pos, 0.0, 1.0);
+            o.colour = colour;
+            return o;
+        }
+    )";
+    const char* c_pixelSource = R"(
+        float4 main(float4 pos : SV_Position, float4 colour : COLOR) : SV_Target { return colour; }
+    )";
+
+    std::vector<uint32_t> spirv;
+    std::string error;
+    vhShader vs = vhAllocShader(), ps = vhAllocShader();
+    ASSERT_TRUE( vhCompileShader( "VertexBufferVS", c_vertexSource, VRHI_SHADER_STAGE_VERTEX | VRHI_SHADER_SM_6_0, spirv, "main", {}, {}, &error ) );
+    vhCreateShader( vs, "VertexBufferVS", VRHI_SHADER_STAGE_VERTEX | VRHI_SHADER_SM_6_0, spirv, "main" );
+    ASSERT_TRUE( vhCompileShader( "VertexBufferPS", c_pixelSource, VRHI_SHADER_STAGE_PIXEL | VRHI_SHADER_SM_6_0, spirv, "main", {}, {}, &error ) );
+    vhCreateShader( ps, "VertexBufferPS", VRHI_SHADER_STAGE_PIXEL | VRHI_SHADER_SM_6_0, spirv, "main" );
+
+    vhTexture target = vhAllocTexture();
+    vhCreateTexture2D( target, glm::ivec2( 8, 8 ), 1, nvrhi::Format::RGBA32_FLOAT, VRHI_TEXTURE_RT );
+
+    // A fullscreen triangle behind an offscreen vertex, which startVertex skips.
+    const glm::vec2 positions[4] = { glm::vec2( 5.0f ), glm::vec2( -1.0f, -1.0f ), glm::vec2( 3.0f, -1.0f ), glm::vec2( -1.0f, 3.0f ) };
+    const glm::vec4 colour( 0.0f, 1.0f, 0.0f, 1.0f );
+    const glm::vec4 colours[3] = { colour, colour, colour };
+    auto fnAllocMem = []( const void* data, size_t size ) { return vhAllocMem( std::vector< uint8_t >( ( const uint8_t* ) data, ( const uint8_t* ) data + size ) ); };
+    vhBuffer positionBuffer = vhAllocBuffer(), colourBuffer = vhAllocBuffer(), badBuffer = vhAllocBuffer();
+    vhCreateVertexBuffer( positionBuffer, "VertexBufferPositions", fnAllocMem( positions, sizeof( positions ) ), "float2 POSITION" );
+    vhCreateVertexBuffer( colourBuffer, "VertexBufferColours", fnAllocMem( colours, sizeof( colours ) ), "float4 COLOR" );
+    vhCreateVertexBuffer( badBuffer, "VertexBufferHalf3", vhAllocMem( 64 ), "half3 COLOR" ); // No half3 vertex format.
+
+    const vhStateId stateID = 4410, badStateID = 4411;
+    vhState state;
+    state.SetProgram( { vs, ps } );
+    state.SetStateFlags( VRHI_STATE_WRITE_RGB | VRHI_STATE_WRITE_A );
+    state.SetColourAttachment( 0, target );
+    state.SetViewClear( VRHI_CLEAR_COLOR, 0x000000FF );
+    state.SetVertexBuffer( positionBuffer, 0, 0, 1 );
+    state.SetVertexBuffer( colourBuffer, 1 );
+    vhSetState( stateID, state );
+    state.SetVertexBuffer( badBuffer, 1 );
+    vhSetState( badStateID, state );
+    vhFlush();
+
+    vhEncoder* encoder = vhBeginEncoder();
+    vhSubmit( encoder, { .sortKey = 0, .stateID = stateID, .vertexCount = 3 } );
+    vhEndEncoder( encoder );
+    vhFrame();
+
+    vhMem readData;
+    vhReadTextureSlow( target, 0, 0, &readData );
+    vhFinish();
+    glm::vec4 texel( -1.0f );
+    if ( readData.size() >= sizeof( texel ) ) std::memcpy( &texel, readData.data(), sizeof( texel ) );
+    EXPECT_EQ( texel, colour );
+    EXPECT_EQ( g_vhErrorCounter.load(), baseline );
+
+    // Attributes without a vertex format are reported and the draw is skipped.
+    encoder = vhBeginEncoder();
+    vhSubmit( encoder, { .sortKey = 0, .stateID = badStateID, .vertexCount = 3 } );
+    vhEndEncoder( encoder );
+    vhFrame();
+    vhFinish();
+    EXPECT_EQ( g_vhErrorCounter.load(), baseline + 1 );
+    EXPECT_EQ( vhGetFrameStats().draws, 0u );
+
+    // So is an index buffer offset past the end of the buffer.
+    const uint16_t indices[3] = { 1, 2, 3 };
+    vhBuffer indexBuffer = vhAllocBuffer();
+    vhCreateIndexBuffer( indexBuffer, "VertexBufferIndices", fnAllocMem( indices, sizeof( indices ) ), 3 );
+    state.SetVertexBuffer( colourBuffer, 1 );
+    state.SetIndexBuffer( indexBuffer, sizeof( indices ) );
+    vhSetState( badStateID, state );
+    encoder = vhBeginEncoder();
+    vhSubmit( encoder, { .sortKey = 0, .stateID = badStateID, .vertexCount = 3 } );
+    vhEndEncoder( encoder );
+    vhFrame();
+    vhFinish();
+    EXPECT_EQ( g_vhErrorCounter.load(), baseline + 2 );
+    EXPECT_EQ( vhGetFrameStats().draws, 0u );
+
+    vhDestroyBuffer( positionBuffer );
+    vhDestroyBuffer( colourBuffer );
+    vhDestroyBuffer( badBuffer );
+    vhDestroyBuffer( indexBuffer );
+    vhDestroyTexture( target );
+    vhDestroyShader( vs );
+    vhDestroyShader( ps );
+    vhFlush();
+    EXPECT_EQ( g_vhErrorCounter.load(), baseline + 2 );
+}
+
+UTEST( PSOCache, PipelineCacheFile )
+{
+    // Needs its own init / shutdown cycles, since the cache is loaded in vhInit() and saved in vhShutdown().
+    if ( g_testInit )
+    {
+        vhShutdown( g_testInitQuiet );
+        g_testInit = false;
+    }
+
+    std::filesystem::path path = std::filesystem::temp_directory_path() / "vrhi_test_pipeline_cache.bin";
+    std::filesystem::remove( path );
+    g_vhInit.pipelineCachePath = path.string();
+
+    // First run: empty cache, pipelines are compiled from scratch and the cache is written on shutdown.
+    vhInit( g_testInitQuiet );
+    double firstMs = vhBenchmarkColdPipelineCreate();
+    vhShutdown( g_testInitQuiet );
+    ASSERT_TRUE( std::filesystem::exists( path ) );
+    EXPECT_GT( std::filesystem::file_size( path ), sizeof( vhPipelineCacheFileHeader ) );
+
+    // Second run: seeded from disk. On the lavapipe CPU device this skips LLVM codegen for the pipeline.
+    vhInit( g_testInitQuiet );
+    double secondMs = vhBenchmarkColdPipelineCreate();
+    EXPECT_TRUE( vhSavePipelineCache() );
+    vhShutdown( g_testInitQuiet );
+    printf( "    Pipeline creation: first run %.3f ms, second run %.3f ms\n", firstMs, secondMs );
+    EXPECT_GE( firstMs, 0.0 );
+    EXPECT_GE( secondMs, 0.0 );
+
+    // A corrupt cache file is ignored rather than handed to the driver.
+    {
+        FILE* f = fopen( path.string().c_str(), "r+b" );
+        ASSERT_TRUE( f != nullptr );
+        uint32_t junk = 0xDEADBEEF;
+        fseek( f, sizeof( vhPipelineCacheFileHeader ) + 4, SEEK_SET );
+        fwrite( &junk, sizeof( junk ), 1, f );
+        fclose( f );
+    }
+    int32_t baseline = g_vhErrorCounter.load();
+    vhInit( g_testInitQuiet );
+    EXPECT_GE( vhBenchmarkColdPipelineCreate(), 0.0 );
+    vhShutdown( g_testInitQuiet );
+    EXPECT_EQ( g_vhErrorCounter.load(), baseline );
+
+    // So is one whose header claims more data than the file holds, without trying to allocate it.
+    {
+        FILE* f = fopen( path.string().c_str(), "r+b" );
+        ASSERT_TRUE( f != nullptr );
+        uint64_t hugeSize = UINT64_C( 1 ) << 40;
+        fseek( f, offsetof( vhPipelineCacheFileHeader, dataSize ), SEEK_SET );
+        fwrite( &hugeSize, sizeof( hugeSize ), 1, f );
+        fclose( f );
+    }
+    vhInit( g_testInitQuiet );
+    EXPECT_GE( vhBenchmarkColdPipelineCreate(), 0.0 );
+    vhShutdown( g_testInitQuiet );
+    EXPECT_EQ( g_vhErrorCounter.load(), baseline );
+
+    g_vhInit.pipelineCachePath = "";
+    std::filesystem::remove( path );
+}
+
+// Issues |count| vhSetState calls, one command each, publishing every |batchSize| commands. Returns the end-to-end
+// throughput in calls/second. The backend drains in bulk either way, so batch size 1 only isolates the publishing
+// cost; it is not the per-command enqueue / dequeue path that batching replaced.
+static double vhBenchmarkSetStateStorm( int batchSize, int count )
+{
+    int prevBatchSize = g_vhInit.commandBatchSize;
+    g_vhInit.commandBatchSize = batchSize;
+
+    vhState state;
+    auto start = std::chrono::high_resolution_clock::now();
+    for ( int i = 0; i < count; i++ )
+    {
+        state.SetViewRect( glm::vec4( 0.0f, 0.0f, ( float ) i, ( float ) i ) );
+        state.SetPushConstants( glm::vec4( ( float ) i ) );
+        vhSetState( 5000 + ( i & 63 ), state );
+    }
+    vhFlush();
+    double seconds = std::chrono::duration< double >( std::chrono::high_resolution_clock::now() - start ).count();
+
+    g_vhInit.commandBatchSize = prevBatchSize;
+    return count / seconds;
+}
+
+UTEST( Benchmark, SetStateStorm )
+{
+    if ( !g_testInit )
+    {
+        vhInit( g_testInitQuiet );
+        g_testInit = true;
+    }
+
+    const int kCount = 100000;
+    int batchSize = vhInitData().commandBatchSize;
+    double publishEach = vhBenchmarkSetStateStorm( 1, kCount );
+    double publishBatched = vhBenchmarkSetStateStorm( batchSize, kCount );
+    printf( "    vhSetState storm (%d calls): publish every call %.2f Mcalls/s, every %d calls %.2f Mcalls/s (%.2fx)\n",
+        kCount, publishEach / 1e6, batchSize, publishBatched / 1e6, publishBatched / publishEach );
+
+    // Every command must have reached the backend.
+    vhState backendState;
+    EXPECT_TRUE( vhGetState( 5000 + ( ( kCount - 1 ) & 63 ), backendState ) );
+    EXPECT_NEAR( backendState.pushConstants.x, ( float ) ( kCount - 1 ), 0.5f );
+}
+
+// Resolves |lookups| handles through |find| and returns the lookup rate in lookups/second.
+template< typename F >
+static double vhBenchmarkResourceLookups( const std::vector< uint32_t >& lookups, F find, uint64_t& checksum )
+{
+    auto start = std::chrono::high_resolution_clock::now();
+    for ( uint32_t handle : lookups ) checksum += find( handle );
+    double seconds = std::chrono::duration< double >( std::chrono::high_resolution_clock::now() - start ).count();
+    return lookups.size() / seconds;
+}
+
+UTEST( Benchmark, ResourceLookup )
+{
+    // Mirrors the backend texture table with 50k live textures, resolved the way a submit resolves its bindings.
+    struct Resource { uint64_t payload[8]; };
+    const uint32_t kLiveTextures = 50000;
+    const int kSubmits = 200000, kBindingsPerSubmit = 8;
+
+    std::map< uint32_t, std::unique_ptr< Resource > > map;
+    vhSlotTable< std::unique_ptr< Resource > > table;
+    for ( uint32_t i = 0; i < kLiveTextures; i++ )
+    {
+        map[i] = std::make_unique< Resource >( Resource { { i } } );
+        table[i] = std::make_unique< Resource >( Resource { { i } } );
+    }
+
+    std::mt19937 rng( 12345 );
+    std::vector< uint32_t > lookups( kSubmits * kBindingsPerSubmit );
+    for ( auto& handle : lookups ) handle = rng() % kLiveTextures;
+
+    uint64_t mapSum = 0, tableSum = 0;
+    double mapRate = vhBenchmarkResourceLookups( lookups, [&]( uint32_t h ) { auto it = map.find( h ); return it != map.end() ? it->second->payload[0] : 0; }, mapSum );
+    double tableRate = vhBenchmarkResourceLookups( lookups, [&]( uint32_t h ) { auto* it = table.find( h ); return it ? ( *it )->payload[0] : 0; }, tableSum );
+    printf( "    Resource lookups (%u live): std::map %.2f M/s, slot table %.2f M/s (%.2fx)\n",
+        kLiveTextures, mapRate / 1e6, tableRate / 1e6, tableRate / mapRate );
+
+    EXPECT_EQ( mapSum, tableSum );
+    EXPECT_EQ( table.size(), ( size_t ) kLiveTextures );
+}
+
+// Allocates and releases |perThread| handles on each of |threads| threads and returns the rate in alloc+release pairs/second.
+template< typename Alloc, typename Release >
+static double vhBenchmarkHandleChurn( int threads, int perThread, Alloc alloc, Release release )
+{
+    auto start = std::chrono::high_resolution_clock::now();
+    std::vector< std::thread > workers;
+    for ( int t = 0; t < threads; t++ )
+    {
+        workers.emplace_back( [&]()
+        {
+            std::vector< uint32_t > handles( 64 );
+            for ( int i = 0; i < perThread; i += 64 )
+            {
+                for ( auto& h : handles ) h = alloc();
+                for ( auto h : handles ) release( h );
+            }
+        } );
+    }
+    for ( auto& worker : workers ) worker.join();
+    double seconds = std::chrono::duration< double >( std::chrono::high_resolution_clock::now() - start ).count();
+    return ( double ) threads * perThread / seconds;
+}
+
+UTEST( Benchmark, HandleAlloc )
+{
+    const int kThreads = 8, kPerThread = 200000;
+
+    // The previous scheme: a mutex around a free list plus a validity hashmap.
+    std::mutex mutex;
+    vhAllocatorObjectFreeList freeList( kThreads * 64 );
+    std::unordered_map< uint32_t, bool > validity;
+    double locked = vhBenchmarkHandleChurn( kThreads, kPerThread,
+        [&]() { std::lock_guard< std::mutex > lock( mutex ); uint32_t id = freeList.alloc(); validity[id] = true; return id; },
+        [&]( uint32_t id ) { std::lock_guard< std::mutex > lock( mutex ); if ( validity.erase( id ) ) freeList.release( id ); } );
+
+    vhHandleAllocator allocator;
+    double lockFree = vhBenchmarkHandleChurn( kThreads, kPerThread,
+        [&]() { return allocator.alloc(); },
+        [&]( uint32_t id ) { allocator.release( id ); } );
+
+    printf( "    Handle alloc+release (%d threads): locked %.2f M/s, lock-free %.2f M/s (%.2fx)\n",
+        kThreads, locked / 1e6, lockFree / 1e6, lockFree / locked );
+    EXPECT_EQ( allocator.count(), 0u );
+}
+
+// Streams |uploads| into |textures| round robin and returns the throughput in MB/s, up to the GPU finishing the copies.
+static double vhBenchmarkStreamingUpload( bool transferQueue, const std::vector< vhTexture >& textures, std::vector< vhMem* >& uploads )
+{
+    bool prevTransferQueue = g_vhInit.transferQueueUploads;
+    g_vhInit.transferQueueUploads = transferQueue;
+
+    uint64_t bytes = 0;
+    auto start = std::chrono::high_resolution_clock::now();
+    for ( size_t i = 0; i < uploads.size(); i++ )
+    {
+        bytes += uploads[i]->size();
+        vhUpdateTexture( textures[i % textures.size()], 0, 0, 1, 1, uploads[i] );
+    }
+    vhFinish();
+    double seconds = std::chrono::duration< double >( std::chrono::high_resolution_clock::now() - start ).count();
+
+    g_vhInit.transferQueueUploads = prevTransferQueue;
+    return bytes / ( 1024.0 * 1024.0 ) / seconds;
+}
+
+UTEST( Benchmark, StreamingUpload )
+{
+    if ( !g_testInit )
+    {
+        vhInit( g_testInitQuiet );
+        g_testInit = true;
+    }
+    vhFinish();
+    int32_t startErrors = g_vhErrorCounter.load();
+
+    const int kSize = 1024, kTextures = 8, kUploads = 32;
+    const uint64_t kBytes = ( uint64_t ) kSize * kSize * 4;
+    std::vector< vhTexture > textures( kTextures );
+    for ( auto& tex : textures )
+    {
+        tex = vhAllocTexture();
+        vhCreateTexture2D( tex, glm::ivec2( kSize, kSize ), 1, nvrhi::Format::RGBA8_UNORM );
+    }
+    vhFinish();
+
+    // The upload data is prepared up front so only the upload path is timed.
+    auto makeUploads = [&]( uint8_t seed )
+    {
+        std::vector< vhMem* > uploads( kUploads );
+        for ( int i = 0; i < kUploads; i++ )
+        {
+            uploads[i] = vhAllocMem( kBytes );
+            for ( uint64_t j = 0; j < kBytes; j += 4096 ) ( *uploads[i] )[j] = ( uint8_t ) ( seed + i + j / 4096 );
+        }
+        return uploads;
+    };
+
+    auto graphicsUploads = makeUploads( 0 );
+    double graphics = vhBenchmarkStreamingUpload( false, textures, graphicsUploads );
+    auto transferUploads = makeUploads( 7 );
+    std::vector< uint8_t > expected = *transferUploads.back();
+    double transfer = vhBenchmarkStreamingUpload( true, textures, transferUploads );
+    printf( "    Streaming upload (%d x %d MB): graphics queue %.1f MB/s, transfer queue + staging ring %.1f MB/s (%.2fx)\n",
+        kUploads, ( int ) ( kBytes >> 20 ), graphics, transfer, transfer / graphics );
+
+    // The last upload through the staging ring must have landed intact.
+    vhMem readData;
+    vhReadTextureSlow( textures[( kUploads - 1 ) % kTextures], 0, 0, &readData );
+    vhFinish();
+    EXPECT_TRUE( readData == expected );
+
+    for ( auto tex : textures ) vhDestroyTexture( tex );
+    vhFinish();
+    EXPECT_EQ( g_vhErrorCounter.load(), startErrors );
+}
+
+// Appends |appends| chunks of |chunkSize| bytes to a fresh resizable buffer and returns the bytes its reallocations copied.
+static uint64_t vhBenchmarkBufferAppends( int appends, uint64_t chunkSize, uint64_t reserve, vhBuffer* outBuffer )
+{
+    vhFinish();
+    uint64_t startCopied = g_vhBufferResizeBytesCopied.load();
+
+    vhBuffer buf = vhAllocBuffer();
+    vhCreateStorageBuffer( buf, "BufferAppends", nullptr, chunkSize, VRHI_BUFFER_COMPUTE_READ_WRITE | VRHI_BUFFER_ALLOW_RESIZE );
+    if ( reserve ) vhReserveBuffer( buf, reserve );
+    for ( int i = 0; i < appends; i++ )
+    {
+        vhUpdateStorageBuffer( buf, vhAllocMem( std::vector< uint8_t >( chunkSize, ( uint8_t ) i ) ), i * chunkSize, chunkSize );
+    }
+    vhFinish();
+
+    *outBuffer = buf;
+    return g_vhBufferResizeBytesCopied.load() - startCopied;
+}
+
+UTEST( Benchmark, BufferAppends )
+{
+    if ( !g_testInit )
+    {
+        vhInit( g_testInitQuiet );
+        g_testInit = true;
+    }
+    vhFinish();
+    int32_t startErrors = g_vhErrorCounter.load();
+
+    const int kAppends = 10000;
+    const uint64_t kChunk = 64, kTotal = kAppends * kChunk;
+
+    vhBuffer grown = VRHI_INVALID_HANDLE, reserved = VRHI_INVALID_HANDLE;
+    uint64_t grownCopied = vhBenchmarkBufferAppends( kAppends, kChunk, 0, &grown );
+    uint64_t reservedCopied = vhBenchmarkBufferAppends( kAppends, kChunk, kTotal, &reserved );
+
+    // Exactly sized reallocations would copy every previous append again on each one.
+    uint64_t exactCopied = kChunk * kAppends * ( kAppends - 1 ) / 2;
+    printf( "    %d x %llu byte appends: exact growth would copy %.1f MB, geometric growth copied %.2f MB, reserved copied %llu bytes\n",
+        kAppends, ( unsigned long long ) kChunk, exactCopied / ( 1024.0 * 1024.0 ), grownCopied / ( 1024.0 * 1024.0 ), ( unsigned long long ) reservedCopied );
+    EXPECT_LT( grownCopied, 2 * kTotal );
+    EXPECT_EQ( reservedCopied, ( uint64_t ) 0 );
+
+    // Capacity is an implementation detail; the logical size and contents are what was appended.
+    for ( vhBuffer buf : { grown, reserved } )
+    {
+        EXPECT_EQ( vhGetBufferInfo( buf ), kTotal );
+        vhMem head, tail;
+        vhWaitReadback( vhReadBufferAsync( buf, 0, kChunk, &head ) );
+        vhWaitReadback( vhReadBufferAsync( buf, kTotal - kChunk, kChunk, &tail ) );
+        EXPECT_TRUE( head == std::vector< uint8_t >( kChunk, 0 ) );
+        EXPECT_TRUE( tail == std::vector< uint8_t >( kChunk, ( uint8_t ) ( kAppends - 1 ) ) );
+    }
+
+    // Reads past the logical size are rejected even though the allocation is larger.
+    vhMem unused;
+    vhWaitReadback( vhReadBufferAsync( grown, kTotal, kChunk, &unused ) );
+    EXPECT_EQ( g_vhErrorCounter.load(), startErrors + 1 );
+
+    vhDestroyBuffer( grown );
+    vhDestroyBuffer( reserved );
+    vhFinish();
+}
+
+// Rebinds one texture of a 16 slot table per frame and returns the state command bytes enqueued per frame.
+static uint64_t vhBenchmarkStateDeltas( vhStateId id, bool perSlot, int frames )
+{
+    vhState state;
+    std::vector< vhState::TextureBinding > textures( 16 );
+    for ( int i = 0; i < 16; i++ ) textures[i] = { .slot = i, .texture = ( vhTexture ) ( 100 + i ) };
+    state.SetTextures( textures );
+    state.SetConstants( { { .name = "g_Globals", .data = std::vector< glm::vec4 >( 16, glm::vec4( 1.0f ) ) } } );
+    vhSetState( id, state );
+    vhFlush();
+
+    uint64_t start = g_vhStateBytesEnqueued.load();
+    for ( int frame = 0; frame < frames; frame++ )
+    {
+        textures[frame % 16].texture = ( vhTexture ) ( 1000 + frame );
+        if ( perSlot ) state.SetTexture( frame % 16, textures[frame % 16] );
+        else state.SetTextures( textures );
+        vhSetState( id, state );
+    }
+    vhFlush();
+    return ( g_vhStateBytesEnqueued.load() - start ) / frames;
+}
+
+UTEST( Benchmark, StateDeltas )
+{
+    if ( !g_testInit )
+    {
+        vhInit( g_testInitQuiet );
+        g_testInit = true;
+    }
+    vhFinish();
+
+    const int kFrames = 1000;
+    uint64_t wholeBytes = vhBenchmarkStateDeltas( 4200, false, kFrames );
+    uint64_t slotBytes = vhBenchmarkStateDeltas( 4201, true, kFrames );
+    printf( "    1 of 16 textures rebound per frame: whole table %llu bytes/frame, per-slot %llu bytes/frame (%.1fx)\n",
+        ( unsigned long long ) wholeBytes, ( unsigned long long ) slotBytes, ( double ) wholeBytes / slotBytes );
+    EXPECT_LT( slotBytes * 4, wholeBytes );
+
+    // Both paths leave the backend with the same table.
+    vhState whole, slots;
+    ASSERT_TRUE( vhGetState( 4200, whole ) );
+    ASSERT_TRUE( vhGetState( 4201, slots ) );
+    ASSERT_EQ( slots.textures.size(), 16u );
+    for ( int i = 0; i < 16; i++ ) EXPECT_EQ( slots.textures[i].texture, whole.textures[i].texture );
+    EXPECT_EQ( slots.textures[( kFrames - 1 ) % 16].texture, ( vhTexture ) ( 1000 + kFrames - 1 ) );
+    EXPECT_EQ( slots.constants.size(), 1u );
+
+    // Setting a slot past the end grows the backend table with it. Untouched slots keep what the backend had.
+    vhState state;
+    state.SetTexture( 20, { .slot = 20, .texture = 77 } );
+    vhSetState( 4201, state );
+    vhFlush();
+    ASSERT_TRUE( vhGetState( 4201, slots ) );
+    ASSERT_EQ( slots.textures.size(), 21u );
+    EXPECT_EQ( slots.textures[20].texture, 77u );
+    EXPECT_EQ( slots.textures[3].texture, whole.textures[3].texture );
+}
+
+UTEST( Benchmark, DrawSubmit )
+{
+    if ( !g_testInit )
+    {
+        vhInit( g_testInitQuiet );
+        g_testInit = true;
+    }
+    vhFinish();
+    int32_t baseline = g_vhErrorCounter.load();
+
+    const char* c_vertexSource = R"(
+        float4 main(uint vertexID : SV_VertexID) : SV_Position { return float4(0.0, 0.0, 0.0, 1.0); }
+    )";
+    const char* c_pixelSource = R"(
+        struct Params { float4 color; };
+        ConstantBuffer<Params> g_Params;
+        float4 main() : SV_Target { return g_Params.color; }
+    )";
+
+    std::vector<uint32_t> spirv;
+    std::string error;
+    vhShader vs = vhAllocShader(), ps = vhAllocShader();
+    ASSERT_TRUE( vhCompileShader( "DrawSubmitVS", c_vertexSource, VRHI_SHADER_STAGE_VERTEX | VRHI_SHADER_SM_6_0, spirv, "main", {}, {}, &error ) );
+    vhCreateShader( vs, "DrawSubmitVS", VRHI_SHADER_STAGE_VERTEX | VRHI_SHADER_SM_6_0, spirv, "main" );
+    ASSERT_TRUE( vhCompileShader( "DrawSubmitPS", c_pixelSource, VRHI_SHADER_STAGE_PIXEL | VRHI_SHADER_SM_6_0, spirv, "main", {}, {}, &error ) );
+    vhCreateShader( ps, "DrawSubmitPS", VRHI_SHADER_STAGE_PIXEL | VRHI_SHADER_SM_6_0, spirv, "main" );
+
+    vhTexture target = vhAllocTexture();
+    vhCreateTexture2D( target, glm::ivec2( 8, 8 ), 1, nvrhi::Format::RGBA8_UNORM, VRHI_TEXTURE_RT );
+
+    // 16 materials over 2 pipelines (write masks), drawing degenerate triangles so only the CPU side costs anything.
+    const int kStates = 16;
+    const vhStateId firstID = 4500;
+    for ( int i = 0; i < kStates; i++ )
+    {
+        vhState state;
+        state.SetProgram( { vs, ps } );
+        state.SetStateFlags( i % 2 ? VRHI_STATE_WRITE_RGB : VRHI_STATE_WRITE_RGB | VRHI_STATE_WRITE_A );
+        state.SetColourAttachment( 0, target );
+        state.SetConstants( { { .name = "g_Params", .data = { glm::vec4( ( float ) i / kStates ) } } } );
+        vhSetState( firstID + i, state );
+    }
+    vhFinish();
+
+    const int kDraws = 100000;
+    std::mt19937 rng( 7 );
+    std::vector< vhDraw > draws( kDraws );
+    for ( auto& draw : draws )
+    {
+        int material = rng() % kStates;
+        draw = { .sortKey = vhMakeSortKey( 0, material % 2, material, rng() & 0xFFFF ), .stateID = firstID + ( vhStateId ) material, .vertexCount = 3 };
+    }
+
+    auto fnSubmitFrame = [&]( bool sorted ) -> vhFrameStats
+    {
+        vhEncoder* encoder = vhBeginEncoder();
+        for ( vhDraw draw : draws )
+        {
+            if ( !sorted ) draw.sortKey = 0;
+            vhSubmit( encoder, draw );
+        }
+        vhEndEncoder( encoder );
+        vhFrame();
+        vhFinish();
+        return vhGetFrameStats();
+    };
+    fnSubmitFrame( true ); // Warm up the pipelines and binding sets.
+    vhFrameStats sorted = fnSubmitFrame( true );
+    vhFrameStats unsorted = fnSubmitFrame( false );
+    printf( "    %d draws sorted: sort %.3f ms, record %.3f ms, %llu state / %llu pipeline changes\n",
+        kDraws, sorted.sortMs, sorted.recordMs, ( unsigned long long ) sorted.stateChanges, ( unsigned long long ) sorted.pipelineChanges );
+    printf( "    %d draws in submission order: record %.3f ms, %llu state / %llu pipeline changes\n",
+        kDraws, unsorted.recordMs, ( unsigned long long ) unsorted.stateChanges, ( unsigned long long ) unsorted.pipelineChanges );
+    EXPECT_EQ( sorted.draws, ( uint64_t ) kDraws );
+    EXPECT_EQ( sorted.stateChanges, ( uint64_t ) kStates );
+    EXPECT_EQ( sorted.pipelineChanges, 2u );
+    EXPECT_GT( unsorted.stateChanges, sorted.stateChanges );
+
+    // The sort alone, against the comparison sort it replaces.
+    std::vector< uint64_t > keys( kDraws ), tempKeys( kDraws );
+    std::vector< uint32_t > order( kDraws ), tempOrder( kDraws );
+    std::vector< std::pair< uint64_t, uint32_t > > pairs( kDraws );
+    for ( int i = 0; i < kDraws; i++ )
+    {
+        keys[i] = draws[i].sortKey;
+        order[i] = i;
+        pairs[i] = { keys[i], ( uint32_t ) i };
+    }
+    auto start = std::chrono::high_resolution_clock::now();
+    vhRadixSort64( keys.data(), order.data(), tempKeys.data(), tempOrder.data(), kDraws );
+    double radixMs = std::chrono::duration< double, std::milli >( std::chrono::high_resolution_clock::now() - start ).count();
+    start = std::chrono::high_resolution_clock::now();
+    std::stable_sort( pairs.begin(), pairs.end(), []( const auto& a, const auto& b ) { return a.first < b.first; } );
+    double stableMs = std::chrono::duration< double, std::milli >( std::chrono::high_resolution_clock::now() - start ).count();
+    printf( "    %d keys: radix sort %.3f ms, std::stable_sort %.3f ms\n", kDraws, radixMs, stableMs );
+
+    vhDestroyTexture( target );
+    vhDestroyShader( vs );
+    vhDestroyShader( ps );
+    vhFlush();
+    EXPECT_EQ( g_vhErrorCounter.load(), baseline );
 }
 
 UTEST_STATE();
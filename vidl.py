@@ -43,6 +43,18 @@ CPP_KEYWORDS = {
     'void', 'volatile', 'wchar_t', 'while', 'xor', 'xor_eq'
 }
 
+# Value types that own heap memory. Records holding any of these by value need their destructor run on release;
+# everything else is a trivially-destructible record that the command arena can simply rewind over.
+NON_TRIVIAL_TYPES = { 'vhProgram', 'vhVertexLayout', 'vhMem', 'vhState', 'vhState::ConstantBufferValue', 'vhState::UniformBufferValue' }
+
+def is_trivial_type(t):
+    t = t.replace('&', '').replace('const', '').strip()
+    if t.endswith('*'):
+        return True
+    if 'std::' in t:
+        return False
+    return t not in NON_TRIVIAL_TYPES
+
 def sanitize_name(name):
     if name in CPP_KEYWORDS:
         return name + "_"
@@ -120,6 +132,8 @@ def generate_source(content):
         # Generate struct
         struct_lines = [f"struct VIDL_{func['name']}", "{"]
         struct_lines.append(f"    static constexpr uint64_t kMagic = {magic};")
+        trivial = all(is_trivial_type(p['type']) for p in func['params'])
+        struct_lines.append(f"    static constexpr bool kTrivial = {'true' if trivial else 'false'};")
         struct_lines.append("    uint64_t MAGIC = kMagic;")
         
         ctor_params = []
@@ -148,12 +162,13 @@ def generate_source(content):
             struct_lines.append(f"        : {', '.join(initializer_list)} {{}}")
 
         struct_lines.append("};")
+        struct_lines.append(f"static_assert( !VIDL_{func['name']}::kTrivial || std::is_trivially_destructible_v< VIDL_{func['name']} >, \"VIDL_{func['name']} must stay trivially destructible.\" );")
         generated_structs.append("\n".join(struct_lines))
 
     # Generate Handler
     handler_lines = ["struct VIDLHandler", "{"]
     for h in handler_funcs:
-        handler_lines.append(f"    virtual void Handle_{h['name']}( VIDL_{h['name']}* cmd ) {{ (void) cmd; }};")
+        handler_lines.append(f"    virtual void Handle_{h['name']}( VIDL_{h['name']}* cmd ) {{ vhCmdRelease( cmd ); }};")
     
     handler_lines.append("")
     handler_lines.append("    virtual void HandleCmd( void* cmd )")
@@ -174,6 +189,10 @@ def generate_source(content):
     output = []
     output.append("// Generated by Vidl - DO NOT MODIFY : see vidl.py")
     output.append("#include <cstdint>")
+    output.append("#include <type_traits>")
+    output.append("")
+    output.append("// Command records are placement-constructed into the per-thread command arena; unhandled commands must still be released.")
+    output.append("template< typename T > void vhCmdRelease( T* cmd );")
     output.append("")
     output.append("\n\n".join(generated_structs))
     output.append("")
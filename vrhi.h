@@ -34,6 +34,9 @@
 #include <string>
 #include <vector>
 #include <functional>
+#include <utility>
+#include <iterator>
+#include <algorithm>
 #include <filesystem>
 #include <fstream>
 #include <glm/glm.hpp>
@@ -69,6 +72,10 @@ struct vhInitData
     glm::ivec2 resolution = glm::ivec2( 1280, 720 );
     std::function<void( bool error, const std::string& )> fnLogCallback = nullptr;
     std::function<void() > fnThreadInitCallback = nullptr;
+    int commandBatchSize = 64; // Commands buffered per thread before publishing them to the backend. 1 disables batching.
+    int backendSpinMicroseconds = 50; // Upper bound the RHI thread spins on an empty queue before blocking. 0 always blocks.
+    std::string pipelineCachePath = ""; // On-disk Vulkan pipeline cache, loaded in vhInit() and saved in vhShutdown(). Empty disables it.
+    bool transferQueueUploads = true; // Record texture / buffer uploads on the transfer queue through a persistent staging ring.
 
 #ifdef VRHI_SHADER_COMPILER
     std::string shaderCompileTempDir = "./tmp/shader_cache/";
@@ -82,8 +89,111 @@ typedef uint32_t vhTexture;
 typedef uint32_t vhBuffer;
 typedef uint32_t vhShader;
 typedef uint32_t vhUniform;
-typedef std::vector< uint8_t > vhMem;
+
+// Memory handed to and from the vh* API.
+//
+// Usually owns its bytes, like a std::vector. It can instead reference memory owned by someone else, see
+// vhAllocMemView() and vhMapFileMem(): uploads then read straight from that memory and the release callback runs once
+// the backend is done with it. Referenced memory is read-only, so anything that could write to it first copies it
+// into owned bytes and lets the reference go. Const access never copies.
+class vhMem
+{
+public:
+    typedef std::function< void( const uint8_t* data, size_t size ) > ReleaseFn;
+    typedef uint8_t value_type;
+    typedef size_t size_type;
+    typedef uint8_t& reference;
+    typedef const uint8_t& const_reference;
+    typedef uint8_t* iterator;
+    typedef const uint8_t* const_iterator;
+
+    vhMem() = default;
+    explicit vhMem( size_t size, uint8_t value = 0 ) : m_bytes( size, value ) {}
+    vhMem( std::initializer_list< uint8_t > bytes ) : m_bytes( bytes ) {}
+    template< std::input_iterator It > vhMem( It first, It last ) : m_bytes( first, last ) {}
+    vhMem( const std::vector< uint8_t >& bytes ) : m_bytes( bytes ) {}
+    vhMem( std::vector< uint8_t >&& bytes ) : m_bytes( std::move( bytes ) ) {}
+    vhMem( const uint8_t* external, size_t size, ReleaseFn release ) : m_external( external ), m_externalSize( size ), m_release( std::move( release ) ) {}
+    ~vhMem() { releaseExternal(); }
+
+    // Copies always own their bytes; moves carry the reference along.
+    vhMem( const vhMem& other ) : m_bytes( other.begin(), other.end() ) {}
+    vhMem( vhMem&& other ) noexcept : m_bytes( std::move( other.m_bytes ) ) { takeExternal( other ); }
+    vhMem& operator=( const vhMem& other )
+    {
+        if ( this == &other ) return *this;
+        std::vector< uint8_t > bytes( other.begin(), other.end() );
+        releaseExternal();
+        m_bytes = std::move( bytes );
+        return *this;
+    }
+    vhMem& operator=( vhMem&& other ) noexcept
+    {
+        if ( this == &other ) return *this;
+        releaseExternal();
+        m_bytes = std::move( other.m_bytes );
+        takeExternal( other );
+        return *this;
+    }
+
+    bool isExternal() const { return m_external != nullptr; }
+
+    const uint8_t* data() const { return m_external ? m_external : m_bytes.data(); }
+    size_t size() const { return m_external ? m_externalSize : m_bytes.size(); }
+    bool empty() const { return size() == 0; }
+    const uint8_t* begin() const { return data(); }
+    const uint8_t* end() const { return data() + size(); }
+    const uint8_t& operator[]( size_t index ) const { return data()[index]; }
+    operator std::vector< uint8_t >() const { return std::vector< uint8_t >( begin(), end() ); }
+    friend bool operator==( const vhMem& a, const vhMem& b ) { return std::equal( a.begin(), a.end(), b.begin(), b.end() ); }
+
+    uint8_t* data() { return owned().data(); }
+    uint8_t* begin() { return data(); }
+    uint8_t* end() { return data() + size(); }
+    uint8_t& operator[]( size_t index ) { return data()[index]; }
+    void resize( size_t size ) { owned().resize( size ); }
+    void resize( size_t size, uint8_t value ) { owned().resize( size, value ); }
+    void reserve( size_t size ) { owned().reserve( size ); }
+    void clear() { releaseExternal(); m_bytes.clear(); }
+    void push_back( uint8_t value ) { owned().push_back( value ); }
+
+private:
+    // The owned bytes, after copying out of referenced memory if there was any.
+    std::vector< uint8_t >& owned()
+    {
+        if ( m_external )
+        {
+            m_bytes.assign( m_external, m_external + m_externalSize );
+            releaseExternal();
+        }
+        return m_bytes;
+    }
+
+    void releaseExternal()
+    {
+        if ( m_external && m_release ) m_release( m_external, m_externalSize );
+        m_external = nullptr;
+        m_externalSize = 0;
+        m_release = nullptr;
+    }
+
+    void takeExternal( vhMem& other )
+    {
+        m_external = std::exchange( other.m_external, nullptr );
+        m_externalSize = std::exchange( other.m_externalSize, 0 );
+        m_release = std::exchange( other.m_release, nullptr );
+    }
+
+    std::vector< uint8_t > m_bytes;
+    const uint8_t* m_external = nullptr;
+    size_t m_externalSize = 0;
+    ReleaseFn m_release;
+};
+
 typedef std::vector< vhShader > vhProgram;
+typedef uint64_t vhFlushTicket;
+typedef uint64_t vhReadbackTicket;
+typedef uint64_t vhQueueToken;
 
 extern vhInitData g_vhInit;
 extern nvrhi::DeviceHandle g_vhDevice;
@@ -111,6 +221,11 @@ void vhShutdown( bool quiet = false );
 // Returns a string containing information about the selected physical device and queues.
 std::string vhGetDeviceInfo();
 
+// Writes the Vulkan pipeline cache to |g_vhInit.pipelineCachePath|. This also happens automatically in vhShutdown().
+//
+// Returns false if the pipeline cache is disabled or could not be written.
+bool vhSavePipelineCache();
+
 // Blocks until all commands currently in the queue have been processed by the backend.
 //
 // This does not wait for the GPU to finish execution.
@@ -119,6 +234,33 @@ void vhFlush();
 // Blocks until all commands have been processed and the GPU has reached an idle state.
 void vhFinish();
 
+// Enqueues a flush without blocking and returns a ticket for it.
+//
+// The ticket completes once the backend has processed every command issued by the calling thread before it
+// (and, if |waitForGPU| is set, once the GPU is idle). Wait on it with vhWaitFlush().
+vhFlushTicket vhFlushAsync( bool waitForGPU = false );
+
+// Blocks until |ticket| has completed. Returns immediately if it already has.
+void vhWaitFlush( vhFlushTicket ticket );
+
+// Returns true if |ticket| has completed.
+bool vhIsFlushComplete( vhFlushTicket ticket );
+
+// Returns true once the readback behind |ticket| has landed in its output vhMem. Never blocks.
+//
+// Readbacks are retired by the backend as it processes commands; polling nudges it if it is idle.
+bool vhIsReadbackComplete( vhReadbackTicket ticket );
+
+// Blocks until the readback behind |ticket| has landed in its output vhMem. This waits for the GPU to reach that
+// readback only, not for the device to go idle. |ticket| must have been issued on the calling thread, or published.
+void vhWaitReadback( vhReadbackTicket ticket );
+
+// Publishes the commands buffered on the calling thread to the backend without waiting for them.
+//
+// Commands are also published automatically once |g_vhInit.commandBatchSize| are buffered, by vhFlush() and vhFinish(),
+// and when the calling thread exits.
+void vhPublishCommands();
+
 // Clears backend caches (e.g. framebuffers). Call this after a window resize.
 // VIDL_GENERATE
 void vhResizeCleanup();
@@ -139,6 +281,44 @@ inline vhMem* vhAllocMem( const std::vector< uint8_t >& data )
     return new vhMem( data );
 }
 
+// Wraps |size| bytes at |data| for upload without copying them.
+// |data| must stay valid and unchanged until the backend calls |release|, which happens once the upload has been recorded.
+inline vhMem* vhAllocMemView( const void* data, uint64_t size, vhMem::ReleaseFn release = nullptr )
+{
+    return new vhMem( ( const uint8_t* ) data, size, std::move( release ) );
+}
+
+// Maps |size| bytes of the file at |path| from |offset| read-only, so uploads copy straight from the page cache.
+// A |size| of 0 maps to the end of the file. The mapping is released once the backend is done with it.
+//
+// Returns nullptr if the file can't be opened or the range is outside of it.
+vhMem* vhMapFileMem( const std::filesystem::path& path, uint64_t offset = 0, uint64_t size = 0 );
+
+// Upload memory handed out by vhMapTextureUpload() and vhMapBufferUpload(). It lives in persistently mapped,
+// GPU-visible staging memory, so data written to |data| is copied to the GPU as is, with no further CPU copies.
+//
+// Write exactly |size| bytes to |data|, then hand the mapping to vhCommitUpload(). Texture data uses the
+// vhGetTextureInfo() layout: rows of |rowPitch| bytes, depth slices of |slicePitch| bytes.
+// The remaining members say where the data goes and where it lives; treat them as opaque.
+struct vhUploadMapping
+{
+    uint8_t* data = nullptr;
+    uint64_t size = 0;
+    uint32_t rowPitch = 0;
+    uint64_t slicePitch = 0;
+
+    vhTexture texture = VRHI_INVALID_HANDLE;
+    vhBuffer buffer = VRHI_INVALID_HANDLE;
+    int32_t mip = 0, layer = 0;
+    uint64_t offset = 0;
+    uint32_t chunk = 0;
+    uint64_t chunkOffset = 0;
+};
+
+// Enqueues the copy of a mapping filled in by the caller. Every mapping must be committed exactly once, even if it
+// ended up unused; its staging memory is only recycled after that. |mapping.data| must not be touched afterwards.
+void vhCommitUpload( const vhUploadMapping& mapping );
+
 // ------------ Texture ------------
 
 struct vhTextureMipInfo
@@ -160,7 +340,8 @@ struct vhTexInfo
     int32_t samples = 0;
 };
 
-// Allocates a unique texture handle.
+// Allocates a unique texture handle. Thread-safe and lock-free.
+// Handles carry a generation count, so a handle kept after vhDestroyTexture() never aliases a later texture.
 //
 // Returns a valid |vhTexture| handle, or |VRHI_INVALID_HANDLE| on failure.
 vhTexture vhAllocTexture();
@@ -168,7 +349,7 @@ vhTexture vhAllocTexture();
 // VIDL_GENERATE
 void vhResetTexture( vhTexture texture );
 
-// Allocates a unique buffer handle.
+// Allocates a unique buffer handle. Thread-safe and lock-free, with the same generation tagging as vhAllocTexture().
 //
 // Returns a valid |vhBuffer| handle, or |VRHI_INVALID_HANDLE| on failure.
 vhBuffer vhAllocBuffer();
@@ -283,19 +464,44 @@ void vhUpdateTexture(
     const vhMem* data = nullptr
 );
 
-// Enqueues a command to read a subresource range of a texture.
-// WARNING: This is a slow path operation, generally for debugging or screenshot purposes.
+// Reads a single subresource of a texture, blocking until the data has landed in |outData|.
+// WARNING: This is a slow path operation, generally for debugging or screenshot purposes. See vhReadTextureAsync().
 //
 // |texture| is the handle to the texture to read.
-// |mip| and |layer| define the subresource to read.
+// |mip| and |layer| define the subresource to read. 3D textures are read with all of their depth slices.
 // |outData| is the destination for the pixel data. DOES NOT take ownership of the memory.
-// VIDL_GENERATE
 void vhReadTextureSlow(
     vhTexture texture,
     int mip = 0, int layer = 0,
     vhMem* outData = nullptr
 );
 
+// Enqueues an asynchronous read of a subresource range of a texture and returns a ticket for it.
+//
+// The whole range is copied in one submission, recorded on the regular command stream into a pooled readback buffer and
+// submitted right away; the device is never drained. Poll the ticket with vhIsReadbackComplete() or block on it with
+// vhWaitReadback().
+// |texture| is the handle to the texture to read.
+// |startMips| and |startLayers| define the beginning of the range.
+// |numMips| and |numLayers| define the size of the range. 0 reads to the end of the mip chain / array.
+// |outData| receives the pixel data once the ticket completes, in the same layout vhUpdateTexture() takes: layer by
+// layer, each holding its mips as described by vhGetTextureInfo(). 3D mips include all of their depth slices.
+// DOES NOT take ownership of the memory, and it must stay alive until then. It can't reference external memory, see
+// vhAllocMemView(); such a read is rejected and returns 0, a ticket that is already complete.
+vhReadbackTicket vhReadTextureAsync(
+    vhTexture texture,
+    int startMips = 0, int startLayers = 0,
+    int numMips = 1, int numLayers = 1,
+    vhMem* outData = nullptr
+);
+
+// Returns upload memory for a single subresource of a texture, to be filled in and passed to vhCommitUpload().
+// This lets a decoder write its output straight into staging memory. Safe to call from any thread.
+//
+// |mip| and |layer| select the subresource. 3D textures take all of their depth slices at once.
+// Returns a mapping with a null |data| if the texture or subresource doesn't exist.
+vhUploadMapping vhMapTextureUpload( vhTexture texture, int mip = 0, int layer = 0 );
+
 // Enqueues a command to blit (copy/resize/convert) a region from one texture to another.
 //
 // |dst| and |src| are the destination and source texture handles.
@@ -482,18 +688,46 @@ void vhBlitBuffer(
     uint64_t size = 0
 );
 
+// Enqueues a command to make room for |capacity| bytes in a buffer created with VRHI_BUFFER_ALLOW_RESIZE.
+//
+// The logical size, as seen by vhGetBufferInfo() and the update / read range checks, is unchanged. Updates then grow
+// the buffer up to |capacity| in place, without reallocating or copying. Without a reservation the capacity grows
+// geometrically as the buffer does. Never shrinks the allocation.
+// VIDL_GENERATE
+void vhReserveBuffer( vhBuffer buffer, uint64_t capacity );
+
 // Enqueues a command to destroy the buffer associated with |buffer|.
 //
 // |buffer| is the handle to the buffer to be destroyed.
 // VIDL_GENERATE
 void vhDestroyBuffer( vhBuffer buffer );
 
+// Returns |size| bytes of upload memory for the range of |buffer| starting at |offset|, to be filled in and passed to
+// vhCommitUpload(). See vhMapTextureUpload(). The range is validated when the upload is committed, as with
+// vhUpdateStorageBuffer(); buffers created with VRHI_BUFFER_ALLOW_RESIZE grow to fit it.
+//
+// Returns a mapping with a null |data| if |size| is 0 or no staging memory could be allocated.
+vhUploadMapping vhMapBufferUpload( vhBuffer buffer, uint64_t offset, uint64_t size );
+
+// Enqueues an asynchronous read of a buffer range and returns a ticket for it. See vhReadTextureAsync().
+//
+// |offset| and |size| are in bytes. A |size| of 0 reads to the end of the buffer.
+// |outData| receives the data once the ticket completes. DOES NOT take ownership of the memory. As with
+// vhReadTextureAsync(), it can't reference external memory.
+vhReadbackTicket vhReadBufferAsync(
+    vhBuffer buffer,
+    uint64_t offset = 0,
+    uint64_t size = 0,
+    vhMem* outData = nullptr
+);
+
 // Returns buffer size in bytes. 
 // Options: outStride (structure stride), outFlags (usage flags).
 uint64_t vhGetBufferInfo( vhBuffer buffer, uint32_t* outStride = nullptr, uint64_t* outFlags = nullptr );
 
 // Returns the raw NVRHI handle (nvrhi::IBuffer*).
-void* vhGetBufferNvrhiHandle( vhBuffer buffer );
+// VRHI_BUFFER_POOLED buffers return their shared backing buffer; |outOffset| receives where the buffer starts in it.
+void* vhGetBufferNvrhiHandle( vhBuffer buffer, uint64_t* outOffset = nullptr );
 
 // ------------ Shaders ------------
 
@@ -633,6 +867,15 @@ struct vhState
     uint64_t stateFlags = 0;
     uint64_t debugFlags = 0;
     uint64_t dirty = 0;
+
+    // Per-slot dirty bits for the tables below, set by SetTexture(), SetSampler(), SetBuffer(), SetConstant() and
+    // SetUniform(), so vhSetState() only sends the entries that changed. UINT64_MAX sends the whole table.
+    // Slot updates assume the backend already holds the rest of the table, i.e. the same vhState was set before.
+    uint64_t dirtyTextureSlots = 0;
+    uint64_t dirtySamplerSlots = 0;
+    uint64_t dirtyBufferSlots = 0;
+    uint64_t dirtyConstantSlots = 0;
+    uint64_t dirtyUniformSlots = 0;
     
     uint16_t clearFlags = 0;
     uint32_t clearRgba = 0;
@@ -646,7 +889,7 @@ struct vhState
 
     struct VertexBinding
     {
-        vhBuffer buffer;
+        vhBuffer buffer = VRHI_INVALID_HANDLE;
         uint8_t stream = 0;
         uint32_t startVertex = 0;
         uint32_t numVertices = UINT32_MAX;
@@ -656,7 +899,7 @@ struct vhState
 
     struct IndexBinding
     {
-        vhBuffer buffer;
+        vhBuffer buffer = VRHI_INVALID_HANDLE;
         uint32_t firstIndex = 0;
         uint32_t numIndices = UINT32_MAX;
         uint64_t byteOffset = 0;
@@ -694,6 +937,7 @@ struct vhState
     };
     std::vector< SamplerDefinition > samplers;
 
+    // Constants and uniforms fill the shader constant buffer with the same name, padded with zeroes.
     // WARNING: These are global values. You cannot write them mid-frame, behaviour is undefined.
     struct ConstantBufferValue
     {
@@ -776,6 +1020,7 @@ struct vhState
     {
         textures = textures_;
         dirty |= VRHI_DIRTY_TEXTURE_SAMPLERS;
+        dirtyTextureSlots = UINT64_MAX;
         return *this;
     }
     vhState& SetTexture( uint32_t idx, const TextureBinding& texture )
@@ -783,6 +1028,7 @@ struct vhState
         if ( idx >= textures.size() ) textures.resize( idx + 1 );
         textures[idx] = texture;
         dirty |= VRHI_DIRTY_TEXTURE_SAMPLERS;
+        dirtyTextureSlots |= DirtySlot( idx );
         return *this;
     }
     TextureBinding& GetTexture( uint32_t idx )
@@ -794,6 +1040,7 @@ struct vhState
     {
         samplers = samplers_;
         dirty |= VRHI_DIRTY_TEXTURE_SAMPLERS;
+        dirtySamplerSlots = UINT64_MAX;
         return *this;
     }
     vhState& SetSampler( uint32_t idx, const SamplerDefinition& sampler )
@@ -801,6 +1048,7 @@ struct vhState
         if ( idx >= samplers.size() ) samplers.resize( idx + 1 );
         samplers[idx] = sampler;
         dirty |= VRHI_DIRTY_TEXTURE_SAMPLERS;
+        dirtySamplerSlots |= DirtySlot( idx );
         return *this;
     }
     SamplerDefinition& GetSampler( uint32_t idx )
@@ -812,6 +1060,7 @@ struct vhState
     {
         buffers = buffers_;
         dirty |= VRHI_DIRTY_BUFFERS;
+        dirtyBufferSlots = UINT64_MAX;
         return *this;
     }
     vhState& SetBuffer( uint32_t idx, const BufferBinding& buffer )
@@ -819,6 +1068,7 @@ struct vhState
         if ( idx >= buffers.size() ) buffers.resize( idx + 1 );
         buffers[idx] = buffer;
         dirty |= VRHI_DIRTY_BUFFERS;
+        dirtyBufferSlots |= DirtySlot( idx );
         return *this;
     }
     BufferBinding& GetBuffer( uint32_t idx )
@@ -830,6 +1080,7 @@ struct vhState
     {
         constants = constants_;
         dirty |= VRHI_DIRTY_CONSTANTS;
+        dirtyConstantSlots = UINT64_MAX;
         return *this;
     }
     vhState& SetConstant( uint32_t idx, const ConstantBufferValue& constant )
@@ -837,6 +1088,7 @@ struct vhState
         if ( idx >= constants.size() ) constants.resize( idx + 1 );
         constants[idx] = constant;
         dirty |= VRHI_DIRTY_CONSTANTS;
+        dirtyConstantSlots |= DirtySlot( idx );
         return *this;
     }
     ConstantBufferValue& GetConstant( uint32_t idx )
@@ -854,6 +1106,7 @@ struct vhState
     {
         uniforms = uniforms_;
         dirty |= VRHI_DIRTY_UNIFORMS;
+        dirtyUniformSlots = UINT64_MAX;
         return *this;
     }
     vhState& SetUniform( uint32_t idx, const UniformBufferValue& uniform )
@@ -861,6 +1114,7 @@ struct vhState
         if ( idx >= uniforms.size() ) uniforms.resize( idx + 1 );
         uniforms[idx] = uniform;
         dirty |= VRHI_DIRTY_UNIFORMS;
+        dirtyUniformSlots |= DirtySlot( idx );
         return *this;
     }
     UniformBufferValue& GetUniform( uint32_t idx )
@@ -900,8 +1154,10 @@ struct vhState
     vhState& DirtyAll()
     {
         dirty = VRHI_DIRTY_ALL;
+        dirtyTextureSlots = dirtySamplerSlots = dirtyBufferSlots = dirtyConstantSlots = dirtyUniformSlots = UINT64_MAX;
         return *this;
     }
+    static uint64_t DirtySlot( uint32_t idx ) { return idx < 64 ? 1ull << idx : UINT64_MAX; }
 };
 
 // Some global states created for you to use.
@@ -916,15 +1172,125 @@ bool vhGetState( vhStateId id, vhState& outState );
 // This automatically uploads via dirty flags, making it efficient to call multiple times.
 bool vhSetState( vhStateId id, vhState& state, uint64_t dirtyForceMask = 0 );
 
-// ------------ Submits ------------
-
+// Compiles |state| once into an immutable state object under |id|, for fixed configurations used over and over.
+// Binding names are resolved to slots, and the render state and pipelines are built up front, so submits referencing
+// |id| skip all of that. vhSetState() on a state block id is an error. After vhDestroyStateBlock() the id holds a
+// regular mutable state again.
 // VIDL_GENERATE
-void vhDispatch( vhStateId stateID, glm::uvec3 workGroupCount );
+void vhCreateStateBlock( vhStateId id, const vhState& state );
 
 // VIDL_GENERATE
-void vhDispatchIndirect( vhStateId stateID, vhBuffer indirectBuffer, uint64_t byteOffset  = 0);
+void vhDestroyStateBlock( vhStateId id );
+
+// ------------ Submits ------------
+
+// Dispatches run on the graphics queue, or on the compute queue when the state has VRHI_STATE_ASYNC_COMPUTE set and
+// the device has a compute queue in the graphics queue family. Async dispatches overlap graphics work that doesn't
+// share resources with them. Work on one queue that uses a resource waits for earlier work on the other queue that
+// used it, so draws, blits, uploads and readbacks of an async dispatch's results are ordered after it.
+//
+// Each dispatch also returns a token for its GPU work, and vhQueueSignal() returns one for everything enqueued on a
+// queue so far. vhQueueWait() makes a queue wait for a token regardless of resources, e.g. to keep a whole frame
+// behind a compute pass.
+//
+// Uploads on the copy queue are the exception: the backend issues those itself and orders them before any later
+// work on the compute and graphics queues, and after earlier work on the resource they write.
+
+vhQueueToken vhDispatch( vhStateId stateID, glm::uvec3 workGroupCount );
+
+vhQueueToken vhDispatchIndirect( vhStateId stateID, vhBuffer indirectBuffer, uint64_t byteOffset  = 0);
+
+struct vhDispatchDesc
+{
+    vhStateId stateID = VRHI_INVALID_HANDLE;
+    glm::uvec3 workGroupCount = glm::uvec3( 1 );
+};
+
+// Dispatches |count| entries of |descs| as a single command, for systems issuing many small dispatches.
+//
+// Entries do NOT run in the order given: they are stably sorted by queue, then pipeline, then state ID, so consecutive
+// dispatches share binds. Only entries with the same queue, pipeline and state keep their relative order, so entries
+// that depend on each other belong in separate batches. Barriers are only placed between entries writing the same
+// texture or buffer. The batch as a whole stays ordered with work before and after it.
+// Returns one token covering every dispatch in the batch, whichever queues they ran on.
+vhQueueToken vhDispatchBatch( const vhDispatchDesc* descs, size_t count );
+
+// Returns a token for all work enqueued on |queue| up to this call.
+vhQueueToken vhQueueSignal( nvrhi::CommandQueue queue );
+
+// Makes the next submission of |consumer| wait on the GPU until the work behind |token| has completed.
+// Tokens from the consumer queue itself, already completed tokens and 0 are no-ops.
+void vhQueueWait( nvrhi::CommandQueue consumer, vhQueueToken token );
+
+struct vhPipelineCacheStats
+{
+    uint64_t hits = 0;      // Submits that reused a cached pipeline.
+    uint64_t misses = 0;    // Submits that had to create a pipeline.
+    uint64_t pipelines = 0; // Pipelines currently cached.
 
-// TODO: vhSubmit
+    uint64_t bindingSetHits = 0;    // Submits that reused a cached binding set.
+    uint64_t bindingSetMisses = 0;  // Submits that had to create a binding set.
+    uint64_t bindingSets = 0;       // Binding sets currently cached.
+};
+
+// Returns the backend PSO and binding set cache counters. Pipelines are evicted when any shader they were built from is destroyed.
+// Binding sets are evicted when a texture or buffer they reference is destroyed or resized, or when their shader is destroyed.
+vhPipelineCacheStats vhGetPipelineCacheStats();
+
+// ------------ Draws ------------
+
+// Draws are recorded into encoders, one per thread, and go to the GPU as a frame. vhFrame() closes the frame: the
+// backend sorts all of its draws by |sortKey| and records them in that order, so keys that put the view first and
+// the pipeline and material next keep pipeline and binding changes to a minimum. Draws with equal keys keep their
+// submission order within an encoder.
+//
+// Draws render with the state that |stateID| holds when the backend records the frame, not when they were submitted.
+// States with clearFlags clear their attachments before any draw of the frame, in the order the states were first
+// submitted, so a clear never wipes draws sorted before it. The state must have colour or depth attachments.
+// Vertex buffers are bound per stream, the vertex shader sees their attributes in stream then layout order. Draws
+// with an index buffer set are indexed draws.
+struct vhDraw
+{
+    uint64_t sortKey = 0;
+    vhStateId stateID = VRHI_INVALID_HANDLE;
+    uint32_t vertexCount = 0; // Index count for indexed draws.
+    uint32_t instanceCount = 1;
+    uint32_t startVertex = 0; // For indexed draws, the start index after the state's firstIndex.
+    uint32_t startInstance = 0;
+};
+
+// Packs a sort key, most significant first: |view| (8 bits), |pipeline| (20 bits, e.g. a hash of the program and
+// render state), |material| (20 bits) and |depth| (16 bits). Wider values are truncated.
+inline uint64_t vhMakeSortKey( uint32_t view, uint32_t pipeline, uint32_t material, uint32_t depth )
+{
+    return ( ( uint64_t ) ( view & 0xFF ) << 56 ) | ( ( uint64_t ) ( pipeline & 0xFFFFF ) << 36 ) | ( ( uint64_t ) ( material & 0xFFFFF ) << 16 ) | ( depth & 0xFFFF );
+}
+
+struct vhEncoder;
+
+// Returns an encoder for the calling thread to record draws into. Encoders must not be shared between threads.
+vhEncoder* vhBeginEncoder();
+
+void vhSubmit( vhEncoder* encoder, const vhDraw& draw );
+
+// Hands the draws of |encoder| to the current frame and returns the encoder to the pool.
+void vhEndEncoder( vhEncoder* encoder );
+
+// Closes the current frame. Every encoder of the frame must have ended before this is called.
+void vhFrame();
+
+struct vhFrameStats
+{
+    uint64_t frame = 0;             // Index of the last recorded frame.
+    uint64_t draws = 0;             // Draws it recorded.
+    uint64_t pipelineChanges = 0;   // Times it bound a different pipeline.
+    uint64_t stateChanges = 0;      // Times it bound a different state.
+    double sortMs = 0.0;            // Backend time spent sorting its draws.
+    double recordMs = 0.0;          // Backend time spent recording them.
+};
+
+// Returns the counters of the last frame the backend recorded.
+vhFrameStats vhGetFrameStats();
 
 // --------------------------------------------------------------------------
 // Implementation
@@ -933,7 +1299,32 @@ void vhDispatchIndirect( vhStateId stateID, vhBuffer indirectBuffer, uint64_t by
 #ifdef VRHI_IMPLEMENTATION
 
 // VIDL_GENERATE
-void vhFlushInternal( std::atomic<bool>* fence, bool waitForGPU = false );
+void vhFlushInternal( vhFlushTicket ticket, bool waitForGPU = false );
+
+// VIDL_GENERATE
+void vhDispatchInternal( vhQueueToken token, vhStateId stateID, glm::uvec3 workGroupCount );
+// VIDL_GENERATE
+void vhDispatchIndirectInternal( vhQueueToken token, vhStateId stateID, vhBuffer indirectBuffer, uint64_t byteOffset );
+// VIDL_GENERATE
+void vhDispatchBatchInternal( vhQueueToken token, uint32_t count ); // |count| vhDispatchDesc follow the record.
+// VIDL_GENERATE
+void vhQueueSignalInternal( vhQueueToken token, nvrhi::CommandQueue queue );
+// VIDL_GENERATE
+void vhQueueWaitInternal( nvrhi::CommandQueue consumer, vhQueueToken token );
+
+// VIDL_GENERATE
+void vhSubmitDrawsInternal( uint64_t frame, uint32_t count ); // |count| vhDraw follow the record.
+// VIDL_GENERATE
+void vhFrameInternal( uint64_t frame, uint32_t encoders );
+
+// VIDL_GENERATE
+void vhReadTextureAsyncInternal( vhReadbackTicket ticket, vhTexture texture, int startMips, int startLayers, int numMips, int numLayers, vhMem* outData );
+// VIDL_GENERATE
+void vhReadBufferAsyncInternal( vhReadbackTicket ticket, vhBuffer buffer, uint64_t offset, uint64_t size, vhMem* outData );
+// VIDL_GENERATE
+void vhRetireReadbacksInternal( vhReadbackTicket waitTicket );
+// VIDL_GENERATE
+void vhCommitUploadInternal( vhUploadMapping mapping );
 
 // VIDL_GENERATE
 void vhCmdSetStateViewRect( vhStateId id, glm::vec4 rect );
@@ -970,6 +1361,18 @@ void vhCmdSetStatePushConstants( vhStateId id, glm::vec4 data );
 // VIDL_GENERATE
 void vhCmdSetStateUniforms( vhStateId id, const std::vector< vhState::UniformBufferValue >& uniforms );
 // VIDL_GENERATE
+void vhCmdSetStateTexture( vhStateId id, uint32_t idx, uint32_t count, vhState::TextureBinding texture );
+// VIDL_GENERATE
+void vhCmdSetStateSampler( vhStateId id, uint32_t idx, uint32_t count, vhState::SamplerDefinition sampler );
+// VIDL_GENERATE
+void vhCmdSetStateBuffer( vhStateId id, uint32_t idx, uint32_t count, vhState::BufferBinding buffer );
+// VIDL_GENERATE
+void vhCmdSetStateConstant( vhStateId id, uint32_t idx, uint32_t count, const vhState::ConstantBufferValue& constant );
+// VIDL_GENERATE
+void vhCmdSetStateUniform( vhStateId id, uint32_t idx, uint32_t count, const vhState::UniformBufferValue& uniform );
+// VIDL_GENERATE
+void vhCmdSetStateBlock( vhStateId id, uint64_t dirty, uint64_t size ); // |size| bytes of packed state follow the record.
+// VIDL_GENERATE
 void vhCmdSetStateAttachments( vhStateId id, const std::vector< vhState::RenderTarget >& colours, vhState::RenderTarget depth );
 
 // In header-only mode, we want definitions.
@@ -49,6 +49,7 @@
 #define VRHI_BUFFER_DRAW_INDIRECT                 UINT16_C(0x0400) //!< Buffer will be used for storing draw indirect commands.
 #define VRHI_BUFFER_ALLOW_RESIZE                  UINT16_C(0x0800) //!< Allow dynamic index/vertex buffer resize during update.
 #define VRHI_BUFFER_INDEX32                       UINT16_C(0x1000) //!< Index buffer contains 32-bit indices.
+#define VRHI_BUFFER_POOLED                        UINT16_C(0x2000) //!< Sub-allocate from a shared backing buffer. Ignored for compute write, indirect and resizable buffers.
 #define VRHI_BUFFER_COMPUTE_READ_WRITE (0 \
 	| VRHI_BUFFER_COMPUTE_READ \
 	| VRHI_BUFFER_COMPUTE_WRITE \
@@ -285,6 +286,7 @@
 #define VRHI_STATE_MSAA                           UINT64_C(0x0100000000000000) //!< Enable MSAA rasterization.
 #define VRHI_STATE_LINEAA                         UINT64_C(0x0200000000000000) //!< Enable line AA rasterization.
 #define VRHI_STATE_CONSERVATIVE_RASTER            UINT64_C(0x0400000000000000) //!< Enable conservative rasterization.
+#define VRHI_STATE_ASYNC_COMPUTE                  UINT64_C(0x0800000000000000) //!< Dispatch on the async compute queue, see vhDispatch().
 #define VRHI_STATE_NONE                           UINT64_C(0x0000000000000000) //!< No state.
 #define VRHI_STATE_FRONT_CCW                      UINT64_C(0x0000008000000000) //!< Front counter-clockwise ( default is clockwise ).
 #define VRHI_STATE_BLEND_INDEPENDENT              UINT64_C(0x0000000400000000) //!< Enable blend independent.
@@ -1,17 +1,24 @@
 // Generated by Vidl - DO NOT MODIFY : see vidl.py
 #include <cstdint>
+#include <type_traits>
+
+// Command records are placement-constructed into the per-thread command arena; unhandled commands must still be released.
+template< typename T > void vhCmdRelease( T* cmd );
 
 struct VIDL_vhResizeCleanup
 {
     static constexpr uint64_t kMagic = 0xF3F4A7CF;
+    static constexpr bool kTrivial = true;
     uint64_t MAGIC = kMagic;
 
     VIDL_vhResizeCleanup() = default;
 };
+static_assert( !VIDL_vhResizeCleanup::kTrivial || std::is_trivially_destructible_v< VIDL_vhResizeCleanup >, "VIDL_vhResizeCleanup must stay trivially destructible." );
 
 struct VIDL_vhResetTexture
 {
     static constexpr uint64_t kMagic = 0xE74D1798;
+    static constexpr bool kTrivial = true;
     uint64_t MAGIC = kMagic;
     vhTexture texture;
 
@@ -20,10 +27,12 @@ struct VIDL_vhResetTexture
     VIDL_vhResetTexture(vhTexture _texture)
         : texture(_texture) {}
 };
+static_assert( !VIDL_vhResetTexture::kTrivial || std::is_trivially_destructible_v< VIDL_vhResetTexture >, "VIDL_vhResetTexture must stay trivially destructible." );
 
 struct VIDL_vhResetBuffer
 {
     static constexpr uint64_t kMagic = 0x19331E16;
+    static constexpr bool kTrivial = true;
     uint64_t MAGIC = kMagic;
     vhBuffer buffer;
 
@@ -32,10 +41,12 @@ struct VIDL_vhResetBuffer
     VIDL_vhResetBuffer(vhBuffer _buffer)
         : buffer(_buffer) {}
 };
+static_assert( !VIDL_vhResetBuffer::kTrivial || std::is_trivially_destructible_v< VIDL_vhResetBuffer >, "VIDL_vhResetBuffer must stay trivially destructible." );
 
 struct VIDL_vhDestroyTexture
 {
     static constexpr uint64_t kMagic = 0xC090699A;
+    static constexpr bool kTrivial = true;
     uint64_t MAGIC = kMagic;
     vhTexture texture;
 
@@ -44,10 +55,12 @@ struct VIDL_vhDestroyTexture
     VIDL_vhDestroyTexture(vhTexture _texture)
         : texture(_texture) {}
 };
+static_assert( !VIDL_vhDestroyTexture::kTrivial || std::is_trivially_destructible_v< VIDL_vhDestroyTexture >, "VIDL_vhDestroyTexture must stay trivially destructible." );
 
 struct VIDL_vhCreateTexture
 {
     static constexpr uint64_t kMagic = 0xB40533D3;
+    static constexpr bool kTrivial = true;
     uint64_t MAGIC = kMagic;
     vhTexture texture;
     nvrhi::TextureDimension target;
@@ -63,10 +76,12 @@ struct VIDL_vhCreateTexture
     VIDL_vhCreateTexture(vhTexture _texture, nvrhi::TextureDimension _target, glm::ivec3 _dimensions, int _numMips, int _numLayers, nvrhi::Format _format, uint64_t _flag, const vhMem* _data)
         : texture(_texture), target(_target), dimensions(_dimensions), numMips(_numMips), numLayers(_numLayers), format(_format), flag(_flag), data(_data) {}
 };
+static_assert( !VIDL_vhCreateTexture::kTrivial || std::is_trivially_destructible_v< VIDL_vhCreateTexture >, "VIDL_vhCreateTexture must stay trivially destructible." );
 
 struct VIDL_vhUpdateTexture
 {
     static constexpr uint64_t kMagic = 0x79B006BB;
+    static constexpr bool kTrivial = true;
     uint64_t MAGIC = kMagic;
     vhTexture texture;
     int startMips = 0;
@@ -80,25 +95,12 @@ struct VIDL_vhUpdateTexture
     VIDL_vhUpdateTexture(vhTexture _texture, int _startMips, int _startLayers, int _numMips, int _numLayers, const vhMem* _data)
         : texture(_texture), startMips(_startMips), startLayers(_startLayers), numMips(_numMips), numLayers(_numLayers), data(_data) {}
 };
-
-struct VIDL_vhReadTextureSlow
-{
-    static constexpr uint64_t kMagic = 0x3BDDAB67;
-    uint64_t MAGIC = kMagic;
-    vhTexture texture;
-    int mip = 0;
-    int layer = 0;
-    vhMem* outData = nullptr;
-
-    VIDL_vhReadTextureSlow() = default;
-
-    VIDL_vhReadTextureSlow(vhTexture _texture, int _mip, int _layer, vhMem* _outData)
-        : texture(_texture), mip(_mip), layer(_layer), outData(_outData) {}
-};
+static_assert( !VIDL_vhUpdateTexture::kTrivial || std::is_trivially_destructible_v< VIDL_vhUpdateTexture >, "VIDL_vhUpdateTexture must stay trivially destructible." );
 
 struct VIDL_vhBlitTexture
 {
     static constexpr uint64_t kMagic = 0xD7782E0F;
+    static constexpr bool kTrivial = true;
     uint64_t MAGIC = kMagic;
     vhTexture dst;
     vhTexture src;
@@ -115,10 +117,12 @@ struct VIDL_vhBlitTexture
     VIDL_vhBlitTexture(vhTexture _dst, vhTexture _src, int _dstMip, int _srcMip, int _dstLayer, int _srcLayer, glm::ivec3 _dstOffset, glm::ivec3 _srcOffset, glm::ivec3 _extent)
         : dst(_dst), src(_src), dstMip(_dstMip), srcMip(_srcMip), dstLayer(_dstLayer), srcLayer(_srcLayer), dstOffset(_dstOffset), srcOffset(_srcOffset), extent(_extent) {}
 };
+static_assert( !VIDL_vhBlitTexture::kTrivial || std::is_trivially_destructible_v< VIDL_vhBlitTexture >, "VIDL_vhBlitTexture must stay trivially destructible." );
 
 struct VIDL_vhCreateVertexBuffer
 {
     static constexpr uint64_t kMagic = 0xBBF8D184;
+    static constexpr bool kTrivial = false;
     uint64_t MAGIC = kMagic;
     vhBuffer buffer;
     const char* name;
@@ -132,10 +136,12 @@ struct VIDL_vhCreateVertexBuffer
     VIDL_vhCreateVertexBuffer(vhBuffer _buffer, const char* _name, const vhMem* _data, const vhVertexLayout _layout, uint64_t _numVerts, uint16_t _flags)
         : buffer(_buffer), name(_name), data(_data), layout(_layout), numVerts(_numVerts), flags(_flags) {}
 };
+static_assert( !VIDL_vhCreateVertexBuffer::kTrivial || std::is_trivially_destructible_v< VIDL_vhCreateVertexBuffer >, "VIDL_vhCreateVertexBuffer must stay trivially destructible." );
 
 struct VIDL_vhUpdateVertexBuffer
 {
     static constexpr uint64_t kMagic = 0x57AF47B4;
+    static constexpr bool kTrivial = true;
     uint64_t MAGIC = kMagic;
     vhBuffer buffer;
     const vhMem* data;
@@ -147,10 +153,12 @@ struct VIDL_vhUpdateVertexBuffer
     VIDL_vhUpdateVertexBuffer(vhBuffer _buffer, const vhMem* _data, uint64_t _offsetVerts, uint64_t _numVerts)
         : buffer(_buffer), data(_data), offsetVerts(_offsetVerts), numVerts(_numVerts) {}
 };
+static_assert( !VIDL_vhUpdateVertexBuffer::kTrivial || std::is_trivially_destructible_v< VIDL_vhUpdateVertexBuffer >, "VIDL_vhUpdateVertexBuffer must stay trivially destructible." );
 
 struct VIDL_vhCreateIndexBuffer
 {
     static constexpr uint64_t kMagic = 0x22AE59E6;
+    static constexpr bool kTrivial = true;
     uint64_t MAGIC = kMagic;
     vhBuffer buffer;
     const char* name;
@@ -163,10 +171,12 @@ struct VIDL_vhCreateIndexBuffer
     VIDL_vhCreateIndexBuffer(vhBuffer _buffer, const char* _name, const vhMem* _data, uint64_t _numIndices, uint16_t _flags)
         : buffer(_buffer), name(_name), data(_data), numIndices(_numIndices), flags(_flags) {}
 };
+static_assert( !VIDL_vhCreateIndexBuffer::kTrivial || std::is_trivially_destructible_v< VIDL_vhCreateIndexBuffer >, "VIDL_vhCreateIndexBuffer must stay trivially destructible." );
 
 struct VIDL_vhUpdateIndexBuffer
 {
     static constexpr uint64_t kMagic = 0x6B219F18;
+    static constexpr bool kTrivial = true;
     uint64_t MAGIC = kMagic;
     vhBuffer buffer;
     const vhMem* data;
@@ -178,10 +188,12 @@ struct VIDL_vhUpdateIndexBuffer
     VIDL_vhUpdateIndexBuffer(vhBuffer _buffer, const vhMem* _data, uint64_t _offsetIndices, uint64_t _numIndices)
         : buffer(_buffer), data(_data), offsetIndices(_offsetIndices), numIndices(_numIndices) {}
 };
+static_assert( !VIDL_vhUpdateIndexBuffer::kTrivial || std::is_trivially_destructible_v< VIDL_vhUpdateIndexBuffer >, "VIDL_vhUpdateIndexBuffer must stay trivially destructible." );
 
 struct VIDL_vhCreateUniformBuffer
 {
     static constexpr uint64_t kMagic = 0x2EFADC4C;
+    static constexpr bool kTrivial = true;
     uint64_t MAGIC = kMagic;
     vhBuffer buffer;
     const char* name;
@@ -194,10 +206,12 @@ struct VIDL_vhCreateUniformBuffer
     VIDL_vhCreateUniformBuffer(vhBuffer _buffer, const char* _name, const vhMem* _data, uint64_t _size, uint16_t _flags)
         : buffer(_buffer), name(_name), data(_data), size(_size), flags(_flags) {}
 };
+static_assert( !VIDL_vhCreateUniformBuffer::kTrivial || std::is_trivially_destructible_v< VIDL_vhCreateUniformBuffer >, "VIDL_vhCreateUniformBuffer must stay trivially destructible." );
 
 struct VIDL_vhUpdateUniformBuffer
 {
     static constexpr uint64_t kMagic = 0xD6050AA7;
+    static constexpr bool kTrivial = true;
     uint64_t MAGIC = kMagic;
     vhBuffer buffer;
     const vhMem* data;
@@ -209,10 +223,12 @@ struct VIDL_vhUpdateUniformBuffer
     VIDL_vhUpdateUniformBuffer(vhBuffer _buffer, const vhMem* _data, uint64_t _offset, uint64_t _size)
         : buffer(_buffer), data(_data), offset(_offset), size(_size) {}
 };
+static_assert( !VIDL_vhUpdateUniformBuffer::kTrivial || std::is_trivially_destructible_v< VIDL_vhUpdateUniformBuffer >, "VIDL_vhUpdateUniformBuffer must stay trivially destructible." );
 
 struct VIDL_vhCreateStorageBuffer
 {
     static constexpr uint64_t kMagic = 0x797A3950;
+    static constexpr bool kTrivial = true;
     uint64_t MAGIC = kMagic;
     vhBuffer buffer;
     const char* name;
@@ -225,10 +241,12 @@ struct VIDL_vhCreateStorageBuffer
     VIDL_vhCreateStorageBuffer(vhBuffer _buffer, const char* _name, const vhMem* _data, uint64_t _size, uint16_t _flags)
         : buffer(_buffer), name(_name), data(_data), size(_size), flags(_flags) {}
 };
+static_assert( !VIDL_vhCreateStorageBuffer::kTrivial || std::is_trivially_destructible_v< VIDL_vhCreateStorageBuffer >, "VIDL_vhCreateStorageBuffer must stay trivially destructible." );
 
 struct VIDL_vhUpdateStorageBuffer
 {
     static constexpr uint64_t kMagic = 0x6153A4D9;
+    static constexpr bool kTrivial = true;
     uint64_t MAGIC = kMagic;
     vhBuffer buffer;
     const vhMem* data;
@@ -240,10 +258,12 @@ struct VIDL_vhUpdateStorageBuffer
     VIDL_vhUpdateStorageBuffer(vhBuffer _buffer, const vhMem* _data, uint64_t _offset, uint64_t _size)
         : buffer(_buffer), data(_data), offset(_offset), size(_size) {}
 };
+static_assert( !VIDL_vhUpdateStorageBuffer::kTrivial || std::is_trivially_destructible_v< VIDL_vhUpdateStorageBuffer >, "VIDL_vhUpdateStorageBuffer must stay trivially destructible." );
 
 struct VIDL_vhBlitBuffer
 {
     static constexpr uint64_t kMagic = 0x15BFFC71;
+    static constexpr bool kTrivial = true;
     uint64_t MAGIC = kMagic;
     vhBuffer dst;
     vhBuffer src;
@@ -256,10 +276,27 @@ struct VIDL_vhBlitBuffer
     VIDL_vhBlitBuffer(vhBuffer _dst, vhBuffer _src, uint64_t _dstOffset, uint64_t _srcOffset, uint64_t _size)
         : dst(_dst), src(_src), dstOffset(_dstOffset), srcOffset(_srcOffset), size(_size) {}
 };
+static_assert( !VIDL_vhBlitBuffer::kTrivial || std::is_trivially_destructible_v< VIDL_vhBlitBuffer >, "VIDL_vhBlitBuffer must stay trivially destructible." );
+
+struct VIDL_vhReserveBuffer
+{
+    static constexpr uint64_t kMagic = 0x7F7DEBD5;
+    static constexpr bool kTrivial = true;
+    uint64_t MAGIC = kMagic;
+    vhBuffer buffer;
+    uint64_t capacity;
+
+    VIDL_vhReserveBuffer() = default;
+
+    VIDL_vhReserveBuffer(vhBuffer _buffer, uint64_t _capacity)
+        : buffer(_buffer), capacity(_capacity) {}
+};
+static_assert( !VIDL_vhReserveBuffer::kTrivial || std::is_trivially_destructible_v< VIDL_vhReserveBuffer >, "VIDL_vhReserveBuffer must stay trivially destructible." );
 
 struct VIDL_vhDestroyBuffer
 {
     static constexpr uint64_t kMagic = 0x3A87A73E;
+    static constexpr bool kTrivial = true;
     uint64_t MAGIC = kMagic;
     vhBuffer buffer;
 
@@ -268,10 +305,12 @@ struct VIDL_vhDestroyBuffer
     VIDL_vhDestroyBuffer(vhBuffer _buffer)
         : buffer(_buffer) {}
 };
+static_assert( !VIDL_vhDestroyBuffer::kTrivial || std::is_trivially_destructible_v< VIDL_vhDestroyBuffer >, "VIDL_vhDestroyBuffer must stay trivially destructible." );
 
 struct VIDL_vhCreateShader
 {
     static constexpr uint64_t kMagic = 0x21DB7127;
+    static constexpr bool kTrivial = false;
     uint64_t MAGIC = kMagic;
     vhShader shader;
     const char* name;
@@ -284,10 +323,12 @@ struct VIDL_vhCreateShader
     VIDL_vhCreateShader(vhShader _shader, const char* _name, uint64_t _flags, const std::vector< uint32_t >& _spirv, const char* _entry)
         : shader(_shader), name(_name), flags(_flags), spirv(_spirv), entry(_entry) {}
 };
+static_assert( !VIDL_vhCreateShader::kTrivial || std::is_trivially_destructible_v< VIDL_vhCreateShader >, "VIDL_vhCreateShader must stay trivially destructible." );
 
 struct VIDL_vhDestroyShader
 {
     static constexpr uint64_t kMagic = 0x3328C9A7;
+    static constexpr bool kTrivial = true;
     uint64_t MAGIC = kMagic;
     vhShader shader;
 
@@ -296,50 +337,230 @@ struct VIDL_vhDestroyShader
     VIDL_vhDestroyShader(vhShader _shader)
         : shader(_shader) {}
 };
+static_assert( !VIDL_vhDestroyShader::kTrivial || std::is_trivially_destructible_v< VIDL_vhDestroyShader >, "VIDL_vhDestroyShader must stay trivially destructible." );
 
-struct VIDL_vhDispatch
+struct VIDL_vhCreateStateBlock
 {
-    static constexpr uint64_t kMagic = 0x8A8ABD80;
+    static constexpr uint64_t kMagic = 0xD4ADD975;
+    static constexpr bool kTrivial = false;
     uint64_t MAGIC = kMagic;
-    vhStateId stateID;
-    glm::uvec3 workGroupCount;
+    vhStateId id;
+    const vhState state;
 
-    VIDL_vhDispatch() = default;
+    VIDL_vhCreateStateBlock() = default;
 
-    VIDL_vhDispatch(vhStateId _stateID, glm::uvec3 _workGroupCount)
-        : stateID(_stateID), workGroupCount(_workGroupCount) {}
+    VIDL_vhCreateStateBlock(vhStateId _id, const vhState& _state)
+        : id(_id), state(_state) {}
 };
+static_assert( !VIDL_vhCreateStateBlock::kTrivial || std::is_trivially_destructible_v< VIDL_vhCreateStateBlock >, "VIDL_vhCreateStateBlock must stay trivially destructible." );
 
-struct VIDL_vhDispatchIndirect
+struct VIDL_vhDestroyStateBlock
 {
-    static constexpr uint64_t kMagic = 0x76CD9435;
+    static constexpr uint64_t kMagic = 0x19635457;
+    static constexpr bool kTrivial = true;
     uint64_t MAGIC = kMagic;
-    vhStateId stateID;
-    vhBuffer indirectBuffer;
-    uint64_t byteOffset = 0;
+    vhStateId id;
 
-    VIDL_vhDispatchIndirect() = default;
+    VIDL_vhDestroyStateBlock() = default;
 
-    VIDL_vhDispatchIndirect(vhStateId _stateID, vhBuffer _indirectBuffer, uint64_t _byteOffset)
-        : stateID(_stateID), indirectBuffer(_indirectBuffer), byteOffset(_byteOffset) {}
+    VIDL_vhDestroyStateBlock(vhStateId _id)
+        : id(_id) {}
 };
+static_assert( !VIDL_vhDestroyStateBlock::kTrivial || std::is_trivially_destructible_v< VIDL_vhDestroyStateBlock >, "VIDL_vhDestroyStateBlock must stay trivially destructible." );
 
 struct VIDL_vhFlushInternal
 {
     static constexpr uint64_t kMagic = 0x83140D26;
+    static constexpr bool kTrivial = true;
     uint64_t MAGIC = kMagic;
-    std::atomic<bool>* fence;
+    vhFlushTicket ticket;
     bool waitForGPU = false;
 
     VIDL_vhFlushInternal() = default;
 
-    VIDL_vhFlushInternal(std::atomic<bool>* _fence, bool _waitForGPU)
-        : fence(_fence), waitForGPU(_waitForGPU) {}
+    VIDL_vhFlushInternal(vhFlushTicket _ticket, bool _waitForGPU)
+        : ticket(_ticket), waitForGPU(_waitForGPU) {}
+};
+static_assert( !VIDL_vhFlushInternal::kTrivial || std::is_trivially_destructible_v< VIDL_vhFlushInternal >, "VIDL_vhFlushInternal must stay trivially destructible." );
+
+struct VIDL_vhDispatchInternal
+{
+    static constexpr uint64_t kMagic = 0xE69DCCA1;
+    static constexpr bool kTrivial = true;
+    uint64_t MAGIC = kMagic;
+    vhQueueToken token;
+    vhStateId stateID;
+    glm::uvec3 workGroupCount;
+
+    VIDL_vhDispatchInternal() = default;
+
+    VIDL_vhDispatchInternal(vhQueueToken _token, vhStateId _stateID, glm::uvec3 _workGroupCount)
+        : token(_token), stateID(_stateID), workGroupCount(_workGroupCount) {}
+};
+static_assert( !VIDL_vhDispatchInternal::kTrivial || std::is_trivially_destructible_v< VIDL_vhDispatchInternal >, "VIDL_vhDispatchInternal must stay trivially destructible." );
+
+struct VIDL_vhDispatchIndirectInternal
+{
+    static constexpr uint64_t kMagic = 0x55C31562;
+    static constexpr bool kTrivial = true;
+    uint64_t MAGIC = kMagic;
+    vhQueueToken token;
+    vhStateId stateID;
+    vhBuffer indirectBuffer;
+    uint64_t byteOffset;
+
+    VIDL_vhDispatchIndirectInternal() = default;
+
+    VIDL_vhDispatchIndirectInternal(vhQueueToken _token, vhStateId _stateID, vhBuffer _indirectBuffer, uint64_t _byteOffset)
+        : token(_token), stateID(_stateID), indirectBuffer(_indirectBuffer), byteOffset(_byteOffset) {}
 };
+static_assert( !VIDL_vhDispatchIndirectInternal::kTrivial || std::is_trivially_destructible_v< VIDL_vhDispatchIndirectInternal >, "VIDL_vhDispatchIndirectInternal must stay trivially destructible." );
+
+struct VIDL_vhDispatchBatchInternal
+{
+    static constexpr uint64_t kMagic = 0xB6B1D7C0;
+    static constexpr bool kTrivial = true;
+    uint64_t MAGIC = kMagic;
+    vhQueueToken token;
+    uint32_t count;
+
+    VIDL_vhDispatchBatchInternal() = default;
+
+    VIDL_vhDispatchBatchInternal(vhQueueToken _token, uint32_t _count)
+        : token(_token), count(_count) {}
+};
+static_assert( !VIDL_vhDispatchBatchInternal::kTrivial || std::is_trivially_destructible_v< VIDL_vhDispatchBatchInternal >, "VIDL_vhDispatchBatchInternal must stay trivially destructible." );
+
+struct VIDL_vhQueueSignalInternal
+{
+    static constexpr uint64_t kMagic = 0x1CCF0B87;
+    static constexpr bool kTrivial = true;
+    uint64_t MAGIC = kMagic;
+    vhQueueToken token;
+    nvrhi::CommandQueue queue;
+
+    VIDL_vhQueueSignalInternal() = default;
+
+    VIDL_vhQueueSignalInternal(vhQueueToken _token, nvrhi::CommandQueue _queue)
+        : token(_token), queue(_queue) {}
+};
+static_assert( !VIDL_vhQueueSignalInternal::kTrivial || std::is_trivially_destructible_v< VIDL_vhQueueSignalInternal >, "VIDL_vhQueueSignalInternal must stay trivially destructible." );
+
+struct VIDL_vhQueueWaitInternal
+{
+    static constexpr uint64_t kMagic = 0xEB8A4D03;
+    static constexpr bool kTrivial = true;
+    uint64_t MAGIC = kMagic;
+    nvrhi::CommandQueue consumer;
+    vhQueueToken token;
+
+    VIDL_vhQueueWaitInternal() = default;
+
+    VIDL_vhQueueWaitInternal(nvrhi::CommandQueue _consumer, vhQueueToken _token)
+        : consumer(_consumer), token(_token) {}
+};
+static_assert( !VIDL_vhQueueWaitInternal::kTrivial || std::is_trivially_destructible_v< VIDL_vhQueueWaitInternal >, "VIDL_vhQueueWaitInternal must stay trivially destructible." );
+
+struct VIDL_vhSubmitDrawsInternal
+{
+    static constexpr uint64_t kMagic = 0x892BE51D;
+    static constexpr bool kTrivial = true;
+    uint64_t MAGIC = kMagic;
+    uint64_t frame;
+    uint32_t count;
+
+    VIDL_vhSubmitDrawsInternal() = default;
+
+    VIDL_vhSubmitDrawsInternal(uint64_t _frame, uint32_t _count)
+        : frame(_frame), count(_count) {}
+};
+static_assert( !VIDL_vhSubmitDrawsInternal::kTrivial || std::is_trivially_destructible_v< VIDL_vhSubmitDrawsInternal >, "VIDL_vhSubmitDrawsInternal must stay trivially destructible." );
+
+struct VIDL_vhFrameInternal
+{
+    static constexpr uint64_t kMagic = 0xE417B267;
+    static constexpr bool kTrivial = true;
+    uint64_t MAGIC = kMagic;
+    uint64_t frame;
+    uint32_t encoders;
+
+    VIDL_vhFrameInternal() = default;
+
+    VIDL_vhFrameInternal(uint64_t _frame, uint32_t _encoders)
+        : frame(_frame), encoders(_encoders) {}
+};
+static_assert( !VIDL_vhFrameInternal::kTrivial || std::is_trivially_destructible_v< VIDL_vhFrameInternal >, "VIDL_vhFrameInternal must stay trivially destructible." );
+
+struct VIDL_vhReadTextureAsyncInternal
+{
+    static constexpr uint64_t kMagic = 0x22A6DDCE;
+    static constexpr bool kTrivial = true;
+    uint64_t MAGIC = kMagic;
+    vhReadbackTicket ticket;
+    vhTexture texture;
+    int startMips;
+    int startLayers;
+    int numMips;
+    int numLayers;
+    vhMem* outData;
+
+    VIDL_vhReadTextureAsyncInternal() = default;
+
+    VIDL_vhReadTextureAsyncInternal(vhReadbackTicket _ticket, vhTexture _texture, int _startMips, int _startLayers, int _numMips, int _numLayers, vhMem* _outData)
+        : ticket(_ticket), texture(_texture), startMips(_startMips), startLayers(_startLayers), numMips(_numMips), numLayers(_numLayers), outData(_outData) {}
+};
+static_assert( !VIDL_vhReadTextureAsyncInternal::kTrivial || std::is_trivially_destructible_v< VIDL_vhReadTextureAsyncInternal >, "VIDL_vhReadTextureAsyncInternal must stay trivially destructible." );
+
+struct VIDL_vhReadBufferAsyncInternal
+{
+    static constexpr uint64_t kMagic = 0xAEAC6FDA;
+    static constexpr bool kTrivial = true;
+    uint64_t MAGIC = kMagic;
+    vhReadbackTicket ticket;
+    vhBuffer buffer;
+    uint64_t offset;
+    uint64_t size;
+    vhMem* outData;
+
+    VIDL_vhReadBufferAsyncInternal() = default;
+
+    VIDL_vhReadBufferAsyncInternal(vhReadbackTicket _ticket, vhBuffer _buffer, uint64_t _offset, uint64_t _size, vhMem* _outData)
+        : ticket(_ticket), buffer(_buffer), offset(_offset), size(_size), outData(_outData) {}
+};
+static_assert( !VIDL_vhReadBufferAsyncInternal::kTrivial || std::is_trivially_destructible_v< VIDL_vhReadBufferAsyncInternal >, "VIDL_vhReadBufferAsyncInternal must stay trivially destructible." );
+
+struct VIDL_vhRetireReadbacksInternal
+{
+    static constexpr uint64_t kMagic = 0x38567899;
+    static constexpr bool kTrivial = true;
+    uint64_t MAGIC = kMagic;
+    vhReadbackTicket waitTicket;
+
+    VIDL_vhRetireReadbacksInternal() = default;
+
+    VIDL_vhRetireReadbacksInternal(vhReadbackTicket _waitTicket)
+        : waitTicket(_waitTicket) {}
+};
+static_assert( !VIDL_vhRetireReadbacksInternal::kTrivial || std::is_trivially_destructible_v< VIDL_vhRetireReadbacksInternal >, "VIDL_vhRetireReadbacksInternal must stay trivially destructible." );
+
+struct VIDL_vhCommitUploadInternal
+{
+    static constexpr uint64_t kMagic = 0xFA39DB2F;
+    static constexpr bool kTrivial = true;
+    uint64_t MAGIC = kMagic;
+    vhUploadMapping mapping;
+
+    VIDL_vhCommitUploadInternal() = default;
+
+    VIDL_vhCommitUploadInternal(vhUploadMapping _mapping)
+        : mapping(_mapping) {}
+};
+static_assert( !VIDL_vhCommitUploadInternal::kTrivial || std::is_trivially_destructible_v< VIDL_vhCommitUploadInternal >, "VIDL_vhCommitUploadInternal must stay trivially destructible." );
 
 struct VIDL_vhCmdSetStateViewRect
 {
     static constexpr uint64_t kMagic = 0x25DC7E64;
+    static constexpr bool kTrivial = true;
     uint64_t MAGIC = kMagic;
     vhStateId id;
     glm::vec4 rect;
@@ -349,10 +570,12 @@ struct VIDL_vhCmdSetStateViewRect
     VIDL_vhCmdSetStateViewRect(vhStateId _id, glm::vec4 _rect)
         : id(_id), rect(_rect) {}
 };
+static_assert( !VIDL_vhCmdSetStateViewRect::kTrivial || std::is_trivially_destructible_v< VIDL_vhCmdSetStateViewRect >, "VIDL_vhCmdSetStateViewRect must stay trivially destructible." );
 
 struct VIDL_vhCmdSetStateViewScissor
 {
     static constexpr uint64_t kMagic = 0xD89EF1E1;
+    static constexpr bool kTrivial = true;
     uint64_t MAGIC = kMagic;
     vhStateId id;
     glm::vec4 scissor;
@@ -362,10 +585,12 @@ struct VIDL_vhCmdSetStateViewScissor
     VIDL_vhCmdSetStateViewScissor(vhStateId _id, glm::vec4 _scissor)
         : id(_id), scissor(_scissor) {}
 };
+static_assert( !VIDL_vhCmdSetStateViewScissor::kTrivial || std::is_trivially_destructible_v< VIDL_vhCmdSetStateViewScissor >, "VIDL_vhCmdSetStateViewScissor must stay trivially destructible." );
 
 struct VIDL_vhCmdSetStateViewClear
 {
     static constexpr uint64_t kMagic = 0xAB6B3FB4;
+    static constexpr bool kTrivial = true;
     uint64_t MAGIC = kMagic;
     vhStateId id;
     uint16_t flags;
@@ -378,10 +603,12 @@ struct VIDL_vhCmdSetStateViewClear
     VIDL_vhCmdSetStateViewClear(vhStateId _id, uint16_t _flags, uint32_t _rgba, float _depth, uint8_t _stencil)
         : id(_id), flags(_flags), rgba(_rgba), depth(_depth), stencil(_stencil) {}
 };
+static_assert( !VIDL_vhCmdSetStateViewClear::kTrivial || std::is_trivially_destructible_v< VIDL_vhCmdSetStateViewClear >, "VIDL_vhCmdSetStateViewClear must stay trivially destructible." );
 
 struct VIDL_vhCmdSetStateProgram
 {
     static constexpr uint64_t kMagic = 0x106BC354;
+    static constexpr bool kTrivial = false;
     uint64_t MAGIC = kMagic;
     vhStateId id;
     vhProgram program;
@@ -391,10 +618,12 @@ struct VIDL_vhCmdSetStateProgram
     VIDL_vhCmdSetStateProgram(vhStateId _id, vhProgram _program)
         : id(_id), program(_program) {}
 };
+static_assert( !VIDL_vhCmdSetStateProgram::kTrivial || std::is_trivially_destructible_v< VIDL_vhCmdSetStateProgram >, "VIDL_vhCmdSetStateProgram must stay trivially destructible." );
 
 struct VIDL_vhCmdSetStateViewTransform
 {
     static constexpr uint64_t kMagic = 0x95EE7C8C;
+    static constexpr bool kTrivial = true;
     uint64_t MAGIC = kMagic;
     vhStateId id;
     glm::mat4 view;
@@ -405,10 +634,12 @@ struct VIDL_vhCmdSetStateViewTransform
     VIDL_vhCmdSetStateViewTransform(vhStateId _id, glm::mat4 _view, glm::mat4 _proj)
         : id(_id), view(_view), proj(_proj) {}
 };
+static_assert( !VIDL_vhCmdSetStateViewTransform::kTrivial || std::is_trivially_destructible_v< VIDL_vhCmdSetStateViewTransform >, "VIDL_vhCmdSetStateViewTransform must stay trivially destructible." );
 
 struct VIDL_vhCmdSetStateWorldTransform
 {
     static constexpr uint64_t kMagic = 0x8FB805B7;
+    static constexpr bool kTrivial = false;
     uint64_t MAGIC = kMagic;
     vhStateId id;
     std::vector< glm::mat4 > matrices;
@@ -418,10 +649,12 @@ struct VIDL_vhCmdSetStateWorldTransform
     VIDL_vhCmdSetStateWorldTransform(vhStateId _id, std::vector< glm::mat4 > _matrices)
         : id(_id), matrices(_matrices) {}
 };
+static_assert( !VIDL_vhCmdSetStateWorldTransform::kTrivial || std::is_trivially_destructible_v< VIDL_vhCmdSetStateWorldTransform >, "VIDL_vhCmdSetStateWorldTransform must stay trivially destructible." );
 
 struct VIDL_vhCmdSetStateFlags
 {
     static constexpr uint64_t kMagic = 0xC3CE00B4;
+    static constexpr bool kTrivial = true;
     uint64_t MAGIC = kMagic;
     vhStateId id;
     uint64_t flags;
@@ -431,10 +664,12 @@ struct VIDL_vhCmdSetStateFlags
     VIDL_vhCmdSetStateFlags(vhStateId _id, uint64_t _flags)
         : id(_id), flags(_flags) {}
 };
+static_assert( !VIDL_vhCmdSetStateFlags::kTrivial || std::is_trivially_destructible_v< VIDL_vhCmdSetStateFlags >, "VIDL_vhCmdSetStateFlags must stay trivially destructible." );
 
 struct VIDL_vhCmdSetStateDebugFlags
 {
     static constexpr uint64_t kMagic = 0x9CFC0ABD;
+    static constexpr bool kTrivial = true;
     uint64_t MAGIC = kMagic;
     vhStateId id;
     uint64_t flags;
@@ -444,10 +679,12 @@ struct VIDL_vhCmdSetStateDebugFlags
     VIDL_vhCmdSetStateDebugFlags(vhStateId _id, uint64_t _flags)
         : id(_id), flags(_flags) {}
 };
+static_assert( !VIDL_vhCmdSetStateDebugFlags::kTrivial || std::is_trivially_destructible_v< VIDL_vhCmdSetStateDebugFlags >, "VIDL_vhCmdSetStateDebugFlags must stay trivially destructible." );
 
 struct VIDL_vhCmdSetStateStencil
 {
     static constexpr uint64_t kMagic = 0x007FD9BA;
+    static constexpr bool kTrivial = true;
     uint64_t MAGIC = kMagic;
     vhStateId id;
     uint32_t front;
@@ -458,10 +695,12 @@ struct VIDL_vhCmdSetStateStencil
     VIDL_vhCmdSetStateStencil(vhStateId _id, uint32_t _front, uint32_t _back)
         : id(_id), front(_front), back(_back) {}
 };
+static_assert( !VIDL_vhCmdSetStateStencil::kTrivial || std::is_trivially_destructible_v< VIDL_vhCmdSetStateStencil >, "VIDL_vhCmdSetStateStencil must stay trivially destructible." );
 
 struct VIDL_vhCmdSetStateVertexBuffer
 {
     static constexpr uint64_t kMagic = 0xF0E68F37;
+    static constexpr bool kTrivial = true;
     uint64_t MAGIC = kMagic;
     vhStateId id;
     uint8_t stream;
@@ -475,10 +714,12 @@ struct VIDL_vhCmdSetStateVertexBuffer
     VIDL_vhCmdSetStateVertexBuffer(vhStateId _id, uint8_t _stream, vhBuffer _buffer, uint64_t _offset, uint32_t _start, uint32_t _num)
         : id(_id), stream(_stream), buffer(_buffer), offset(_offset), start(_start), num(_num) {}
 };
+static_assert( !VIDL_vhCmdSetStateVertexBuffer::kTrivial || std::is_trivially_destructible_v< VIDL_vhCmdSetStateVertexBuffer >, "VIDL_vhCmdSetStateVertexBuffer must stay trivially destructible." );
 
 struct VIDL_vhCmdSetStateIndexBuffer
 {
     static constexpr uint64_t kMagic = 0xE36C062A;
+    static constexpr bool kTrivial = true;
     uint64_t MAGIC = kMagic;
     vhStateId id;
     vhBuffer buffer;
@@ -491,10 +732,12 @@ struct VIDL_vhCmdSetStateIndexBuffer
     VIDL_vhCmdSetStateIndexBuffer(vhStateId _id, vhBuffer _buffer, uint64_t _offset, uint32_t _first, uint32_t _num)
         : id(_id), buffer(_buffer), offset(_offset), first(_first), num(_num) {}
 };
+static_assert( !VIDL_vhCmdSetStateIndexBuffer::kTrivial || std::is_trivially_destructible_v< VIDL_vhCmdSetStateIndexBuffer >, "VIDL_vhCmdSetStateIndexBuffer must stay trivially destructible." );
 
 struct VIDL_vhCmdSetStateTextures
 {
     static constexpr uint64_t kMagic = 0x3A615501;
+    static constexpr bool kTrivial = false;
     uint64_t MAGIC = kMagic;
     vhStateId id;
     const std::vector< vhState::TextureBinding > textures;
@@ -504,10 +747,12 @@ struct VIDL_vhCmdSetStateTextures
     VIDL_vhCmdSetStateTextures(vhStateId _id, const std::vector< vhState::TextureBinding >& _textures)
         : id(_id), textures(_textures) {}
 };
+static_assert( !VIDL_vhCmdSetStateTextures::kTrivial || std::is_trivially_destructible_v< VIDL_vhCmdSetStateTextures >, "VIDL_vhCmdSetStateTextures must stay trivially destructible." );
 
 struct VIDL_vhCmdSetStateSamplers
 {
     static constexpr uint64_t kMagic = 0xFCB052A2;
+    static constexpr bool kTrivial = false;
     uint64_t MAGIC = kMagic;
     vhStateId id;
     const std::vector< vhState::SamplerDefinition > samplers;
@@ -517,10 +762,12 @@ struct VIDL_vhCmdSetStateSamplers
     VIDL_vhCmdSetStateSamplers(vhStateId _id, const std::vector< vhState::SamplerDefinition >& _samplers)
         : id(_id), samplers(_samplers) {}
 };
+static_assert( !VIDL_vhCmdSetStateSamplers::kTrivial || std::is_trivially_destructible_v< VIDL_vhCmdSetStateSamplers >, "VIDL_vhCmdSetStateSamplers must stay trivially destructible." );
 
 struct VIDL_vhCmdSetStateBuffers
 {
     static constexpr uint64_t kMagic = 0x953A85B6;
+    static constexpr bool kTrivial = false;
     uint64_t MAGIC = kMagic;
     vhStateId id;
     const std::vector< vhState::BufferBinding > buffers;
@@ -530,10 +777,12 @@ struct VIDL_vhCmdSetStateBuffers
     VIDL_vhCmdSetStateBuffers(vhStateId _id, const std::vector< vhState::BufferBinding >& _buffers)
         : id(_id), buffers(_buffers) {}
 };
+static_assert( !VIDL_vhCmdSetStateBuffers::kTrivial || std::is_trivially_destructible_v< VIDL_vhCmdSetStateBuffers >, "VIDL_vhCmdSetStateBuffers must stay trivially destructible." );
 
 struct VIDL_vhCmdSetStateConstants
 {
     static constexpr uint64_t kMagic = 0x23287787;
+    static constexpr bool kTrivial = false;
     uint64_t MAGIC = kMagic;
     vhStateId id;
     const std::vector< vhState::ConstantBufferValue > constants;
@@ -543,10 +792,12 @@ struct VIDL_vhCmdSetStateConstants
     VIDL_vhCmdSetStateConstants(vhStateId _id, const std::vector< vhState::ConstantBufferValue >& _constants)
         : id(_id), constants(_constants) {}
 };
+static_assert( !VIDL_vhCmdSetStateConstants::kTrivial || std::is_trivially_destructible_v< VIDL_vhCmdSetStateConstants >, "VIDL_vhCmdSetStateConstants must stay trivially destructible." );
 
 struct VIDL_vhCmdSetStatePushConstants
 {
     static constexpr uint64_t kMagic = 0x0A9462A0;
+    static constexpr bool kTrivial = true;
     uint64_t MAGIC = kMagic;
     vhStateId id;
     glm::vec4 data;
@@ -556,10 +807,12 @@ struct VIDL_vhCmdSetStatePushConstants
     VIDL_vhCmdSetStatePushConstants(vhStateId _id, glm::vec4 _data)
         : id(_id), data(_data) {}
 };
+static_assert( !VIDL_vhCmdSetStatePushConstants::kTrivial || std::is_trivially_destructible_v< VIDL_vhCmdSetStatePushConstants >, "VIDL_vhCmdSetStatePushConstants must stay trivially destructible." );
 
 struct VIDL_vhCmdSetStateUniforms
 {
     static constexpr uint64_t kMagic = 0xAB3B2AB3;
+    static constexpr bool kTrivial = false;
     uint64_t MAGIC = kMagic;
     vhStateId id;
     const std::vector< vhState::UniformBufferValue > uniforms;
@@ -569,10 +822,113 @@ struct VIDL_vhCmdSetStateUniforms
     VIDL_vhCmdSetStateUniforms(vhStateId _id, const std::vector< vhState::UniformBufferValue >& _uniforms)
         : id(_id), uniforms(_uniforms) {}
 };
+static_assert( !VIDL_vhCmdSetStateUniforms::kTrivial || std::is_trivially_destructible_v< VIDL_vhCmdSetStateUniforms >, "VIDL_vhCmdSetStateUniforms must stay trivially destructible." );
+
+struct VIDL_vhCmdSetStateTexture
+{
+    static constexpr uint64_t kMagic = 0x313C9184;
+    static constexpr bool kTrivial = true;
+    uint64_t MAGIC = kMagic;
+    vhStateId id;
+    uint32_t idx;
+    uint32_t count;
+    vhState::TextureBinding texture;
+
+    VIDL_vhCmdSetStateTexture() = default;
+
+    VIDL_vhCmdSetStateTexture(vhStateId _id, uint32_t _idx, uint32_t _count, vhState::TextureBinding _texture)
+        : id(_id), idx(_idx), count(_count), texture(_texture) {}
+};
+static_assert( !VIDL_vhCmdSetStateTexture::kTrivial || std::is_trivially_destructible_v< VIDL_vhCmdSetStateTexture >, "VIDL_vhCmdSetStateTexture must stay trivially destructible." );
+
+struct VIDL_vhCmdSetStateSampler
+{
+    static constexpr uint64_t kMagic = 0xC4130CCC;
+    static constexpr bool kTrivial = true;
+    uint64_t MAGIC = kMagic;
+    vhStateId id;
+    uint32_t idx;
+    uint32_t count;
+    vhState::SamplerDefinition sampler;
+
+    VIDL_vhCmdSetStateSampler() = default;
+
+    VIDL_vhCmdSetStateSampler(vhStateId _id, uint32_t _idx, uint32_t _count, vhState::SamplerDefinition _sampler)
+        : id(_id), idx(_idx), count(_count), sampler(_sampler) {}
+};
+static_assert( !VIDL_vhCmdSetStateSampler::kTrivial || std::is_trivially_destructible_v< VIDL_vhCmdSetStateSampler >, "VIDL_vhCmdSetStateSampler must stay trivially destructible." );
+
+struct VIDL_vhCmdSetStateBuffer
+{
+    static constexpr uint64_t kMagic = 0xAA98A827;
+    static constexpr bool kTrivial = true;
+    uint64_t MAGIC = kMagic;
+    vhStateId id;
+    uint32_t idx;
+    uint32_t count;
+    vhState::BufferBinding buffer;
+
+    VIDL_vhCmdSetStateBuffer() = default;
+
+    VIDL_vhCmdSetStateBuffer(vhStateId _id, uint32_t _idx, uint32_t _count, vhState::BufferBinding _buffer)
+        : id(_id), idx(_idx), count(_count), buffer(_buffer) {}
+};
+static_assert( !VIDL_vhCmdSetStateBuffer::kTrivial || std::is_trivially_destructible_v< VIDL_vhCmdSetStateBuffer >, "VIDL_vhCmdSetStateBuffer must stay trivially destructible." );
+
+struct VIDL_vhCmdSetStateConstant
+{
+    static constexpr uint64_t kMagic = 0x94F611AD;
+    static constexpr bool kTrivial = false;
+    uint64_t MAGIC = kMagic;
+    vhStateId id;
+    uint32_t idx;
+    uint32_t count;
+    const vhState::ConstantBufferValue constant;
+
+    VIDL_vhCmdSetStateConstant() = default;
+
+    VIDL_vhCmdSetStateConstant(vhStateId _id, uint32_t _idx, uint32_t _count, const vhState::ConstantBufferValue& _constant)
+        : id(_id), idx(_idx), count(_count), constant(_constant) {}
+};
+static_assert( !VIDL_vhCmdSetStateConstant::kTrivial || std::is_trivially_destructible_v< VIDL_vhCmdSetStateConstant >, "VIDL_vhCmdSetStateConstant must stay trivially destructible." );
+
+struct VIDL_vhCmdSetStateUniform
+{
+    static constexpr uint64_t kMagic = 0xC5ADBFD4;
+    static constexpr bool kTrivial = false;
+    uint64_t MAGIC = kMagic;
+    vhStateId id;
+    uint32_t idx;
+    uint32_t count;
+    const vhState::UniformBufferValue uniform;
+
+    VIDL_vhCmdSetStateUniform() = default;
+
+    VIDL_vhCmdSetStateUniform(vhStateId _id, uint32_t _idx, uint32_t _count, const vhState::UniformBufferValue& _uniform)
+        : id(_id), idx(_idx), count(_count), uniform(_uniform) {}
+};
+static_assert( !VIDL_vhCmdSetStateUniform::kTrivial || std::is_trivially_destructible_v< VIDL_vhCmdSetStateUniform >, "VIDL_vhCmdSetStateUniform must stay trivially destructible." );
+
+struct VIDL_vhCmdSetStateBlock
+{
+    static constexpr uint64_t kMagic = 0xEE7D6490;
+    static constexpr bool kTrivial = true;
+    uint64_t MAGIC = kMagic;
+    vhStateId id;
+    uint64_t dirty;
+    uint64_t size;
+
+    VIDL_vhCmdSetStateBlock() = default;
+
+    VIDL_vhCmdSetStateBlock(vhStateId _id, uint64_t _dirty, uint64_t _size)
+        : id(_id), dirty(_dirty), size(_size) {}
+};
+static_assert( !VIDL_vhCmdSetStateBlock::kTrivial || std::is_trivially_destructible_v< VIDL_vhCmdSetStateBlock >, "VIDL_vhCmdSetStateBlock must stay trivially destructible." );
 
 struct VIDL_vhCmdSetStateAttachments
 {
     static constexpr uint64_t kMagic = 0xD3B53061;
+    static constexpr bool kTrivial = false;
     uint64_t MAGIC = kMagic;
     vhStateId id;
     const std::vector< vhState::RenderTarget > colours;
@@ -583,50 +939,68 @@ struct VIDL_vhCmdSetStateAttachments
     VIDL_vhCmdSetStateAttachments(vhStateId _id, const std::vector< vhState::RenderTarget >& _colours, vhState::RenderTarget _depth)
         : id(_id), colours(_colours), depth(_depth) {}
 };
+static_assert( !VIDL_vhCmdSetStateAttachments::kTrivial || std::is_trivially_destructible_v< VIDL_vhCmdSetStateAttachments >, "VIDL_vhCmdSetStateAttachments must stay trivially destructible." );
 
 struct VIDLHandler
 {
-    virtual void Handle_vhResizeCleanup( VIDL_vhResizeCleanup* cmd ) { (void) cmd; };
-    virtual void Handle_vhResetTexture( VIDL_vhResetTexture* cmd ) { (void) cmd; };
-    virtual void Handle_vhResetBuffer( VIDL_vhResetBuffer* cmd ) { (void) cmd; };
-    virtual void Handle_vhDestroyTexture( VIDL_vhDestroyTexture* cmd ) { (void) cmd; };
-    virtual void Handle_vhCreateTexture( VIDL_vhCreateTexture* cmd ) { (void) cmd; };
-    virtual void Handle_vhUpdateTexture( VIDL_vhUpdateTexture* cmd ) { (void) cmd; };
-    virtual void Handle_vhReadTextureSlow( VIDL_vhReadTextureSlow* cmd ) { (void) cmd; };
-    virtual void Handle_vhBlitTexture( VIDL_vhBlitTexture* cmd ) { (void) cmd; };
-    virtual void Handle_vhCreateVertexBuffer( VIDL_vhCreateVertexBuffer* cmd ) { (void) cmd; };
-    virtual void Handle_vhUpdateVertexBuffer( VIDL_vhUpdateVertexBuffer* cmd ) { (void) cmd; };
-    virtual void Handle_vhCreateIndexBuffer( VIDL_vhCreateIndexBuffer* cmd ) { (void) cmd; };
-    virtual void Handle_vhUpdateIndexBuffer( VIDL_vhUpdateIndexBuffer* cmd ) { (void) cmd; };
-    virtual void Handle_vhCreateUniformBuffer( VIDL_vhCreateUniformBuffer* cmd ) { (void) cmd; };
-    virtual void Handle_vhUpdateUniformBuffer( VIDL_vhUpdateUniformBuffer* cmd ) { (void) cmd; };
-    virtual void Handle_vhCreateStorageBuffer( VIDL_vhCreateStorageBuffer* cmd ) { (void) cmd; };
-    virtual void Handle_vhUpdateStorageBuffer( VIDL_vhUpdateStorageBuffer* cmd ) { (void) cmd; };
-    virtual void Handle_vhBlitBuffer( VIDL_vhBlitBuffer* cmd ) { (void) cmd; };
-    virtual void Handle_vhDestroyBuffer( VIDL_vhDestroyBuffer* cmd ) { (void) cmd; };
-    virtual void Handle_vhCreateShader( VIDL_vhCreateShader* cmd ) { (void) cmd; };
-    virtual void Handle_vhDestroyShader( VIDL_vhDestroyShader* cmd ) { (void) cmd; };
-    virtual void Handle_vhDispatch( VIDL_vhDispatch* cmd ) { (void) cmd; };
-    virtual void Handle_vhDispatchIndirect( VIDL_vhDispatchIndirect* cmd ) { (void) cmd; };
-    virtual void Handle_vhFlushInternal( VIDL_vhFlushInternal* cmd ) { (void) cmd; };
-    virtual void Handle_vhCmdSetStateViewRect( VIDL_vhCmdSetStateViewRect* cmd ) { (void) cmd; };
-    virtual void Handle_vhCmdSetStateViewScissor( VIDL_vhCmdSetStateViewScissor* cmd ) { (void) cmd; };
-    virtual void Handle_vhCmdSetStateViewClear( VIDL_vhCmdSetStateViewClear* cmd ) { (void) cmd; };
-    virtual void Handle_vhCmdSetStateProgram( VIDL_vhCmdSetStateProgram* cmd ) { (void) cmd; };
-    virtual void Handle_vhCmdSetStateViewTransform( VIDL_vhCmdSetStateViewTransform* cmd ) { (void) cmd; };
-    virtual void Handle_vhCmdSetStateWorldTransform( VIDL_vhCmdSetStateWorldTransform* cmd ) { (void) cmd; };
-    virtual void Handle_vhCmdSetStateFlags( VIDL_vhCmdSetStateFlags* cmd ) { (void) cmd; };
-    virtual void Handle_vhCmdSetStateDebugFlags( VIDL_vhCmdSetStateDebugFlags* cmd ) { (void) cmd; };
-    virtual void Handle_vhCmdSetStateStencil( VIDL_vhCmdSetStateStencil* cmd ) { (void) cmd; };
-    virtual void Handle_vhCmdSetStateVertexBuffer( VIDL_vhCmdSetStateVertexBuffer* cmd ) { (void) cmd; };
-    virtual void Handle_vhCmdSetStateIndexBuffer( VIDL_vhCmdSetStateIndexBuffer* cmd ) { (void) cmd; };
-    virtual void Handle_vhCmdSetStateTextures( VIDL_vhCmdSetStateTextures* cmd ) { (void) cmd; };
-    virtual void Handle_vhCmdSetStateSamplers( VIDL_vhCmdSetStateSamplers* cmd ) { (void) cmd; };
-    virtual void Handle_vhCmdSetStateBuffers( VIDL_vhCmdSetStateBuffers* cmd ) { (void) cmd; };
-    virtual void Handle_vhCmdSetStateConstants( VIDL_vhCmdSetStateConstants* cmd ) { (void) cmd; };
-    virtual void Handle_vhCmdSetStatePushConstants( VIDL_vhCmdSetStatePushConstants* cmd ) { (void) cmd; };
-    virtual void Handle_vhCmdSetStateUniforms( VIDL_vhCmdSetStateUniforms* cmd ) { (void) cmd; };
-    virtual void Handle_vhCmdSetStateAttachments( VIDL_vhCmdSetStateAttachments* cmd ) { (void) cmd; };
+    virtual void Handle_vhResizeCleanup( VIDL_vhResizeCleanup* cmd ) { vhCmdRelease( cmd ); };
+    virtual void Handle_vhResetTexture( VIDL_vhResetTexture* cmd ) { vhCmdRelease( cmd ); };
+    virtual void Handle_vhResetBuffer( VIDL_vhResetBuffer* cmd ) { vhCmdRelease( cmd ); };
+    virtual void Handle_vhDestroyTexture( VIDL_vhDestroyTexture* cmd ) { vhCmdRelease( cmd ); };
+    virtual void Handle_vhCreateTexture( VIDL_vhCreateTexture* cmd ) { vhCmdRelease( cmd ); };
+    virtual void Handle_vhUpdateTexture( VIDL_vhUpdateTexture* cmd ) { vhCmdRelease( cmd ); };
+    virtual void Handle_vhBlitTexture( VIDL_vhBlitTexture* cmd ) { vhCmdRelease( cmd ); };
+    virtual void Handle_vhCreateVertexBuffer( VIDL_vhCreateVertexBuffer* cmd ) { vhCmdRelease( cmd ); };
+    virtual void Handle_vhUpdateVertexBuffer( VIDL_vhUpdateVertexBuffer* cmd ) { vhCmdRelease( cmd ); };
+    virtual void Handle_vhCreateIndexBuffer( VIDL_vhCreateIndexBuffer* cmd ) { vhCmdRelease( cmd ); };
+    virtual void Handle_vhUpdateIndexBuffer( VIDL_vhUpdateIndexBuffer* cmd ) { vhCmdRelease( cmd ); };
+    virtual void Handle_vhCreateUniformBuffer( VIDL_vhCreateUniformBuffer* cmd ) { vhCmdRelease( cmd ); };
+    virtual void Handle_vhUpdateUniformBuffer( VIDL_vhUpdateUniformBuffer* cmd ) { vhCmdRelease( cmd ); };
+    virtual void Handle_vhCreateStorageBuffer( VIDL_vhCreateStorageBuffer* cmd ) { vhCmdRelease( cmd ); };
+    virtual void Handle_vhUpdateStorageBuffer( VIDL_vhUpdateStorageBuffer* cmd ) { vhCmdRelease( cmd ); };
+    virtual void Handle_vhBlitBuffer( VIDL_vhBlitBuffer* cmd ) { vhCmdRelease( cmd ); };
+    virtual void Handle_vhReserveBuffer( VIDL_vhReserveBuffer* cmd ) { vhCmdRelease( cmd ); };
+    virtual void Handle_vhDestroyBuffer( VIDL_vhDestroyBuffer* cmd ) { vhCmdRelease( cmd ); };
+    virtual void Handle_vhCreateShader( VIDL_vhCreateShader* cmd ) { vhCmdRelease( cmd ); };
+    virtual void Handle_vhDestroyShader( VIDL_vhDestroyShader* cmd ) { vhCmdRelease( cmd ); };
+    virtual void Handle_vhCreateStateBlock( VIDL_vhCreateStateBlock* cmd ) { vhCmdRelease( cmd ); };
+    virtual void Handle_vhDestroyStateBlock( VIDL_vhDestroyStateBlock* cmd ) { vhCmdRelease( cmd ); };
+    virtual void Handle_vhFlushInternal( VIDL_vhFlushInternal* cmd ) { vhCmdRelease( cmd ); };
+    virtual void Handle_vhDispatchInternal( VIDL_vhDispatchInternal* cmd ) { vhCmdRelease( cmd ); };
+    virtual void Handle_vhDispatchIndirectInternal( VIDL_vhDispatchIndirectInternal* cmd ) { vhCmdRelease( cmd ); };
+    virtual void Handle_vhDispatchBatchInternal( VIDL_vhDispatchBatchInternal* cmd ) { vhCmdRelease( cmd ); };
+    virtual void Handle_vhQueueSignalInternal( VIDL_vhQueueSignalInternal* cmd ) { vhCmdRelease( cmd ); };
+    virtual void Handle_vhQueueWaitInternal( VIDL_vhQueueWaitInternal* cmd ) { vhCmdRelease( cmd ); };
+    virtual void Handle_vhSubmitDrawsInternal( VIDL_vhSubmitDrawsInternal* cmd ) { vhCmdRelease( cmd ); };
+    virtual void Handle_vhFrameInternal( VIDL_vhFrameInternal* cmd ) { vhCmdRelease( cmd ); };
+    virtual void Handle_vhReadTextureAsyncInternal( VIDL_vhReadTextureAsyncInternal* cmd ) { vhCmdRelease( cmd ); };
+    virtual void Handle_vhReadBufferAsyncInternal( VIDL_vhReadBufferAsyncInternal* cmd ) { vhCmdRelease( cmd ); };
+    virtual void Handle_vhRetireReadbacksInternal( VIDL_vhRetireReadbacksInternal* cmd ) { vhCmdRelease( cmd ); };
+    virtual void Handle_vhCommitUploadInternal( VIDL_vhCommitUploadInternal* cmd ) { vhCmdRelease( cmd ); };
+    virtual void Handle_vhCmdSetStateViewRect( VIDL_vhCmdSetStateViewRect* cmd ) { vhCmdRelease( cmd ); };
+    virtual void Handle_vhCmdSetStateViewScissor( VIDL_vhCmdSetStateViewScissor* cmd ) { vhCmdRelease( cmd ); };
+    virtual void Handle_vhCmdSetStateViewClear( VIDL_vhCmdSetStateViewClear* cmd ) { vhCmdRelease( cmd ); };
+    virtual void Handle_vhCmdSetStateProgram( VIDL_vhCmdSetStateProgram* cmd ) { vhCmdRelease( cmd ); };
+    virtual void Handle_vhCmdSetStateViewTransform( VIDL_vhCmdSetStateViewTransform* cmd ) { vhCmdRelease( cmd ); };
+    virtual void Handle_vhCmdSetStateWorldTransform( VIDL_vhCmdSetStateWorldTransform* cmd ) { vhCmdRelease( cmd ); };
+    virtual void Handle_vhCmdSetStateFlags( VIDL_vhCmdSetStateFlags* cmd ) { vhCmdRelease( cmd ); };
+    virtual void Handle_vhCmdSetStateDebugFlags( VIDL_vhCmdSetStateDebugFlags* cmd ) { vhCmdRelease( cmd ); };
+    virtual void Handle_vhCmdSetStateStencil( VIDL_vhCmdSetStateStencil* cmd ) { vhCmdRelease( cmd ); };
+    virtual void Handle_vhCmdSetStateVertexBuffer( VIDL_vhCmdSetStateVertexBuffer* cmd ) { vhCmdRelease( cmd ); };
+    virtual void Handle_vhCmdSetStateIndexBuffer( VIDL_vhCmdSetStateIndexBuffer* cmd ) { vhCmdRelease( cmd ); };
+    virtual void Handle_vhCmdSetStateTextures( VIDL_vhCmdSetStateTextures* cmd ) { vhCmdRelease( cmd ); };
+    virtual void Handle_vhCmdSetStateSamplers( VIDL_vhCmdSetStateSamplers* cmd ) { vhCmdRelease( cmd ); };
+    virtual void Handle_vhCmdSetStateBuffers( VIDL_vhCmdSetStateBuffers* cmd ) { vhCmdRelease( cmd ); };
+    virtual void Handle_vhCmdSetStateConstants( VIDL_vhCmdSetStateConstants* cmd ) { vhCmdRelease( cmd ); };
+    virtual void Handle_vhCmdSetStatePushConstants( VIDL_vhCmdSetStatePushConstants* cmd ) { vhCmdRelease( cmd ); };
+    virtual void Handle_vhCmdSetStateUniforms( VIDL_vhCmdSetStateUniforms* cmd ) { vhCmdRelease( cmd ); };
+    virtual void Handle_vhCmdSetStateTexture( VIDL_vhCmdSetStateTexture* cmd ) { vhCmdRelease( cmd ); };
+    virtual void Handle_vhCmdSetStateSampler( VIDL_vhCmdSetStateSampler* cmd ) { vhCmdRelease( cmd ); };
+    virtual void Handle_vhCmdSetStateBuffer( VIDL_vhCmdSetStateBuffer* cmd ) { vhCmdRelease( cmd ); };
+    virtual void Handle_vhCmdSetStateConstant( VIDL_vhCmdSetStateConstant* cmd ) { vhCmdRelease( cmd ); };
+    virtual void Handle_vhCmdSetStateUniform( VIDL_vhCmdSetStateUniform* cmd ) { vhCmdRelease( cmd ); };
+    virtual void Handle_vhCmdSetStateBlock( VIDL_vhCmdSetStateBlock* cmd ) { vhCmdRelease( cmd ); };
+    virtual void Handle_vhCmdSetStateAttachments( VIDL_vhCmdSetStateAttachments* cmd ) { vhCmdRelease( cmd ); };
 
     virtual void HandleCmd( void* cmd )
     {
@@ -651,9 +1025,6 @@ struct VIDLHandler
         case 0x79B006BB:
             Handle_vhUpdateTexture( (VIDL_vhUpdateTexture*) cmd );
             break;
-        case 0x3BDDAB67:
-            Handle_vhReadTextureSlow( (VIDL_vhReadTextureSlow*) cmd );
-            break;
         case 0xD7782E0F:
             Handle_vhBlitTexture( (VIDL_vhBlitTexture*) cmd );
             break;
@@ -684,6 +1055,9 @@ struct VIDLHandler
         case 0x15BFFC71:
             Handle_vhBlitBuffer( (VIDL_vhBlitBuffer*) cmd );
             break;
+        case 0x7F7DEBD5:
+            Handle_vhReserveBuffer( (VIDL_vhReserveBuffer*) cmd );
+            break;
         case 0x3A87A73E:
             Handle_vhDestroyBuffer( (VIDL_vhDestroyBuffer*) cmd );
             break;
@@ -693,15 +1067,48 @@ struct VIDLHandler
         case 0x3328C9A7:
             Handle_vhDestroyShader( (VIDL_vhDestroyShader*) cmd );
             break;
-        case 0x8A8ABD80:
-            Handle_vhDispatch( (VIDL_vhDispatch*) cmd );
+        case 0xD4ADD975:
+            Handle_vhCreateStateBlock( (VIDL_vhCreateStateBlock*) cmd );
             break;
-        case 0x76CD9435:
-            Handle_vhDispatchIndirect( (VIDL_vhDispatchIndirect*) cmd );
+        case 0x19635457:
+            Handle_vhDestroyStateBlock( (VIDL_vhDestroyStateBlock*) cmd );
             break;
         case 0x83140D26:
             Handle_vhFlushInternal( (VIDL_vhFlushInternal*) cmd );
             break;
+        case 0xE69DCCA1:
+            Handle_vhDispatchInternal( (VIDL_vhDispatchInternal*) cmd );
+            break;
+        case 0x55C31562:
+            Handle_vhDispatchIndirectInternal( (VIDL_vhDispatchIndirectInternal*) cmd );
+            break;
+        case 0xB6B1D7C0:
+            Handle_vhDispatchBatchInternal( (VIDL_vhDispatchBatchInternal*) cmd );
+            break;
+        case 0x1CCF0B87:
+            Handle_vhQueueSignalInternal( (VIDL_vhQueueSignalInternal*) cmd );
+            break;
+        case 0xEB8A4D03:
+            Handle_vhQueueWaitInternal( (VIDL_vhQueueWaitInternal*) cmd );
+            break;
+        case 0x892BE51D:
+            Handle_vhSubmitDrawsInternal( (VIDL_vhSubmitDrawsInternal*) cmd );
+            break;
+        case 0xE417B267:
+            Handle_vhFrameInternal( (VIDL_vhFrameInternal*) cmd );
+            break;
+        case 0x22A6DDCE:
+            Handle_vhReadTextureAsyncInternal( (VIDL_vhReadTextureAsyncInternal*) cmd );
+            break;
+        case 0xAEAC6FDA:
+            Handle_vhReadBufferAsyncInternal( (VIDL_vhReadBufferAsyncInternal*) cmd );
+            break;
+        case 0x38567899:
+            Handle_vhRetireReadbacksInternal( (VIDL_vhRetireReadbacksInternal*) cmd );
+            break;
+        case 0xFA39DB2F:
+            Handle_vhCommitUploadInternal( (VIDL_vhCommitUploadInternal*) cmd );
+            break;
         case 0x25DC7E64:
             Handle_vhCmdSetStateViewRect( (VIDL_vhCmdSetStateViewRect*) cmd );
             break;
@@ -753,6 +1160,24 @@ struct VIDLHandler
         case 0xAB3B2AB3:
             Handle_vhCmdSetStateUniforms( (VIDL_vhCmdSetStateUniforms*) cmd );
             break;
+        case 0x313C9184:
+            Handle_vhCmdSetStateTexture( (VIDL_vhCmdSetStateTexture*) cmd );
+            break;
+        case 0xC4130CCC:
+            Handle_vhCmdSetStateSampler( (VIDL_vhCmdSetStateSampler*) cmd );
+            break;
+        case 0xAA98A827:
+            Handle_vhCmdSetStateBuffer( (VIDL_vhCmdSetStateBuffer*) cmd );
+            break;
+        case 0x94F611AD:
+            Handle_vhCmdSetStateConstant( (VIDL_vhCmdSetStateConstant*) cmd );
+            break;
+        case 0xC5ADBFD4:
+            Handle_vhCmdSetStateUniform( (VIDL_vhCmdSetStateUniform*) cmd );
+            break;
+        case 0xEE7D6490:
+            Handle_vhCmdSetStateBlock( (VIDL_vhCmdSetStateBlock*) cmd );
+            break;
         case 0xD3B53061:
             Handle_vhCmdSetStateAttachments( (VIDL_vhCmdSetStateAttachments*) cmd );
             break;
@@ -68,16 +68,28 @@
 #include <unordered_set>
 #include <unordered_map>
 #include <map>
+#include <deque>
+#include <array>
+#include <bit>
 #include <algorithm>
+#include <numeric>
 #include <climits>
 #include <string>
 #include <mutex>
 #include <functional>
 #include <thread>
 #include <atomic>
+#include <new>
+#include <type_traits>
 #include <vector>
 #include <filesystem>
 #include <concurrentqueue/blockingconcurrentqueue.h>
+#if !defined(_WIN32)
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
 #endif // VRHI_SKIP_COMMON_DEPENDENCY_INCLUDES
 
 // Required by NVRHI Vulkan backend
@@ -111,17 +123,11 @@ extern uint32_t g_QueueFamilyCompute;
 extern uint32_t g_QueueFamilyTransfer;
 
 // Resource State
-extern vhAllocatorObjectFreeList g_vhTextureIDList;
-extern std::unordered_map< vhTexture, bool > g_vhTextureIDValid;
-extern std::mutex g_vhTextureIDListMutex;
-extern vhAllocatorObjectFreeList g_vhBufferIDList;
-extern std::unordered_map< vhBuffer, bool > g_vhBufferIDValid;
-extern std::mutex g_vhBufferIDListMutex;
+extern vhHandleAllocator g_vhTextureIDList;
+extern vhHandleAllocator g_vhBufferIDList;
 
 // Shader state
-extern vhAllocatorObjectFreeList g_vhShaderIDList;
-extern std::unordered_map< vhShader, bool > g_vhShaderIDValid;
-extern std::mutex g_vhShaderIDListMutex;
+extern vhHandleAllocator g_vhShaderIDList;
 
 extern bool g_vhRayTracingEnabled;
 
@@ -130,9 +136,21 @@ extern moodycamel::BlockingConcurrentQueue< void* > g_vhCmds;
 extern std::atomic<bool> g_vhCmdsQuit;
 extern std::thread g_vhCmdThread;
 extern std::atomic<bool> g_vhCmdThreadReady;
-extern std::vector< std::vector<uint8_t>* > g_vhMemList;
+extern std::vector< vhMem* > g_vhMemList;
 extern std::mutex g_vhMemListMutex;
 extern uint64_t g_vhCmdListTransferSizeHeuristic;
+extern std::atomic< uint64_t > g_vhFlushTicketIssued;
+extern std::atomic< uint64_t > g_vhQueueTokenIssued;
+extern std::atomic< uint64_t > g_vhFlushTicketCompleted;
+extern std::atomic< uint64_t > g_vhReadbackTicketIssued;
+extern std::atomic< uint64_t > g_vhReadbackTicketCompleted;
+extern std::atomic< bool > g_vhReadbackPollPending;
+extern std::atomic< uint64_t > g_vhBufferResizeBytesCopied; // Bytes moved by buffer reallocations, see BE_ResizeBuffer().
+extern std::atomic< uint64_t > g_vhStateBytesEnqueued; // Bytes of state commands sent to the backend, see vhSetState().
+extern std::atomic< uint64_t > g_vhCmdListsCreated; // Command lists created by vhCmdListGet().
+extern std::atomic< uint64_t > g_vhCmdListsReused; // Command lists vhCmdListGet() recycled from the pool instead.
+extern std::atomic< uint64_t > g_vhFrameIndex; // Frame currently taking draws, see vhFrame().
+extern std::atomic< uint32_t > g_vhFrameEncoders; // Encoders that ended into it so far.
 
 // Backend State
 struct vhCmdBackendState;
@@ -143,10 +161,27 @@ void vhBackendThreadEntry( std::function<void()> initCallback );
 vhTexInfo vhBackendQueryTextureInfo( vhTexture texture, std::vector< vhTextureMipInfo >* outMipInfo );
 void* vhBackendQueryTextureHandle( vhTexture texture );
 uint64_t vhBackendQueryBufferInfo( vhBuffer buffer, uint32_t* outStride, uint64_t* outFlags );
-void* vhBackendQueryBufferHandle( vhBuffer buffer );
+void* vhBackendQueryBufferHandle( vhBuffer buffer, uint64_t* outOffset );
 void vhBackendQueryShaderInfo( vhShader shader, glm::uvec3* outGroupSize, std::vector< vhShaderReflectionResource >* outResources, std::vector< vhPushConstantRange >* outPushConstants, std::vector< vhSpecConstant >* outSpecConstants );
 void* vhBackendQueryShaderHandle( vhShader shader );
 bool vhBackendQueryState( vhStateId id, vhState& outState );
+vhPipelineCacheStats vhBackendQueryPipelineCacheStats();
+vhFrameStats vhBackendQueryFrameStats();
+uint8_t* vhBackendMapUpload( uint64_t size, uint32_t* outChunk, uint64_t* outOffset );
+
+// Pipeline Cache
+// On-disk layout of |g_vhInit.pipelineCachePath|: this header followed by the VkPipelineCache blob.
+struct vhPipelineCacheFileHeader
+{
+    uint32_t magic = 0x43505256; // 'VRPC'
+    uint32_t version = 1;
+    uint32_t vendorID = 0;
+    uint32_t deviceID = 0;
+    uint32_t driverVersion = 0;
+    uint8_t pipelineCacheUUID[VK_UUID_SIZE] = {};
+    uint64_t dataSize = 0;
+    uint64_t dataHash = 0;
+};
 
 // Dummy Resources
 void vhInitDummyResources();
@@ -159,12 +194,284 @@ void vhLog( bool error, const char* fmt, ... );
 #define VRHI_LOG( fmt, ... ) vhLog( false, fmt, ##__VA_ARGS__ )
 #define VRHI_ERR( fmt, ... ) vhLog( true, fmt, ##__VA_ARGS__ )
 
+// Command Arena
+// VIDL command records are bump-allocated from a per-producer-thread arena instead of the heap. Every record is prefixed
+// by a header pointing back at its block; each block is refcounted by its live records plus one reference held by the
+// owning thread. Once the backend has released every record in a retired block, the owner rewinds and reuses it. Blocks
+// still in flight when the owning thread exits are freed by whichever side drops the last reference.
+struct alignas( 16 ) vhCmdArenaBlock
+{
+    std::atomic< uint32_t > refs = 1;
+    uint64_t capacity = 0;
+    uint64_t used = 0;
+};
+
+struct vhCmdArena
+{
+    static constexpr uint64_t kBlockSize = 64 * 1024;
+    static constexpr uint64_t kAlignment = 16;
+
+    vhCmdArenaBlock* current = nullptr;
+    std::vector< vhCmdArenaBlock* > retired;
+
+    void* alloc( uint64_t size );
+    ~vhCmdArena();
+};
+extern thread_local vhCmdArena g_vhCmdArena;
+void vhCmdArenaFree( void* cmd );
+
 // Command function templates
 template< typename T, typename... Args >
-T* vhCmdAlloc( Args&&... args ) { return new T( std::forward<Args>(args)... ); }
+T* vhCmdAlloc( Args&&... args )
+{
+    static_assert( alignof( T ) <= vhCmdArena::kAlignment, "VIDL command records must fit the command arena alignment." );
+    return new ( g_vhCmdArena.alloc( sizeof( T ) ) ) T( std::forward<Args>(args)... );
+}
+
+// Like vhCmdAlloc(), with |tailBytes| of variable-length payload placed directly after the record, see vhCmdTail().
+template< typename T, typename... Args >
+T* vhCmdAllocTail( uint64_t tailBytes, Args&&... args )
+{
+    static_assert( alignof( T ) <= vhCmdArena::kAlignment, "VIDL command records must fit the command arena alignment." );
+    static_assert( std::is_trivially_destructible_v< T >, "Records with a tail are released without running a destructor." );
+    return new ( g_vhCmdArena.alloc( sizeof( T ) + tailBytes ) ) T( std::forward<Args>(args)... );
+}
+
+template< typename T >
+uint8_t* vhCmdTail( T* cmd ) { return reinterpret_cast< uint8_t* >( cmd + 1 ); }
+
+template< typename T >
+void vhCmdRelease( T* cmd )
+{
+    if ( !cmd ) return;
+    if constexpr ( !std::is_trivially_destructible_v< T > ) cmd->~T();
+    vhCmdArenaFree( cmd );
+}
+
+// Command Batching
+// Commands are buffered per producer thread and published to the backend with a single bulk enqueue once the batch
+// reaches |g_vhInit.commandBatchSize|, on vhPublishCommands(), on any flush, or when the thread exits.
+struct vhCmdBatch
+{
+    static constexpr uint32_t kMaxCommands = 256;
+
+    void* cmds[kMaxCommands];
+    uint32_t count = 0;
+
+    void publish();
+    ~vhCmdBatch();
+};
+extern thread_local vhCmdBatch g_vhCmdBatch;
+
+// Snapshot Publication
+// Object metadata served by the query fastpath is published by the backend thread as immutable snapshots, so queries
+// never take backendMutex. A reader pins the current epoch in a per-thread slot for as long as it takes to copy a
+// snapshot out. The publisher frees a replaced snapshot only once every pinned reader has moved past the epoch it was
+// retired in. There is a single publisher (the backend thread, or init / shutdown while it isn't running).
+struct vhSnapshotReaderSlot
+{
+    alignas( 64 ) std::atomic< uint64_t > epoch = 0; // 0 while the owning thread isn't reading.
+    std::atomic< bool > owned = false;
+};
+
+struct vhSnapshotReadGuard
+{
+    vhSnapshotReaderSlot* slot = nullptr;
+    bool nested = false;
+
+    vhSnapshotReadGuard();
+    ~vhSnapshotReadGuard();
+};
+
+uint64_t vhSnapshotAdvanceEpoch();
+uint64_t vhSnapshotOldestReader(); // Oldest epoch pinned by a reader, or UINT64_MAX if none are reading.
+
+struct vhSnapshotRetireList
+{
+    struct Entry
+    {
+        uint64_t epoch;
+        const void* ptr;
+        void ( *destroy )( const void* );
+    };
+    std::vector< Entry > entries;
+
+    // |ptr| must already be unreachable from every published table.
+    template< typename T >
+    void retire( const T* ptr )
+    {
+        if ( !ptr ) return;
+        entries.push_back( { vhSnapshotAdvanceEpoch(), ptr, []( const void* p ) { delete static_cast< const T* >( p ); } } );
+        reclaim();
+    }
+
+    void reclaim()
+    {
+        if ( entries.empty() ) return;
+        uint64_t oldest = vhSnapshotOldestReader();
+        std::erase_if( entries, [oldest]( const Entry& e )
+        {
+            if ( e.epoch > oldest ) return false;
+            e.destroy( e.ptr );
+            return true;
+        } );
+    }
+
+    void purge()
+    {
+        for ( auto& e : entries ) e.destroy( e.ptr );
+        entries.clear();
+    }
+
+    ~vhSnapshotRetireList() { purge(); }
+};
+
+// Snapshots indexed by object handle.
+template< typename T >
+class vhSnapshotTable
+{
+    struct Node
+    {
+        uint32_t handle;
+        T value;
+    };
+
+    struct Array
+    {
+        size_t size = 0;
+        std::unique_ptr< std::atomic< const Node* >[] > nodes;
+    };
+
+    std::atomic< const Array* > m_array = nullptr;
+    vhSnapshotRetireList m_retired;
+
+public:
+    ~vhSnapshotTable() { clear(); }
+
+    // Publisher only. Replaces the snapshot for |handle|.
+    void publish( uint32_t handle, T value )
+    {
+        uint32_t idx = vhHandleIndex( handle );
+        const Array* array = m_array.load( std::memory_order_relaxed );
+        if ( !array || idx >= array->size )
+        {
+            auto grown = new Array();
+            grown->size = std::max< size_t >( idx + 1, array ? array->size * 2 : 64 );
+            grown->nodes = std::make_unique< std::atomic< const Node* >[] >( grown->size );
+            for ( size_t i = 0; i < grown->size; i++ )
+            {
+                grown->nodes[i].store( array && i < array->size ? array->nodes[i].load( std::memory_order_relaxed ) : nullptr, std::memory_order_relaxed );
+            }
+            m_array.store( grown );
+            m_retired.retire( array );
+            array = grown;
+        }
+        m_retired.retire( array->nodes[idx].exchange( new Node { handle, std::move( value ) } ) );
+    }
+
+    // Publisher only.
+    void remove( uint32_t handle )
+    {
+        uint32_t idx = vhHandleIndex( handle );
+        const Array* array = m_array.load( std::memory_order_relaxed );
+        if ( !array || idx >= array->size ) return;
+        const Node* node = array->nodes[idx].load( std::memory_order_relaxed );
+        if ( !node || node->handle != handle ) return;
+        m_retired.retire( array->nodes[idx].exchange( nullptr ) );
+    }
+
+    // Publisher only, and only while no reader can be active (shutdown).
+    void clear()
+    {
+        const Array* array = m_array.exchange( nullptr );
+        if ( array )
+        {
+            for ( size_t i = 0; i < array->size; i++ ) delete array->nodes[i].load( std::memory_order_relaxed );
+            delete array;
+        }
+        m_retired.purge();
+    }
+
+    // Any thread. Calls |fn| with the snapshot for |handle| and returns true, or returns false if there is none.
+    // |fn| runs inside the read-side critical section and should only copy data out.
+    template< typename F >
+    bool read( uint32_t handle, F&& fn ) const
+    {
+        vhSnapshotReadGuard guard;
+        uint32_t idx = vhHandleIndex( handle );
+        const Array* array = m_array.load();
+        if ( handle == VRHI_INVALID_HANDLE || !array || idx >= array->size ) return false;
+        const Node* node = array->nodes[idx].load();
+        if ( !node || node->handle != handle ) return false;
+        fn( node->value );
+        return true;
+    }
+};
 
+// Snapshots keyed by a sparse 64-bit ID. The key index is republished whenever a new key shows up; each key owns a
+// stable cell holding its current snapshot. Keys are never removed before clear().
 template< typename T >
-void vhCmdRelease( T* cmd ) { if (cmd) delete cmd; }
+class vhSnapshotMap
+{
+    struct Cell
+    {
+        std::atomic< const T* > value = nullptr;
+    };
+    typedef std::unordered_map< uint64_t, Cell* > Index;
+
+    std::atomic< const Index* > m_index = nullptr;
+    std::vector< std::unique_ptr< Cell > > m_cells;
+    vhSnapshotRetireList m_retired;
+
+public:
+    ~vhSnapshotMap() { clear(); }
+
+    // Publisher only. Replaces the snapshot for |key|.
+    void publish( uint64_t key, T value )
+    {
+        const Index* index = m_index.load( std::memory_order_relaxed );
+        auto it = index ? index->find( key ) : typename Index::const_iterator();
+        Cell* cell = nullptr;
+        if ( index && it != index->end() )
+        {
+            cell = it->second;
+        }
+        else
+        {
+            m_cells.push_back( std::make_unique< Cell >() );
+            cell = m_cells.back().get();
+            auto grown = index ? new Index( *index ) : new Index();
+            ( *grown )[key] = cell;
+            m_index.store( grown );
+            m_retired.retire( index );
+        }
+        m_retired.retire( cell->value.exchange( new T( std::move( value ) ) ) );
+    }
+
+    // Publisher only, and only while no reader can be active (shutdown).
+    void clear()
+    {
+        delete m_index.exchange( nullptr );
+        for ( auto& cell : m_cells ) delete cell->value.load( std::memory_order_relaxed );
+        m_cells.clear();
+        m_retired.purge();
+    }
+
+    // Any thread. Same contract as vhSnapshotTable::read().
+    template< typename F >
+    bool read( uint64_t key, F&& fn ) const
+    {
+        vhSnapshotReadGuard guard;
+        const Index* index = m_index.load();
+        if ( !index ) return false;
+        auto it = index->find( key );
+        if ( it == index->end() ) return false;
+        const T* value = it->second->value.load();
+        if ( !value ) return false;
+        fn( *value );
+        return true;
+    }
+};
 
 void vhCmdEnqueue( void* cmd );
 void vhCmdListFlushAll();
@@ -173,7 +480,26 @@ void vhCmdListFlushTransferIfNeeded();
 // Command Lists
 extern nvrhi::CommandListHandle g_vhCmdLists[(uint64_t) nvrhi::CommandQueue::Count];
 nvrhi::CommandListHandle vhCmdListGet( nvrhi::CommandQueue type = nvrhi::CommandQueue::Graphics );
-void vhCmdListFlush( nvrhi::CommandQueue type = nvrhi::CommandQueue::Graphics ); // This will automatically flush the dependent queues.
+void vhCmdListFlush( nvrhi::CommandQueue type = nvrhi::CommandQueue::Graphics ); // This will automatically flush the copy queue first.
+
+// Command list submission tracking, used to order work across queues.
+// Every queue counts its submissions; the count doubles as the serial of the command list currently being recorded.
+uint64_t vhCmdListOpenSerial( nvrhi::CommandQueue type );
+bool vhCmdListSerialComplete( nvrhi::CommandQueue type, uint64_t serial ); // True once the GPU has finished that submission.
+void vhCmdListWaitForSerial( nvrhi::CommandQueue waitQueue, nvrhi::CommandQueue executionQueue, uint64_t serial ); // |serial| must already be submitted.
+void vhCmdListWaitSerialComplete( nvrhi::CommandQueue type, uint64_t serial ); // Blocks the CPU until |serial| has completed, submitting it first if needed.
+void vhCmdListResetSubmissions(); // Also releases pooled command lists, so call it before destroying the device.
+
+// Draw Encoders
+// Draws recorded by vhSubmit(). vhEndEncoder() hands them to the backend as a single record.
+struct vhEncoder
+{
+    std::vector< vhDraw > draws;
+};
+
+// Stable LSD radix sort of |keys| along with |values|. |tempKeys| and |tempValues| are scratch of |count| entries.
+// Byte passes where every key has the same digit are skipped, so keys that only use a few bits sort faster.
+void vhRadixSort64( uint64_t* keys, uint32_t* values, uint64_t* tempKeys, uint32_t* tempValues, size_t count );
 
 struct vhVertexLayoutDef
 {
@@ -186,9 +512,11 @@ struct vhVertexLayoutDef
 bool vhParseVertexLayoutInternal( const vhVertexLayout& layout, std::vector< vhVertexLayoutDef >& outDefs );
 int vhVertexLayoutDefSize( const vhVertexLayoutDef& def );
 int vhVertexLayoutDefSize( const std::vector< vhVertexLayoutDef >& def );
+nvrhi::Format vhVertexLayoutDefFormat( const vhVertexLayoutDef& def );
 int64_t vhGetRegionDataSize( const vhFormatInfo& info, glm::ivec3 extent, int mipLevel = 0 );
 bool vhVerifyRegionInTexture( const vhFormatInfo& fmt, glm::ivec3 mipDimensions, glm::ivec3 offset, glm::ivec3 extent, const char* debugName );
 nvrhi::SamplerDesc vhGetSamplerDesc( uint64_t samplerFlags );
+bool vhApplyStateBlock( vhState& state, uint64_t dirty, const uint8_t* data, uint64_t size );
 bool vhReflectSpirv(
     const std::vector< uint32_t >& spirvBlob,
     nvrhi::BindingLayoutDesc& outDesc,
@@ -199,7 +527,9 @@ bool vhReflectSpirv(
 uint64_t vhHashGraphicsPipeline( const nvrhi::GraphicsPipelineDesc& desc, const nvrhi::FramebufferInfo& fbInfo );
 uint64_t vhHashComputePipeline( const nvrhi::ComputePipelineDesc& desc );
 uint64_t vhHashBindingLayout( const nvrhi::BindingLayoutDesc& desc );
-uint64_t vhHashShaderBytecode( nvrhi::ShaderHandle shader );
+uint64_t vhHashBindingSet( const nvrhi::BindingSetDesc& desc, nvrhi::IBindingLayout* layout );
+uint64_t vhHashShaderBytecode( nvrhi::ShaderHandle shader ); // Covers the stage and entry point too.
+bool vhShaderMatches( nvrhi::IShader* a, nvrhi::IShader* b ); // Same bytecode, stage and entry point.
 uint64_t vhHashInputLayout( nvrhi::InputLayoutHandle layout );
 nvrhi::PrimitiveType vhTranslatePrimitiveType( uint64_t stateFlags );
 nvrhi::BlendState vhTranslateBlendState( uint64_t stateFlags );
@@ -255,18 +585,11 @@ uint32_t g_QueueFamilyTransfer = (uint32_t)-1;
 
 // # Graphics Resource Objects
 
-vhAllocatorObjectFreeList g_vhTextureIDList( 256 );
-std::unordered_map< vhTexture, bool > g_vhTextureIDValid;
-std::mutex g_vhTextureIDListMutex;
-
-vhAllocatorObjectFreeList g_vhBufferIDList( 256 );
-std::unordered_map< vhBuffer, bool > g_vhBufferIDValid;
-std::mutex g_vhBufferIDListMutex;
+vhHandleAllocator g_vhTextureIDList;
+vhHandleAllocator g_vhBufferIDList;
 
 // Shader
-vhAllocatorObjectFreeList g_vhShaderIDList( 256 );
-std::unordered_map< vhShader, bool > g_vhShaderIDValid;
-std::mutex g_vhShaderIDListMutex;
+vhHandleAllocator g_vhShaderIDList;
 
 
 bool g_vhRayTracingEnabled = false;
@@ -279,6 +602,18 @@ std::thread g_vhCmdThread;
 std::atomic<bool> g_vhCmdThreadReady = false;
 std::vector< vhMem* > g_vhMemList;
 std::mutex g_vhMemListMutex;
+std::atomic< uint64_t > g_vhFlushTicketIssued = 0;
+std::atomic< uint64_t > g_vhQueueTokenIssued = 0;
+std::atomic< uint64_t > g_vhFlushTicketCompleted = 0;
+std::atomic< uint64_t > g_vhReadbackTicketIssued = 0;
+std::atomic< uint64_t > g_vhReadbackTicketCompleted = 0;
+std::atomic< bool > g_vhReadbackPollPending = false;
+std::atomic< uint64_t > g_vhBufferResizeBytesCopied = 0;
+std::atomic< uint64_t > g_vhStateBytesEnqueued = 0;
+std::atomic< uint64_t > g_vhCmdListsCreated = 0;
+std::atomic< uint64_t > g_vhCmdListsReused = 0;
+std::atomic< uint64_t > g_vhFrameIndex = 0;
+std::atomic< uint32_t > g_vhFrameEncoders = 0;
 
 // Vulkan HPP Storage
 VULKAN_HPP_DEFAULT_DISPATCH_LOADER_DYNAMIC_STORAGE
@@ -300,27 +635,283 @@ void vhLog( bool error, const char* fmt, ... )
         printf( "%s", buffer );
 }
 
-void vhCmdEnqueue( void* cmd )
+// # Command Arena
+
+thread_local vhCmdArena g_vhCmdArena;
+
+struct alignas( vhCmdArena::kAlignment ) vhCmdArenaHeader
+{
+    vhCmdArenaBlock* block;
+};
+
+static uint8_t* vhCmdArenaBlockData( vhCmdArenaBlock* block )
+{
+    return reinterpret_cast< uint8_t* >( block + 1 );
+}
+
+static void vhCmdArenaBlockUnref( vhCmdArenaBlock* block )
+{
+    if ( block->refs.fetch_sub( 1, std::memory_order_acq_rel ) == 1 )
+    {
+        block->~vhCmdArenaBlock();
+        ::operator delete( block, std::align_val_t( vhCmdArena::kAlignment ) );
+    }
+}
+
+void* vhCmdArena::alloc( uint64_t size )
+{
+    uint64_t total = sizeof( vhCmdArenaHeader ) + ( ( size + kAlignment - 1 ) & ~( kAlignment - 1 ) );
+
+    if ( !current || current->used + total > current->capacity )
+    {
+        if ( current )
+        {
+            // Oversized blocks are one-offs; hand them to the backend to free rather than keeping them around.
+            if ( current->capacity > kBlockSize ) vhCmdArenaBlockUnref( current );
+            else retired.push_back( current );
+            current = nullptr;
+        }
+
+        // Reuse a retired block once the backend has released every record in it.
+        for ( size_t i = 0; i < retired.size(); i++ )
+        {
+            if ( retired[i]->capacity < total || retired[i]->refs.load( std::memory_order_acquire ) != 1 ) continue;
+            current = retired[i];
+            current->used = 0;
+            retired[i] = retired.back();
+            retired.pop_back();
+            break;
+        }
+
+        if ( !current )
+        {
+            uint64_t capacity = std::max( kBlockSize, total );
+            void* mem = ::operator new( sizeof( vhCmdArenaBlock ) + capacity, std::align_val_t( kAlignment ) );
+            current = new ( mem ) vhCmdArenaBlock();
+            current->capacity = capacity;
+        }
+    }
+
+    auto header = reinterpret_cast< vhCmdArenaHeader* >( vhCmdArenaBlockData( current ) + current->used );
+    header->block = current;
+    current->used += total;
+    current->refs.fetch_add( 1, std::memory_order_relaxed );
+    return header + 1;
+}
+
+vhCmdArena::~vhCmdArena()
+{
+    if ( current ) vhCmdArenaBlockUnref( current );
+    for ( auto block : retired ) vhCmdArenaBlockUnref( block );
+    current = nullptr;
+    retired.clear();
+}
+
+void vhCmdArenaFree( void* cmd )
 {
+    auto header = reinterpret_cast< vhCmdArenaHeader* >( cmd ) - 1;
+    vhCmdArenaBlockUnref( header->block );
+}
+
+// # Command Batching
+
+thread_local vhCmdBatch g_vhCmdBatch;
+
+void vhCmdBatch::publish()
+{
+    if ( !count ) return;
     for ( int i = 0; i < 128; i++ )
     {
-        if ( g_vhCmds.try_enqueue( cmd ) ) return;
+        if ( g_vhCmds.try_enqueue_bulk( cmds, count ) ) { count = 0; return; }
         std::this_thread::yield();
     }
-    g_vhCmds.enqueue( cmd );
+    g_vhCmds.enqueue_bulk( cmds, count );
+    count = 0;
+}
+
+vhCmdBatch::~vhCmdBatch()
+{
+    publish();
+}
+
+void vhCmdEnqueue( void* cmd )
+{
+    g_vhCmdBatch.cmds[g_vhCmdBatch.count++] = cmd;
+    uint32_t threshold = ( uint32_t ) std::clamp( g_vhInit.commandBatchSize, 1, ( int ) vhCmdBatch::kMaxCommands );
+    if ( g_vhCmdBatch.count >= threshold ) g_vhCmdBatch.publish();
+}
+
+void vhPublishCommands()
+{
+    g_vhCmdBatch.publish();
+}
+
+// # Snapshot Publication
+
+static constexpr uint32_t kVhSnapshotMaxReaders = 256;
+static vhSnapshotReaderSlot s_vhSnapshotReaders[kVhSnapshotMaxReaders];
+static std::atomic< uint32_t > s_vhSnapshotReaderCount = 0; // High-water mark of claimed slots.
+static std::atomic< uint64_t > s_vhSnapshotEpoch = 1;
+
+// Claims a reader slot for the calling thread on first use and hands it back when the thread exits.
+struct vhSnapshotReaderSlotOwner
+{
+    vhSnapshotReaderSlot* slot = nullptr;
+
+    vhSnapshotReaderSlot* get()
+    {
+        while ( !slot )
+        {
+            for ( uint32_t i = 0; i < kVhSnapshotMaxReaders && !slot; i++ )
+            {
+                bool expected = false;
+                if ( s_vhSnapshotReaders[i].owned.compare_exchange_strong( expected, true ) )
+                {
+                    slot = &s_vhSnapshotReaders[i];
+                    uint32_t count = s_vhSnapshotReaderCount.load();
+                    while ( count < i + 1 && !s_vhSnapshotReaderCount.compare_exchange_weak( count, i + 1 ) ) {}
+                }
+            }
+            if ( !slot ) std::this_thread::yield(); // Every slot is taken; wait for a reader thread to exit.
+        }
+        return slot;
+    }
+
+    ~vhSnapshotReaderSlotOwner()
+    {
+        if ( slot ) slot->owned.store( false );
+    }
+};
+static thread_local vhSnapshotReaderSlotOwner t_vhSnapshotReaderSlot;
+
+vhSnapshotReadGuard::vhSnapshotReadGuard()
+{
+    slot = t_vhSnapshotReaderSlot.get();
+    nested = slot->epoch.load( std::memory_order_relaxed ) != 0;
+    if ( !nested ) slot->epoch.store( s_vhSnapshotEpoch.load() );
+}
+
+vhSnapshotReadGuard::~vhSnapshotReadGuard()
+{
+    if ( !nested ) slot->epoch.store( 0, std::memory_order_release );
+}
+
+uint64_t vhSnapshotAdvanceEpoch()
+{
+    return s_vhSnapshotEpoch.fetch_add( 1 ) + 1;
+}
+
+uint64_t vhSnapshotOldestReader()
+{
+    uint64_t oldest = UINT64_MAX;
+    uint32_t count = s_vhSnapshotReaderCount.load();
+    for ( uint32_t i = 0; i < count; i++ )
+    {
+        uint64_t epoch = s_vhSnapshotReaders[i].epoch.load();
+        if ( epoch ) oldest = std::min( oldest, epoch );
+    }
+    return oldest;
 }
 
 nvrhi::CommandListHandle g_vhCmdLists[(uint64_t) nvrhi::CommandQueue::Count] = { nullptr, nullptr, nullptr };
 uint64_t g_vhCmdListTransferSizeHeuristic = 0;
 
+// # Command List Submissions
+
+struct vhCmdListSubmissions
+{
+    static constexpr uint64_t kHistory = 256;
+
+    uint64_t serial = 0;
+    uint64_t instances[kHistory] = {}; // NVRHI instance of submission |serial|, indexed by serial % kHistory.
+    uint64_t pendingWaits[( uint64_t ) nvrhi::CommandQueue::Count] = {}; // Instances of other queues to wait for before the next submit.
+};
+static vhCmdListSubmissions s_vhCmdListSubmissions[( uint64_t ) nvrhi::CommandQueue::Count];
+
+// # Command List Pool
+// Executed command lists are parked here with the serial they were submitted under, and reopened by vhCmdListGet()
+// once that submission has retired. Oldest first, so only the front entry ever needs checking.
+
+struct vhCmdListPooled
+{
+    uint64_t serial = 0;
+    nvrhi::CommandListHandle cmdlist;
+};
+static constexpr size_t kVhCmdListPoolMax = 8;
+static std::deque< vhCmdListPooled > s_vhCmdListPool[( uint64_t ) nvrhi::CommandQueue::Count];
+
+// Instance of an already submitted |serial|. Serials older than the history map to the oldest remembered submission,
+// which is conservative: that submission can only complete after the one asked about.
+static uint64_t vhCmdListSerialInstance( nvrhi::CommandQueue type, uint64_t serial )
+{
+    auto& subs = s_vhCmdListSubmissions[( uint64_t ) type];
+    assert( serial < subs.serial );
+    if ( subs.serial - serial > vhCmdListSubmissions::kHistory ) serial = subs.serial - vhCmdListSubmissions::kHistory;
+    return subs.instances[serial % vhCmdListSubmissions::kHistory];
+}
+
+uint64_t vhCmdListOpenSerial( nvrhi::CommandQueue type )
+{
+    return s_vhCmdListSubmissions[( uint64_t ) type].serial;
+}
+
+bool vhCmdListSerialComplete( nvrhi::CommandQueue type, uint64_t serial )
+{
+    if ( serial >= vhCmdListOpenSerial( type ) ) return false;
+    uint64_t instance = vhCmdListSerialInstance( type, serial );
+    std::lock_guard<std::mutex> lock( g_nvRHIStateMutex );
+    auto device = static_cast< nvrhi::vulkan::IDevice* >( g_vhDevice.Get() );
+    return device->queueGetCompletedInstance( type ) >= instance;
+}
+
+void vhCmdListWaitForSerial( nvrhi::CommandQueue waitQueue, nvrhi::CommandQueue executionQueue, uint64_t serial )
+{
+    uint64_t& pending = s_vhCmdListSubmissions[( uint64_t ) waitQueue].pendingWaits[( uint64_t ) executionQueue];
+    pending = std::max( pending, vhCmdListSerialInstance( executionQueue, serial ) );
+}
+
+void vhCmdListWaitSerialComplete( nvrhi::CommandQueue type, uint64_t serial )
+{
+    if ( serial >= vhCmdListOpenSerial( type ) ) vhCmdListFlush( type );
+    if ( serial >= vhCmdListOpenSerial( type ) ) return; // Nothing was recorded under that serial.
+
+    uint64_t instance = vhCmdListSerialInstance( type, serial );
+    VkSemaphore semaphore = VK_NULL_HANDLE;
+    {
+        std::lock_guard<std::mutex> lock( g_nvRHIStateMutex );
+        semaphore = static_cast< nvrhi::vulkan::IDevice* >( g_vhDevice.Get() )->getQueueSemaphore( type );
+    }
+    VkSemaphoreWaitInfo waitInfo = { .sType = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO, .semaphoreCount = 1, .pSemaphores = &semaphore, .pValues = &instance };
+    vkWaitSemaphores( g_vulkanDevice, &waitInfo, UINT64_MAX );
+}
+
+void vhCmdListResetSubmissions()
+{
+    for ( auto& subs : s_vhCmdListSubmissions ) subs = vhCmdListSubmissions();
+    for ( auto& pool : s_vhCmdListPool ) pool.clear();
+}
+
 nvrhi::CommandListHandle vhCmdListGet( nvrhi::CommandQueue type )
 {
     auto typeIdx = ( uint64_t ) type;
     if ( !g_vhCmdLists[typeIdx] )
     {
+        // vhCmdListSerialComplete() takes g_nvRHIStateMutex itself, so check the pool before locking.
+        auto& pool = s_vhCmdListPool[typeIdx];
+        if ( !pool.empty() && vhCmdListSerialComplete( type, pool.front().serial ) )
+        {
+            g_vhCmdLists[typeIdx] = std::move( pool.front().cmdlist );
+            pool.pop_front();
+            g_vhCmdListsReused++;
+        }
+
         std::lock_guard<std::mutex> lock( g_nvRHIStateMutex );
-        nvrhi::CommandListParameters params = { .queueType = ( nvrhi::CommandQueue ) type };
-        g_vhCmdLists[typeIdx] = g_vhDevice->createCommandList( params );
+        if ( !g_vhCmdLists[typeIdx] )
+        {
+            nvrhi::CommandListParameters params = { .queueType = ( nvrhi::CommandQueue ) type };
+            g_vhCmdLists[typeIdx] = g_vhDevice->createCommandList( params );
+            g_vhCmdListsCreated++;
+        }
         g_vhCmdLists[typeIdx]->open();
     }
     return g_vhCmdLists[typeIdx];
@@ -329,7 +920,7 @@ nvrhi::CommandListHandle vhCmdListGet( nvrhi::CommandQueue type )
 // Returns the instance ID of the executed command list.
 // Automatically inserts semaphore waits for downstream queues:
 // - Copy feeds Compute and Graphics
-// - Compute feeds Graphics
+// Waits between Compute and Graphics are explicit, see vhCmdListWaitForSerial().
 //
 void vhCmdListFlush_SingleQueueInternal( nvrhi::CommandQueue type )
 {
@@ -340,25 +931,37 @@ void vhCmdListFlush_SingleQueueInternal( nvrhi::CommandQueue type )
     {
         std::lock_guard<std::mutex> lock( g_nvRHIStateMutex );
         g_vhCmdLists[typeIdx]->close();
+
+        // Upstream work this submission was recorded to depend on, see vhCmdListWaitForSerial().
+        auto& subs = s_vhCmdListSubmissions[typeIdx];
+        for ( uint64_t other = 0; other < ( uint64_t ) nvrhi::CommandQueue::Count; other++ )
+        {
+            if ( !subs.pendingWaits[other] ) continue;
+            g_vhDevice->queueWaitForCommandList( type, ( nvrhi::CommandQueue ) other, subs.pendingWaits[other] );
+            subs.pendingWaits[other] = 0;
+        }
         
         // Execute and get the instance ID for synchronisation
         instance = g_vhDevice->executeCommandList( g_vhCmdLists[typeIdx], type );
+
+        // Park the list until this submission retires. Past the cap, drop the oldest; NVRHI keeps its in-flight
+        // command buffers alive on its own.
+        auto& pool = s_vhCmdListPool[typeIdx];
+        pool.push_back( { subs.serial, std::move( g_vhCmdLists[typeIdx] ) } );
+        if ( pool.size() > kVhCmdListPoolMax ) pool.pop_front();
         g_vhCmdLists[typeIdx] = nullptr;
+        subs.instances[subs.serial % vhCmdListSubmissions::kHistory] = instance;
+        subs.serial++;
         
         // Automatic Synchronisation
         if ( instance )
         {
             if ( type == nvrhi::CommandQueue::Copy )
             {
-                // Copy feeds Compute and Graphics
+                // Copy feeds Compute and Graphics. Compute work is only waited on where a caller asks, see vhQueueWait().
                 g_vhDevice->queueWaitForCommandList( nvrhi::CommandQueue::Compute, nvrhi::CommandQueue::Copy, instance );
                 g_vhDevice->queueWaitForCommandList( nvrhi::CommandQueue::Graphics, nvrhi::CommandQueue::Copy, instance );
             }
-            else if ( type == nvrhi::CommandQueue::Compute )
-            {
-                // Compute feeds Graphics
-                g_vhDevice->queueWaitForCommandList( nvrhi::CommandQueue::Graphics, nvrhi::CommandQueue::Compute, instance );
-            }
         }
     }
 }
@@ -371,12 +974,6 @@ void vhCmdListFlush( nvrhi::CommandQueue type )
         vhCmdListFlush_SingleQueueInternal( nvrhi::CommandQueue::Copy );
     }
 
-    // Graphics depends on compute; flush compute first
-    if ( type == nvrhi::CommandQueue::Graphics )
-    {
-        vhCmdListFlush_SingleQueueInternal( nvrhi::CommandQueue::Compute );
-    }
-
     // Flush the requested queue
     vhCmdListFlush_SingleQueueInternal( type );
 }
@@ -33,6 +33,7 @@
 
 struct vhBackendTexture
 {
+    vhTexture id = VRHI_INVALID_HANDLE;
     std::string name;
     nvrhi::TextureHandle handle;
     vhTexInfo info;
@@ -40,19 +41,35 @@ struct vhBackendTexture
     int64_t arraySize;
     std::vector< vhTextureMipInfo > mipInfo;
     uint64_t flags = 0;
+    uint64_t graphicsUseSerial = UINT64_MAX; // Graphics submission that last used the texture, UINT64_MAX if none. See BE_UploadQueue().
+    uint64_t computeUseSerial = UINT64_MAX; // Async compute submission that last used the texture, see BE_WaitComputeUse().
 };
 
 struct vhBackendBuffer
 {
+    vhBuffer id = VRHI_INVALID_HANDLE;
     std::string name;
     nvrhi::BufferHandle handle;
-    nvrhi::BufferDesc desc;
+    nvrhi::BufferDesc desc; // desc.byteSize is the allocated capacity, see BE_ResizeBuffer().
+    uint64_t byteSize = 0; // Logical size, what callers see and what updates and reads are validated against.
     uint32_t stride = 0;
     uint64_t flags = 0;
+    uint64_t graphicsUseSerial = UINT64_MAX; // Graphics submission that last used the buffer, UINT64_MAX if none. See BE_UploadQueue().
+    uint64_t copyUseSerial = UINT64_MAX; // Copy submission that last wrote the buffer, UINT64_MAX if none.
+    uint64_t computeUseSerial = UINT64_MAX; // Async compute submission that last used the buffer, see BE_WaitComputeUse().
+    std::vector< vhVertexLayoutDef > vertexLayout; // Attributes of a vertex buffer, see BE_GetInputLayout().
+
+    // VRHI_BUFFER_POOLED buffers are a range of a shared page from backendBufferPools; |handle| is the page and every
+    // use of it has to add |poolOffset|. Both are 0 for dedicated buffers.
+    uint64_t poolKey = 0;
+    uint32_t poolPage = 0;
+    uint32_t poolBlock = 0;
+    uint64_t poolOffset = 0;
 };
 
 struct vhBackendShader
 {
+    vhShader id = VRHI_INVALID_HANDLE;
     std::string name;
     nvrhi::ShaderHandle handle;
     uint64_t flags;
@@ -69,6 +86,462 @@ struct vhBackendShader
     std::vector< vhSpecConstant > specConstants;
 };
 
+// Immutable copies of the metadata served by the query fastpath. See Snapshot Publication in vrhi_impl.h.
+struct vhTextureSnapshot
+{
+    vhTexInfo info;
+    std::vector< vhTextureMipInfo > mipInfo;
+    nvrhi::ITexture* handle = nullptr;
+};
+
+struct vhBufferSnapshot
+{
+    uint64_t byteSize = 0;
+    uint32_t stride = 0;
+    uint64_t flags = 0;
+    nvrhi::IBuffer* handle = nullptr;
+    uint64_t offset = 0;
+};
+
+struct vhShaderSnapshot
+{
+    glm::uvec3 threadGroupSize = { 0, 0, 0 };
+    std::vector< vhShaderReflectionResource > reflection;
+    std::vector< vhPushConstantRange > pushConstants;
+    std::vector< vhSpecConstant > specConstants;
+    nvrhi::IShader* handle = nullptr;
+};
+
+template< typename THandle >
+struct vhBackendPipeline
+{
+    THandle handle;
+    vhProgram shaders; // Shaders the pipeline was built from, so it can be evicted when any of them is destroyed.
+
+    // Stages the pipeline was built from (CS, or VS HS DS GS PS), compared on a hit so a key collision can't hand out
+    // the pipeline of another program.
+    std::array< nvrhi::ShaderHandle, 5 > stages;
+
+    bool matches( const std::array< nvrhi::ShaderHandle, 5 >& other ) const
+    {
+        for ( size_t i = 0; i < stages.size(); i++ ) if ( !vhShaderMatches( stages[i], other[i] ) ) return false;
+        return true;
+    }
+};
+
+// A vhState compiled by vhCreateStateBlock(). The state itself lives in backendStates with its names resolved to slots.
+// Pipelines are dropped when a shader of the program is destroyed, submits then fall back to the regular lookups.
+struct vhBackendStateBlock
+{
+    nvrhi::ComputePipelineHandle computePipeline;
+    nvrhi::GraphicsPipelineDesc graphicsDesc; // Render state and primitive type already translated from stateFlags.
+    nvrhi::GraphicsPipelineHandle graphicsPipeline; // Built against the state's own attachments, if it has any.
+    nvrhi::FramebufferInfo graphicsFramebufferInfo;
+    bool hasGraphics = false;
+};
+
+// Persistently mapped upload memory for the copy queue. Chunks are handed out front to back and tagged with the copy
+// submission that last read from them; a chunk goes back to the end of the ring once that submission has completed.
+// Uploads larger than a chunk get a dedicated buffer which is dropped on completion instead.
+struct vhStagingRing
+{
+    static constexpr uint64_t kChunkSize = 32 * 1024 * 1024;
+    // Covers optimalBufferCopyOffsetAlignment, and is a multiple of every texel block size, 12 byte RGB32 included.
+    static constexpr uint64_t kAlignment = 1536;
+
+    struct Chunk
+    {
+        nvrhi::BufferHandle buffer;
+        uint8_t* mapped = nullptr;
+        uint64_t size = 0;
+        uint64_t used = 0;
+        uint64_t copySerial = 0;
+    };
+
+    struct Allocation
+    {
+        nvrhi::IBuffer* buffer = nullptr;
+        uint8_t* mapped = nullptr;
+        uint64_t offset = 0;
+    };
+
+    std::deque< Chunk > chunks; // Oldest in flight at the front, chunk being filled at the back.
+    std::vector< Chunk > dedicated;
+
+    static bool createChunk( Chunk& chunk, uint64_t size )
+    {
+        auto desc = nvrhi::BufferDesc()
+            .setByteSize( size )
+            .setCpuAccess( nvrhi::CpuAccessMode::Write )
+            .setDebugName( "vhStagingRing" );
+        desc.keepInitialState = true;
+        desc.initialState = nvrhi::ResourceStates::CopySource;
+
+        std::lock_guard< std::mutex > lock( g_nvRHIStateMutex );
+        chunk.buffer = g_vhDevice->createBuffer( desc );
+        if ( !chunk.buffer ) return false;
+        chunk.mapped = ( uint8_t* ) g_vhDevice->mapBuffer( chunk.buffer, nvrhi::CpuAccessMode::Write );
+        chunk.size = size;
+        return chunk.mapped != nullptr;
+    }
+
+    static uint64_t align( uint64_t offset ) { return ( offset + kAlignment - 1 ) / kAlignment * kAlignment; }
+
+    static void destroyChunk( Chunk& chunk )
+    {
+        std::lock_guard< std::mutex > lock( g_nvRHIStateMutex );
+        if ( chunk.mapped ) g_vhDevice->unmapBuffer( chunk.buffer );
+        chunk = Chunk();
+    }
+
+    // Returns |size| bytes of staging memory that stays untouched until the currently open copy command list completes.
+    Allocation alloc( uint64_t size )
+    {
+        uint64_t copySerial = vhCmdListOpenSerial( nvrhi::CommandQueue::Copy );
+        std::erase_if( dedicated, [copySerial]( Chunk& chunk )
+        {
+            if ( chunk.copySerial == copySerial || !vhCmdListSerialComplete( nvrhi::CommandQueue::Copy, chunk.copySerial ) ) return false;
+            destroyChunk( chunk );
+            return true;
+        } );
+
+        if ( size > kChunkSize )
+        {
+            Chunk chunk;
+            if ( !createChunk( chunk, size ) ) return {};
+            chunk.copySerial = copySerial;
+            dedicated.push_back( chunk );
+            return { chunk.buffer, chunk.mapped, 0 };
+        }
+
+        uint64_t offset = chunks.empty() ? 0 : align( chunks.back().used );
+        if ( chunks.empty() || offset + size > chunks.back().size )
+        {
+            offset = 0;
+            if ( !chunks.empty() && chunks.front().copySerial != copySerial && vhCmdListSerialComplete( nvrhi::CommandQueue::Copy, chunks.front().copySerial ) )
+            {
+                chunks.push_back( std::move( chunks.front() ) );
+                chunks.pop_front();
+            }
+            else
+            {
+                Chunk chunk;
+                if ( !createChunk( chunk, kChunkSize ) ) return {};
+                chunks.push_back( std::move( chunk ) );
+            }
+        }
+
+        auto& chunk = chunks.back();
+        chunk.used = offset + size;
+        chunk.copySerial = copySerial;
+        return { chunk.buffer, chunk.mapped, offset };
+    }
+
+    void clear()
+    {
+        for ( auto& chunk : chunks ) destroyChunk( chunk );
+        for ( auto& chunk : dedicated ) destroyChunk( chunk );
+        chunks.clear();
+        dedicated.clear();
+    }
+};
+
+// Persistently mapped upload memory handed straight to callers, see vhMapTextureUpload(). Unlike vhStagingRing it is
+// allocated from any thread, so it has its own lock, and new chunks are created by whichever thread needs one.
+// A chunk is pinned by every mapping that hasn't been committed yet. Once it is full, the backend recycles it after
+// the last pin is gone and every submission that copied out of it has completed.
+struct vhUploadArena
+{
+    static constexpr uint64_t kChunkSize = 16 * 1024 * 1024;
+    static constexpr uint32_t kNoChunk = UINT32_MAX;
+
+    struct Chunk : vhStagingRing::Chunk
+    {
+        uint32_t pins = 0;
+        uint64_t serials[( uint64_t ) nvrhi::CommandQueue::Count] = {}; // One past the last submission per queue that read it.
+    };
+
+    std::mutex mutex;
+    std::vector< Chunk > chunks; // Indexed by vhUploadMapping::chunk. Slots of destroyed chunks are reused.
+    std::vector< uint32_t > freeChunks, retiringChunks, deadSlots;
+    uint32_t current = kNoChunk;
+
+    // Any thread. Returns |size| bytes of mapped memory, or nullptr if no chunk could be created.
+    uint8_t* map( uint64_t size, uint32_t& outChunk, uint64_t& outOffset )
+    {
+        std::lock_guard< std::mutex > lock( mutex );
+        uint64_t offset = current == kNoChunk ? 0 : vhStagingRing::align( chunks[current].used );
+        if ( current == kNoChunk || offset + size > chunks[current].size )
+        {
+            if ( current != kNoChunk ) retiringChunks.push_back( current );
+            current = kNoChunk;
+            offset = 0;
+            if ( size <= kChunkSize && !freeChunks.empty() )
+            {
+                current = freeChunks.back();
+                freeChunks.pop_back();
+            }
+            else
+            {
+                Chunk chunk;
+                if ( !vhStagingRing::createChunk( chunk, std::max( size, kChunkSize ) ) )
+                {
+                    vhStagingRing::destroyChunk( chunk );
+                    return nullptr;
+                }
+                if ( deadSlots.empty() )
+                {
+                    current = ( uint32_t ) chunks.size();
+                    chunks.push_back( std::move( chunk ) );
+                }
+                else
+                {
+                    current = deadSlots.back();
+                    deadSlots.pop_back();
+                    chunks[current] = std::move( chunk );
+                }
+            }
+        }
+
+        auto& chunk = chunks[current];
+        chunk.used = offset + size;
+        chunk.pins++;
+        outChunk = current;
+        outOffset = offset;
+        return chunk.mapped + offset;
+    }
+
+    // Backend thread. Where a mapping lives, for recording its copy.
+    vhStagingRing::Allocation lookup( uint32_t chunk, uint64_t offset )
+    {
+        std::lock_guard< std::mutex > lock( mutex );
+        if ( chunk >= chunks.size() || !chunks[chunk].buffer ) return {};
+        return { chunks[chunk].buffer, chunks[chunk].mapped, offset };
+    }
+
+    // Backend thread. Drops the pin of a committed mapping whose copy, if any, went into the open command list of |queue|.
+    void unpin( uint32_t chunk, nvrhi::CommandQueue queue )
+    {
+        uint64_t serial = queue < nvrhi::CommandQueue::Count ? vhCmdListOpenSerial( queue ) + 1 : 0;
+        std::lock_guard< std::mutex > lock( mutex );
+        if ( chunk >= chunks.size() || !chunks[chunk].pins ) return;
+        chunks[chunk].pins--;
+        if ( serial ) chunks[chunk].serials[( uint64_t ) queue] = std::max( chunks[chunk].serials[( uint64_t ) queue], serial );
+    }
+
+    // Backend thread. Recycles full chunks that nothing reads from anymore. Oversized chunks are freed instead.
+    void recycle()
+    {
+        std::lock_guard< std::mutex > lock( mutex );
+        std::erase_if( retiringChunks, [this]( uint32_t index )
+        {
+            auto& chunk = chunks[index];
+            if ( chunk.pins ) return false;
+            for ( uint64_t queue = 0; queue < ( uint64_t ) nvrhi::CommandQueue::Count; queue++ )
+            {
+                if ( chunk.serials[queue] && !vhCmdListSerialComplete( ( nvrhi::CommandQueue ) queue, chunk.serials[queue] - 1 ) ) return false;
+            }
+
+            if ( chunk.size > kChunkSize )
+            {
+                vhStagingRing::destroyChunk( chunk );
+                deadSlots.push_back( index );
+            }
+            else
+            {
+                freeChunks.push_back( index );
+            }
+            chunk.used = 0;
+            std::fill( std::begin( chunk.serials ), std::end( chunk.serials ), 0 );
+            return true;
+        } );
+    }
+
+    void clear()
+    {
+        std::lock_guard< std::mutex > lock( mutex );
+        for ( auto& chunk : chunks ) vhStagingRing::destroyChunk( chunk );
+        chunks.clear();
+        freeChunks.clear();
+        retiringChunks.clear();
+        deadSlots.clear();
+        current = kNoChunk;
+    }
+};
+
+// Shared backing buffers for VRHI_BUFFER_POOLED buffers of one kind, see vhBufferPoolKey(). Pages are sub-allocated
+// with vhAllocatorTLSF, so thousands of small buffers share a handful of VkBuffers and memory allocations.
+struct vhBufferPool
+{
+    static constexpr uint64_t kPageSize = 32 * 1024 * 1024;
+    static constexpr uint64_t kMaxPooledSize = kPageSize / 4; // Anything larger gets a dedicated buffer.
+
+    struct Page
+    {
+        nvrhi::BufferHandle buffer;
+        std::unique_ptr< vhAllocatorTLSF > allocator;
+    };
+
+    nvrhi::BufferDesc desc;
+    uint64_t alignment = 16;
+    std::vector< Page > pages;
+
+    // Finds room for |size| bytes, adding a page if none of the existing ones has it. Returns false if that fails.
+    bool alloc( uint64_t size, uint32_t& outPage, uint32_t& outBlock, uint64_t& outOffset )
+    {
+        for ( uint32_t page = 0; page < ( uint32_t ) pages.size(); page++ )
+        {
+            outBlock = pages[page].allocator->alloc( size, outOffset );
+            if ( outBlock == vhAllocatorTLSF::kInvalidBlock ) continue;
+            outPage = page;
+            return true;
+        }
+
+        Page page;
+        auto pageDesc = desc;
+        pageDesc.setByteSize( kPageSize ).setDebugName( "vhBufferPool" );
+        {
+            std::lock_guard< std::mutex > lock( g_nvRHIStateMutex );
+            page.buffer = g_vhDevice->createBuffer( pageDesc );
+        }
+        if ( !page.buffer ) return false;
+        page.allocator = std::make_unique< vhAllocatorTLSF >( kPageSize, alignment );
+        outBlock = page.allocator->alloc( size, outOffset );
+        if ( outBlock == vhAllocatorTLSF::kInvalidBlock ) return false;
+        outPage = ( uint32_t ) pages.size();
+        pages.push_back( std::move( page ) );
+        return true;
+    }
+};
+
+// Buffers sharing a vhBufferPool must agree on everything but their size.
+inline uint64_t vhBufferPoolKey( const nvrhi::BufferDesc& desc )
+{
+    return 1 | ( uint64_t ) desc.isVertexBuffer << 1 | ( uint64_t ) desc.isIndexBuffer << 2 | ( uint64_t ) desc.isConstantBuffer << 3
+        | ( uint64_t ) desc.canHaveTypedViews << 4 | ( uint64_t ) desc.canHaveRawViews << 5 | ( uint64_t ) desc.format << 8
+        | ( uint64_t ) desc.initialState << 32;
+}
+
+// A pooled range released by vhDestroyBuffer(), held until the GPU is done with it.
+struct vhPendingPoolRelease
+{
+    uint64_t poolKey = 0;
+    uint32_t page = 0;
+    uint32_t block = 0;
+    uint64_t graphicsSerial = UINT64_MAX;
+    uint64_t copySerial = UINT64_MAX;
+    uint64_t computeSerial = UINT64_MAX;
+};
+
+// Host-readable buffers for readbacks, recycled by power of two size once the caller has its data.
+struct vhReadbackPool
+{
+    static constexpr uint64_t kMinSize = 64 * 1024;
+    static constexpr size_t kMaxFreePerSize = 8;
+
+    std::unordered_map< uint64_t, std::vector< nvrhi::BufferHandle > > freeBuffers;
+
+    nvrhi::BufferHandle acquire( uint64_t size )
+    {
+        uint64_t bucket = std::max( kMinSize, std::bit_ceil( size ) );
+        auto& list = freeBuffers[bucket];
+        if ( !list.empty() )
+        {
+            nvrhi::BufferHandle buffer = list.back();
+            list.pop_back();
+            return buffer;
+        }
+
+        auto desc = nvrhi::BufferDesc()
+            .setByteSize( bucket )
+            .setCpuAccess( nvrhi::CpuAccessMode::Read )
+            .setDebugName( "vhReadbackPool" );
+        desc.keepInitialState = true;
+        desc.initialState = nvrhi::ResourceStates::CopyDest;
+
+        std::lock_guard< std::mutex > lock( g_nvRHIStateMutex );
+        return g_vhDevice->createBuffer( desc );
+    }
+
+    void release( nvrhi::BufferHandle buffer )
+    {
+        auto& list = freeBuffers[buffer->getDesc().byteSize];
+        if ( list.size() < kMaxFreePerSize ) list.push_back( buffer );
+    }
+};
+
+// A readback in flight on the graphics queue. |spans| scatter the readback buffer into |outData|.
+struct vhPendingReadback
+{
+    struct Span
+    {
+        uint64_t bufferOffset = 0;
+        uint64_t outOffset = 0;
+        uint64_t size = 0;
+    };
+
+    vhReadbackTicket ticket = 0;
+    uint64_t graphicsSerial = 0;
+    nvrhi::BufferHandle buffer;
+    std::vector< Span > spans;
+    uint64_t outSize = 0;
+    vhMem* outData = nullptr;
+};
+
+// Per-frame ring for vhState::constants and vhState::uniforms, one volatile constant buffer per shader slot. Every
+// submit writes its values into the next version of the buffer, which is a memcpy into persistently mapped memory
+// bound through a dynamic offset, so binding sets stay cached while the values change. NVRHI hands versions out
+// linearly and recycles each one once the submission that used it has completed.
+struct vhConstantRing
+{
+    static constexpr uint64_t kRingSize = 4 * 1024 * 1024; // Per slot, spread over the versions in flight.
+    static constexpr uint32_t kMinVersions = 64;
+    static constexpr uint32_t kMaxVersions = 4096;
+    static constexpr uint32_t kAlignment = 256;
+
+    std::unordered_map< uint64_t, nvrhi::BufferHandle > buffers; // Keyed by shader << 32 | slot.
+    std::vector< uint8_t > scratch;
+
+    static uint64_t key( vhShader shader, uint32_t slot ) { return ( uint64_t ) shader << 32 | slot; }
+
+    // Returns the volatile buffer behind |slot| of |shader|, creating it on first use.
+    nvrhi::IBuffer* get( vhShader shader, uint32_t slot, uint32_t size )
+    {
+        auto& buffer = buffers[key( shader, slot )];
+        if ( buffer ) return buffer;
+
+        uint32_t byteSize = std::max( ( size + kAlignment - 1 ) & ~( kAlignment - 1 ), kAlignment );
+        uint32_t versions = std::clamp( ( uint32_t ) ( kRingSize / byteSize ), kMinVersions, kMaxVersions );
+        auto desc = nvrhi::BufferDesc()
+            .setByteSize( byteSize )
+            .setIsConstantBuffer( true )
+            .setIsVolatile( true )
+            .setMaxVersions( versions )
+            .setDebugName( "vhConstantRing" );
+        std::lock_guard< std::mutex > lock( g_nvRHIStateMutex );
+        buffer = g_vhDevice->createBuffer( desc );
+        return buffer;
+    }
+
+    void release( vhShader shader )
+    {
+        std::erase_if( buffers, [shader]( const auto& entry ) { return ( entry.first >> 32 ) == shader; } );
+    }
+
+    void clear()
+    {
+        buffers.clear();
+        scratch.clear();
+    }
+};
+
+struct vhBackendBindingSet
+{
+    nvrhi::BindingSetHandle handle;
+    nvrhi::BindingLayoutHandle layout;
+    nvrhi::BindingSetDesc desc; // Kept to rule out hash collisions and to find the entries that reference a resource.
+};
+
 // --------------------------------------------------------------------------
 // Main Backend State
 // --------------------------------------------------------------------------
@@ -89,11 +562,104 @@ struct vhCmdBackendState : public VIDLHandler
 
     std::mutex backendMutex;
     char temps[1024];
-    std::map< vhTexture, std::unique_ptr< vhBackendTexture > > backendTextures;
-    std::map< vhBuffer, std::unique_ptr< vhBackendBuffer > > backendBuffers;
-    std::map< vhShader, std::unique_ptr< vhBackendShader > > backendShaders;
-    std::map< vhStateId, vhState > backendStates;
+    vhSlotTable< std::unique_ptr< vhBackendTexture > > backendTextures;
+    vhSlotTable< std::unique_ptr< vhBackendBuffer > > backendBuffers;
+    vhSlotTable< std::unique_ptr< vhBackendShader > > backendShaders;
+    std::unordered_map< vhStateId, vhState > backendStates; // State IDs are picked by the caller, so they aren't dense.
     std::unordered_map< uint64_t, nvrhi::FramebufferHandle > backendFramebuffers;
+    std::set< vhFlushTicket > flushTicketsOutOfOrder;
+    std::set< vhReadbackTicket > readbackTicketsOutOfOrder;
+
+    // Query fastpath snapshots. Textures, buffers and shaders are republished when created or resized; states are
+    // republished at the end of every command batch they were touched in.
+    vhSnapshotTable< vhTextureSnapshot > textureSnapshots;
+    vhSnapshotTable< vhBufferSnapshot > bufferSnapshots;
+    vhSnapshotTable< vhShaderSnapshot > shaderSnapshots;
+    vhSnapshotMap< vhState > stateSnapshots;
+    std::unordered_set< vhStateId > stateSnapshotsDirty;
+
+    // Immutable states created by vhCreateStateBlock().
+    std::unordered_map< vhStateId, vhBackendStateBlock > backendStateBlocks;
+
+    // Queue submissions behind each vhQueueToken, see vhQueueWait(). A batch can span queues, so there is a serial per
+    // queue, UINT64_MAX where it has none. Dropped once every submission has completed.
+    struct vhBackendQueueToken
+    {
+        uint64_t serials[( uint64_t ) nvrhi::CommandQueue::Count] = { UINT64_MAX, UINT64_MAX, UINT64_MAX };
+    };
+    std::unordered_map< vhQueueToken, vhBackendQueueToken > queueTokens;
+
+    // Draws of frames still waiting on encoders or on their vhFrame(), see BE_RecordFrames(). Encoders can arrive out
+    // of order from other threads, so a frame is complete once it has as many as vhFrame() counted.
+    struct vhBackendFrame
+    {
+        std::vector< vhDraw > draws;
+        uint32_t received = 0;
+        uint32_t expected = UINT32_MAX; // Unknown until vhFrame() arrives.
+    };
+    std::map< uint64_t, vhBackendFrame > pendingFrames;
+    uint64_t nextFrame = 0; // Frames are recorded in order, this is the next one due.
+    vhFrameStats frameStats;
+
+    // PSO caches, keyed by vhHashComputePipeline / vhHashGraphicsPipeline.
+    std::unordered_map< uint64_t, vhBackendPipeline< nvrhi::ComputePipelineHandle > > backendComputePipelines;
+    std::unordered_map< uint64_t, vhBackendPipeline< nvrhi::GraphicsPipelineHandle > > backendGraphicsPipelines;
+    uint64_t pipelineCacheHits = 0;
+    uint64_t pipelineCacheMisses = 0;
+
+    // Input layouts, keyed by a hash of their attributes. Few distinct vertex layouts exist, so these are never evicted.
+    std::unordered_map< uint64_t, nvrhi::InputLayoutHandle > backendInputLayouts;
+
+    // Binding set cache, keyed by vhHashBindingSet. Entries are evicted when a resource or layout they reference goes away.
+    std::unordered_map< uint64_t, vhBackendBindingSet > backendBindingSets;
+    uint64_t bindingSetCacheHits = 0;
+    uint64_t bindingSetCacheMisses = 0;
+
+    // Samplers, keyed by their VRHI_SAMPLER_* flags. There are few distinct ones, so they are never evicted.
+    std::unordered_map< uint64_t, nvrhi::SamplerHandle > backendSamplers;
+
+    // Scratch of BE_PreSubmitCommon(), kept to reuse its allocation.
+    std::unordered_map< uint32_t, bool > scratchSlotBindingFilled;
+
+    // A vhDispatchBatch() entry, resolved up front so the batch can be sorted.
+    struct vhBatchedDispatch
+    {
+        vhState* state;
+        vhBackendShader* shader;
+        const vhBackendStateBlock* block;
+        nvrhi::ComputePipelineHandle pipeline;
+        nvrhi::CommandQueue queue;
+        vhStateId stateID;
+        glm::uvec3 workGroupCount;
+    };
+
+    // Scratch of BE_DispatchBatch().
+    std::vector< vhBatchedDispatch > scratchDispatchBatch;
+
+    // Scratch of BE_GetInputLayout() and BE_PrepareDraw().
+    std::vector< nvrhi::VertexAttributeDesc > scratchVertexAttributes;
+    std::vector< vhBackendShader* > scratchDrawShaders;
+    std::vector< vhTexture > scratchDrawColours;
+
+    // Scratch of BE_RecordFrame(): the sort of a frame's draws, and the states whose attachments it has cleared.
+    std::vector< uint64_t > scratchFrameKeys, scratchFrameTempKeys;
+    std::vector< uint32_t > scratchFrameOrder, scratchFrameTempOrder;
+    std::unordered_set< vhStateId > scratchFrameCleared;
+
+    // Upload memory for the copy queue, see BE_UploadQueue().
+    vhStagingRing stagingRing;
+    vhUploadArena uploadArena;
+
+    // Per-draw constant buffer values, see BE_BindConstants().
+    vhConstantRing constantRing;
+
+    // Sub-allocated VRHI_BUFFER_POOLED buffers, keyed by vhBufferPoolKey().
+    std::unordered_map< uint64_t, vhBufferPool > backendBufferPools;
+    std::vector< vhPendingPoolRelease > pendingPoolReleases;
+
+    // Readbacks in submission order, see BE_RetireReadbacks().
+    vhReadbackPool readbackPool;
+    std::deque< vhPendingReadback > pendingReadbacks;
 
     // RAII for vhMem, takes ownership of the pointer and auto-destructs it.
     std::unique_ptr< vhMem > BE_MemRAII( const vhMem* mem )
@@ -146,6 +712,37 @@ struct vhCmdBackendState : public VIDLHandler
         return -1;
     }
 
+    inline bool BE_Util_IsBufferUAV( nvrhi::ResourceType type )
+    {
+        return type == nvrhi::ResourceType::StructuredBuffer_UAV || type == nvrhi::ResourceType::RawBuffer_UAV || type == nvrhi::ResourceType::TypedBuffer_UAV;
+    }
+
+    inline bool BE_Util_IsBufferSRV( nvrhi::ResourceType type )
+    {
+        return type == nvrhi::ResourceType::StructuredBuffer_SRV || type == nvrhi::ResourceType::RawBuffer_SRV || type == nvrhi::ResourceType::TypedBuffer_SRV;
+    }
+
+    // Finds the reflected buffer |binding| refers to. By name whatever its kind, otherwise by slot among the UAVs or the
+    // SRVs, as |uav| asks.
+    inline const vhShaderReflectionResource* BE_Util_FindBufferResource( const vhState::BufferBinding& binding, bool uav, vhBackendShader& shader )
+    {
+        for ( const auto& resource : shader.reflection )
+        {
+            bool isUAV = BE_Util_IsBufferUAV( resource.type );
+            if ( !isUAV && !BE_Util_IsBufferSRV( resource.type ) ) continue;
+            if ( binding.name ? resource.name == binding.name : ( resource.slot == ( uint32_t ) binding.slot && isUAV == uav ) ) return &resource;
+        }
+        return nullptr;
+    }
+
+    // Applies a per-slot vhSetState() update. |count| is the size of the table on the caller's side.
+    template< typename T >
+    inline void BE_Util_SetStateSlot( std::vector< T >& table, uint32_t idx, uint32_t count, const T& value )
+    {
+        table.resize( count );
+        if ( idx < count ) table[idx] = value;
+    }
+
     inline bool BE_Util_ShaderStageMatches( uint64_t flags, bool useCompute, bool useGraphics )
     {
         if ( ( flags & VRHI_SHADER_STAGE_COMPUTE ) && useCompute ) return true;
@@ -157,10 +754,142 @@ struct vhCmdBackendState : public VIDLHandler
     // Backend :: Complex BE Low Level NVRHI Device Functions
     // --------------------------------------------------------------------------
 
+    // Resources used by the graphics command list being recorded, see BE_UploadQueue().
+    // Marking a use on the graphics or compute queue also orders it after pending work on the other one, see
+    // BE_WaitComputeUse() and BE_WaitGraphicsUse().
+    void BE_MarkGraphicsUse( vhBackendTexture& btex )
+    {
+        BE_WaitComputeUse( btex.computeUseSerial, nvrhi::CommandQueue::Graphics );
+        btex.graphicsUseSerial = vhCmdListOpenSerial( nvrhi::CommandQueue::Graphics );
+    }
+    void BE_MarkGraphicsUse( vhBackendBuffer& bbuf )
+    {
+        BE_WaitComputeUse( bbuf.computeUseSerial, nvrhi::CommandQueue::Graphics );
+        bbuf.graphicsUseSerial = vhCmdListOpenSerial( nvrhi::CommandQueue::Graphics );
+    }
+    void BE_MarkCopyUse( vhBackendBuffer& bbuf ) { bbuf.copyUseSerial = vhCmdListOpenSerial( nvrhi::CommandQueue::Copy ); }
+    void BE_MarkComputeUse( vhBackendTexture& btex )
+    {
+        BE_WaitGraphicsUse( btex.graphicsUseSerial );
+        btex.computeUseSerial = vhCmdListOpenSerial( nvrhi::CommandQueue::Compute );
+    }
+    void BE_MarkComputeUse( vhBackendBuffer& bbuf )
+    {
+        BE_WaitGraphicsUse( bbuf.graphicsUseSerial );
+        bbuf.computeUseSerial = vhCmdListOpenSerial( nvrhi::CommandQueue::Compute );
+    }
+
+    template< typename T > void BE_MarkQueueUse( T& resource, nvrhi::CommandQueue queue )
+    {
+        if ( queue == nvrhi::CommandQueue::Compute ) BE_MarkComputeUse( resource );
+        else BE_MarkGraphicsUse( resource );
+    }
+
+    // Async compute runs alongside the other queues, so a write into a resource it last used has to wait for that
+    // submission on |queue|, flushing it first if it is still recording.
+    void BE_WaitComputeUse( uint64_t computeUseSerial, nvrhi::CommandQueue queue )
+    {
+        if ( computeUseSerial == UINT64_MAX || vhCmdListSerialComplete( nvrhi::CommandQueue::Compute, computeUseSerial ) ) return;
+        if ( computeUseSerial >= vhCmdListOpenSerial( nvrhi::CommandQueue::Compute ) ) vhCmdListFlush( nvrhi::CommandQueue::Compute );
+        if ( computeUseSerial >= vhCmdListOpenSerial( nvrhi::CommandQueue::Compute ) ) return; // Nothing was recorded.
+        vhCmdListWaitForSerial( queue, nvrhi::CommandQueue::Compute, computeUseSerial );
+    }
+
+    // The other way around: async compute using a resource waits for the graphics submission that last used it.
+    void BE_WaitGraphicsUse( uint64_t graphicsUseSerial )
+    {
+        if ( graphicsUseSerial == UINT64_MAX || vhCmdListSerialComplete( nvrhi::CommandQueue::Graphics, graphicsUseSerial ) ) return;
+        if ( graphicsUseSerial >= vhCmdListOpenSerial( nvrhi::CommandQueue::Graphics ) ) vhCmdListFlush( nvrhi::CommandQueue::Graphics );
+        if ( graphicsUseSerial >= vhCmdListOpenSerial( nvrhi::CommandQueue::Graphics ) ) return; // Nothing was recorded.
+        vhCmdListWaitForSerial( nvrhi::CommandQueue::Compute, nvrhi::CommandQueue::Graphics, graphicsUseSerial );
+    }
+
+    // Picks the queue for an upload into a resource last used by graphics submission |graphicsUseSerial|.
+    // Graphics and compute always wait for the copy queue, so a copy-queue upload lands before any later use. It would
+    // also overtake earlier uses still sitting in the graphics command list being recorded, so those uploads stay on
+    // the graphics queue. Otherwise the copy waits for the last graphics submission that touched the resource.
+    nvrhi::CommandQueue BE_UploadQueue( uint64_t graphicsUseSerial )
+    {
+        if ( !g_vhInit.transferQueueUploads ) return nvrhi::CommandQueue::Graphics;
+        if ( graphicsUseSerial == UINT64_MAX ) return nvrhi::CommandQueue::Copy;
+        if ( graphicsUseSerial >= vhCmdListOpenSerial( nvrhi::CommandQueue::Graphics ) ) return nvrhi::CommandQueue::Graphics;
+        vhCmdListWaitForSerial( nvrhi::CommandQueue::Copy, nvrhi::CommandQueue::Graphics, graphicsUseSerial );
+        return nvrhi::CommandQueue::Copy;
+    }
+
+    // BE_UploadQueue() for |resource|, also ordering the upload after async compute work on it.
+    template< typename T > nvrhi::CommandQueue BE_UploadQueueFor( T& resource )
+    {
+        auto queue = BE_UploadQueue( resource.graphicsUseSerial );
+        BE_WaitComputeUse( resource.computeUseSerial, queue );
+        return queue;
+    }
+
+    // Copy queue uploads are recorded natively, outside NVRHI's state tracking: its barriers name graphics pipeline
+    // stages, which a transfer-only queue does not support. Every copy leaves its destination the way NVRHI expects to
+    // find it, textures in the ShaderResource layout. Resources are EXCLUSIVE, so when the copy queue is another queue
+    // family the copied ranges are released to the graphics family, and BE_Util_AcquireTransfer() records the matching
+    // acquire into the open graphics command list. That list is always submitted after, and waits for, the copy list.
+    bool BE_TransferOwnership() const { return g_QueueFamilyTransfer != g_QueueFamilyGraphics; }
+
+    template< typename T > void BE_Util_SetTransferRelease( T& barrier )
+    {
+        barrier.srcQueueFamilyIndex = BE_TransferOwnership() ? g_QueueFamilyTransfer : VK_QUEUE_FAMILY_IGNORED;
+        barrier.dstQueueFamilyIndex = BE_TransferOwnership() ? g_QueueFamilyGraphics : VK_QUEUE_FAMILY_IGNORED;
+    }
+
+    // Records the graphics queue half of the ownership transfers released by a copy queue upload.
+    void BE_Util_AcquireTransfer( std::vector< VkImageMemoryBarrier >& images, std::vector< VkBufferMemoryBarrier >& buffers )
+    {
+        for ( auto& barrier : images )
+        {
+            barrier.srcAccessMask = 0;
+            barrier.dstAccessMask = VK_ACCESS_MEMORY_READ_BIT | VK_ACCESS_MEMORY_WRITE_BIT;
+        }
+        for ( auto& barrier : buffers )
+        {
+            barrier.srcAccessMask = 0;
+            barrier.dstAccessMask = VK_ACCESS_MEMORY_READ_BIT | VK_ACCESS_MEMORY_WRITE_BIT;
+        }
+
+        auto cmdlist = vhCmdListGet( nvrhi::CommandQueue::Graphics );
+        std::lock_guard< std::mutex > lock( g_nvRHIStateMutex );
+        VkCommandBuffer vkCmdBuf = cmdlist->getNativeObject( nvrhi::ObjectTypes::VK_CommandBuffer );
+        vkCmdPipelineBarrier( vkCmdBuf, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, 0, 0, nullptr,
+            ( uint32_t ) buffers.size(), buffers.data(), ( uint32_t ) images.size(), images.data() );
+    }
+
+    // Records a copy of |size| bytes from |src| into |bbuf| on the copy queue, see BE_TransferOwnership().
+    void BE_Util_CopyBufferTransfer( vhBackendBuffer& bbuf, uint64_t dstOffset, nvrhi::IBuffer* src, uint64_t srcOffset, uint64_t size )
+    {
+        auto cmdlist = vhCmdListGet( nvrhi::CommandQueue::Copy );
+        BE_MarkCopyUse( bbuf );
+
+        VkBufferCopy region = { srcOffset, bbuf.poolOffset + dstOffset, size };
+        std::vector< VkBufferMemoryBarrier > barriers( 1, { VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER } );
+        barriers[0].srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        barriers[0].buffer = bbuf.handle->getNativeObject( nvrhi::ObjectTypes::VK_Buffer );
+        barriers[0].offset = region.dstOffset;
+        barriers[0].size = size;
+        BE_Util_SetTransferRelease( barriers[0] );
+        {
+            std::lock_guard< std::mutex > lock( g_nvRHIStateMutex );
+            VkCommandBuffer vkCmdBuf = cmdlist->getNativeObject( nvrhi::ObjectTypes::VK_CommandBuffer );
+            vkCmdCopyBuffer( vkCmdBuf, src->getNativeObject( nvrhi::ObjectTypes::VK_Buffer ), barriers[0].buffer, 1, &region );
+
+            // Within one queue family the semaphore the graphics queue waits on already makes the copy visible.
+            if ( !BE_TransferOwnership() ) return;
+            vkCmdPipelineBarrier( vkCmdBuf, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, 0, 0, nullptr, 1, barriers.data(), 0, nullptr );
+        }
+
+        std::vector< VkImageMemoryBarrier > images;
+        BE_Util_AcquireTransfer( images, barriers );
+        BE_MarkGraphicsUse( bbuf );
+    }
+
     void BE_UpdateTexture( vhBackendTexture& btex, const vhMem* data, glm::ivec4 arrayMipUpdateRange = glm::ivec4( 0, INT_MAX, 0, INT_MAX ) )
     {
         if ( !btex.handle || !data || !data->size() ) return;
-        auto cmdlist = vhCmdListGet( nvrhi::CommandQueue::Graphics );
 
         // Clamp to texture mip / array boundaries.
         int32_t mipStart = arrayMipUpdateRange.x, mipEnd = arrayMipUpdateRange.y;
@@ -178,7 +907,21 @@ struct vhCmdBackendState : public VIDLHandler
             totalLayerSize += btex.mipInfo[mip].size;
         }
 
+        // Depth / stencil copies need per-aspect regions; leave those to writeTexture on the graphics queue.
+        const auto& formatInfo = nvrhi::getFormatInfo( btex.info.format );
+        bool colour = !formatInfo.hasDepth && !formatInfo.hasStencil;
+        auto queue = nvrhi::CommandQueue::Graphics;
+        if ( colour ) queue = BE_UploadQueueFor( btex );
+        else BE_WaitComputeUse( btex.computeUseSerial, queue );
+        if ( queue == nvrhi::CommandQueue::Copy )
+        {
+            BE_UploadTextureStaged( btex, data, mipStart, mipEnd, layerStart, layerEnd, totalLayerSize );
+            return;
+        }
+
         // Update the texture.
+        auto cmdlist = vhCmdListGet( nvrhi::CommandQueue::Graphics );
+        BE_MarkGraphicsUse( btex );
         {
             std::lock_guard< std::mutex > lock( g_nvRHIStateMutex );
             
@@ -200,6 +943,193 @@ struct vhCmdBackendState : public VIDLHandler
         }
     }
 
+    // Copy-queue texture upload through the staging ring. NVRHI has no buffer to texture copy, so the copy itself is
+    // recorded natively by BE_Util_CopyBufferToTexture().
+    void BE_UploadTextureStaged( vhBackendTexture& btex, const vhMem* data, int32_t mipStart, int32_t mipEnd, int32_t layerStart, int32_t layerEnd, int64_t totalLayerSize )
+    {
+        // Buffer offsets of a copy must be a multiple of both the texel block size and 4. The ring hands out offsets
+        // that are a multiple of every block size, so aligning within the allocation is enough.
+        uint64_t alignment = std::lcm( ( uint64_t ) nvrhi::getFormatInfo( btex.info.format ).bytesPerBlock, 4ull );
+        std::vector< VkBufferImageCopy > regions;
+        uint64_t stagingSize = 0;
+        for ( int32_t layer = layerStart; layer < layerEnd; ++layer )
+        {
+            for ( int32_t mip = mipStart; mip < mipEnd; ++mip )
+            {
+                const auto& mipData = btex.mipInfo[mip];
+                VkBufferImageCopy region = {};
+                region.bufferOffset = ( stagingSize + alignment - 1 ) / alignment * alignment;
+                region.imageSubresource = { VK_IMAGE_ASPECT_COLOR_BIT, ( uint32_t ) mip, ( uint32_t ) layer, 1 };
+                region.imageExtent.width = ( uint32_t ) mipData.dimensions.x;
+                region.imageExtent.height = ( uint32_t ) mipData.dimensions.y;
+                region.imageExtent.depth = btex.info.target == nvrhi::TextureDimension::Texture3D ? ( uint32_t ) mipData.dimensions.z : 1;
+                regions.push_back( region );
+                stagingSize = region.bufferOffset + mipData.size;
+            }
+        }
+
+        auto staging = stagingRing.alloc( stagingSize );
+        if ( !staging.buffer )
+        {
+            VRHI_ERR( "vhUpdateTexture() : Failed to allocate %llu bytes of staging memory for %s!\n", stagingSize, btex.name.c_str() );
+            return;
+        }
+
+        const auto& mipStartData = btex.mipInfo[mipStart];
+        auto region = regions.begin();
+        for ( int32_t layer = layerStart; layer < layerEnd; ++layer )
+        {
+            const uint8_t* layerSrcPtr = data->data() + ( size_t ) ( layer - layerStart ) * totalLayerSize;
+            for ( int32_t mip = mipStart; mip < mipEnd; ++mip, ++region )
+            {
+                const auto& mipData = btex.mipInfo[mip];
+                memcpy( staging.mapped + staging.offset + region->bufferOffset, layerSrcPtr + ( mipData.offset - mipStartData.offset ), mipData.size );
+                region->bufferOffset += staging.offset;
+            }
+        }
+
+        BE_Util_CopyBufferToTexture( nvrhi::CommandQueue::Copy, btex, staging.buffer, regions );
+        g_vhCmdListTransferSizeHeuristic += stagingSize;
+        vhCmdListFlushTransferIfNeeded();
+    }
+
+    // Records a native buffer to texture copy into the open command list of |queue|. On the graphics queue NVRHI
+    // transitions the texture into CopyDest first; the copy queue does without NVRHI, see BE_TransferOwnership().
+    void BE_Util_CopyBufferToTexture( nvrhi::CommandQueue queue, vhBackendTexture& btex, nvrhi::IBuffer* src, const std::vector< VkBufferImageCopy >& regions )
+    {
+        auto cmdlist = vhCmdListGet( queue );
+        VkBuffer vkStaging = src->getNativeObject( nvrhi::ObjectTypes::VK_Buffer );
+        VkImage vkImage = btex.handle->getNativeObject( nvrhi::ObjectTypes::VK_Image );
+        if ( queue != nvrhi::CommandQueue::Copy )
+        {
+            std::lock_guard< std::mutex > lock( g_nvRHIStateMutex );
+            cmdlist->setTextureState( btex.handle, nvrhi::AllSubresources, nvrhi::ResourceStates::CopyDest );
+            cmdlist->commitBarriers();
+            VkCommandBuffer vkCmdBuf = cmdlist->getNativeObject( nvrhi::ObjectTypes::VK_CommandBuffer );
+            vkCmdCopyBufferToImage( vkCmdBuf, vkStaging, vkImage, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, ( uint32_t ) regions.size(), regions.data() );
+            return;
+        }
+
+        // Every region covers a whole subresource, so its previous contents can be discarded by the transition.
+        std::vector< VkImageMemoryBarrier > barriers;
+        for ( const auto& region : regions )
+        {
+            VkImageMemoryBarrier barrier = { VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER };
+            barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+            barrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+            barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+            barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+            barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+            barrier.image = vkImage;
+            barrier.subresourceRange = { VK_IMAGE_ASPECT_COLOR_BIT, region.imageSubresource.mipLevel, 1, region.imageSubresource.baseArrayLayer, 1 };
+            barriers.push_back( barrier );
+        }
+        {
+            std::lock_guard< std::mutex > lock( g_nvRHIStateMutex );
+            VkCommandBuffer vkCmdBuf = cmdlist->getNativeObject( nvrhi::ObjectTypes::VK_CommandBuffer );
+            vkCmdPipelineBarrier( vkCmdBuf, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, nullptr, 0, nullptr, ( uint32_t ) barriers.size(), barriers.data() );
+            vkCmdCopyBufferToImage( vkCmdBuf, vkStaging, vkImage, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, ( uint32_t ) regions.size(), regions.data() );
+
+            for ( auto& barrier : barriers )
+            {
+                barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+                barrier.dstAccessMask = 0;
+                barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+                barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+                BE_Util_SetTransferRelease( barrier );
+            }
+            vkCmdPipelineBarrier( vkCmdBuf, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, 0, 0, nullptr, 0, nullptr, ( uint32_t ) barriers.size(), barriers.data() );
+        }
+        if ( !BE_TransferOwnership() ) return;
+
+        std::vector< VkBufferMemoryBarrier > buffers;
+        BE_Util_AcquireTransfer( barriers, buffers );
+        BE_MarkGraphicsUse( btex );
+    }
+
+    // Records the copy of a committed texture mapping. Returns the queue it went to, or Count if nothing reads the
+    // mapping after this call.
+    nvrhi::CommandQueue BE_CommitTextureUpload( const vhUploadMapping& mapping, const vhStagingRing::Allocation& staging )
+    {
+        auto* it = backendTextures.find( mapping.texture );
+        if ( !it )
+        {
+            VRHI_ERR( "vhCommitUpload() : Texture %d not found!\n", mapping.texture );
+            return nvrhi::CommandQueue::Count;
+        }
+        auto& btex = **it;
+
+        // The mapping was sized against the texture as it was then; it may have been recreated since.
+        if ( !btex.handle || mapping.mip >= btex.info.mipLevels || mapping.layer >= btex.info.arrayLayers || ( uint64_t ) btex.mipInfo[mapping.mip].size != mapping.size )
+        {
+            VRHI_ERR( "vhCommitUpload() : Mapping of mip %d layer %d no longer matches %s!\n", mapping.mip, mapping.layer, btex.name.c_str() );
+            return nvrhi::CommandQueue::Count;
+        }
+        const auto& mipData = btex.mipInfo[mapping.mip];
+
+        // Depth / stencil go through writeTexture, as in BE_UpdateTexture(). That copies out of the mapping right away.
+        const auto& formatInfo = nvrhi::getFormatInfo( btex.info.format );
+        if ( formatInfo.hasDepth || formatInfo.hasStencil )
+        {
+            BE_WaitComputeUse( btex.computeUseSerial, nvrhi::CommandQueue::Graphics );
+            auto cmdlist = vhCmdListGet( nvrhi::CommandQueue::Graphics );
+            BE_MarkGraphicsUse( btex );
+            std::lock_guard< std::mutex > lock( g_nvRHIStateMutex );
+            cmdlist->writeTexture( btex.handle, mapping.layer, mapping.mip, staging.mapped + staging.offset, mipData.pitch, mipData.slice_size );
+            return nvrhi::CommandQueue::Count;
+        }
+
+        auto queue = BE_UploadQueueFor( btex );
+        if ( queue == nvrhi::CommandQueue::Graphics ) BE_MarkGraphicsUse( btex );
+
+        VkBufferImageCopy region = {};
+        region.bufferOffset = staging.offset;
+        region.imageSubresource = { VK_IMAGE_ASPECT_COLOR_BIT, ( uint32_t ) mapping.mip, ( uint32_t ) mapping.layer, 1 };
+        region.imageExtent.width = ( uint32_t ) mipData.dimensions.x;
+        region.imageExtent.height = ( uint32_t ) mipData.dimensions.y;
+        region.imageExtent.depth = btex.info.target == nvrhi::TextureDimension::Texture3D ? ( uint32_t ) mipData.dimensions.z : 1;
+        BE_Util_CopyBufferToTexture( queue, btex, staging.buffer, { region } );
+        return queue;
+    }
+
+    // Buffer counterpart of BE_CommitTextureUpload().
+    nvrhi::CommandQueue BE_CommitBufferUpload( const vhUploadMapping& mapping, const vhStagingRing::Allocation& staging )
+    {
+        auto* it = backendBuffers.find( mapping.buffer );
+        if ( !it )
+        {
+            VRHI_ERR( "vhCommitUpload() : Buffer %d not found!\n", mapping.buffer );
+            return nvrhi::CommandQueue::Count;
+        }
+        auto& bbuf = **it;
+
+        if ( mapping.offset + mapping.size > bbuf.byteSize )
+        {
+            if ( !( bbuf.flags & VRHI_BUFFER_ALLOW_RESIZE ) )
+            {
+                VRHI_ERR( "vhCommitUpload() : Update range [%llu, %llu] exceeds buffer size %llu!\n", mapping.offset, mapping.offset + mapping.size, bbuf.byteSize );
+                return nvrhi::CommandQueue::Count;
+            }
+            BE_ResizeBuffer( bbuf, mapping.offset + mapping.size );
+        }
+        if ( !bbuf.handle ) return nvrhi::CommandQueue::Count;
+
+        auto queue = BE_UploadQueueFor( bbuf );
+        if ( queue == nvrhi::CommandQueue::Copy )
+        {
+            BE_Util_CopyBufferTransfer( bbuf, mapping.offset, staging.buffer, staging.offset, mapping.size );
+            return queue;
+        }
+
+        auto cmdlist = vhCmdListGet( queue );
+        BE_MarkGraphicsUse( bbuf );
+        {
+            std::lock_guard< std::mutex > lock( g_nvRHIStateMutex );
+            cmdlist->copyBuffer( bbuf.handle, bbuf.poolOffset + mapping.offset, staging.buffer, staging.offset, mapping.size );
+        }
+        return queue;
+    }
+
     void BE_BlitTexture( vhBackendTexture& bdst, vhBackendTexture& bsrc, int dstMip, int srcMip, int dstLayer, int srcLayer, glm::ivec3 dstOffset, glm::ivec3 srcOffset, glm::ivec3 extent )
     {
         if ( !bdst.handle || !bsrc.handle ) return;
@@ -224,103 +1154,248 @@ struct vhCmdBackendState : public VIDLHandler
 
         // Acquire command list and execute copy
         auto cmdlist = vhCmdListGet( nvrhi::CommandQueue::Graphics );
+        BE_MarkGraphicsUse( bdst );
+        BE_MarkGraphicsUse( bsrc );
         {
             std::lock_guard<std::mutex> lock( g_nvRHIStateMutex );
             cmdlist->copyTexture( bdst.handle, dstSlice, bsrc.handle, srcSlice );
         }
     }
 
-    void BE_ReadTextureSlow( vhBackendTexture& btex, vhMem* outData, int mip, int layer )
+    // Records a copy of the given mip / layer range into a pooled readback buffer and submits it. The data lands in
+    // |outData| in the vhTextureMiplevelInfo layout, layer by layer, once BE_RetireReadbacks() sees the copy complete.
+    void BE_ReadbackTexture( vhBackendTexture& btex, int32_t mipStart, int32_t mipEnd, int32_t layerStart, int32_t layerEnd, vhReadbackTicket ticket, vhMem* outData )
     {
-        if ( !btex.handle || !outData ) return;
-        assert ( btex.info.target != nvrhi::TextureDimension::Texture3D );
+        const auto& formatInfo = nvrhi::getFormatInfo( btex.info.format );
+        VkImageAspectFlags aspect = formatInfo.hasDepth ? VK_IMAGE_ASPECT_DEPTH_BIT : VK_IMAGE_ASPECT_COLOR_BIT;
 
-        // Staging Texture
-        auto desc = btex.handle->getDesc();
-        desc.isVirtual = false;
-        desc.isRenderTarget = false;
-        desc.isUAV = false;
-        desc.keepInitialState = true;
-        desc.initialState = nvrhi::ResourceStates::CopyDest; 
-        
-        nvrhi::StagingTextureHandle stagingTex;
+        int64_t totalLayerSize = 0;
+        for ( int32_t mip = mipStart; mip < mipEnd; ++mip )
         {
-            std::lock_guard<std::mutex> lock( g_nvRHIStateMutex );
-            stagingTex = g_vhDevice->createStagingTexture( desc, nvrhi::CpuAccessMode::Read );
+            totalLayerSize += btex.mipInfo[mip].size;
         }
 
-        if ( !stagingTex ) return;
+        // As with uploads, every region starts 16 byte aligned in the readback buffer and is scattered into place afterwards.
+        vhPendingReadback readback = { .ticket = ticket, .outSize = ( uint64_t ) ( totalLayerSize * ( layerEnd - layerStart ) ), .outData = outData };
+        std::vector< VkBufferImageCopy > regions;
+        uint64_t bufferSize = 0;
+        for ( int32_t layer = layerStart; layer < layerEnd; ++layer )
+        {
+            for ( int32_t mip = mipStart; mip < mipEnd; ++mip )
+            {
+                const auto& mipData = btex.mipInfo[mip];
+                VkBufferImageCopy region = {};
+                region.bufferOffset = ( bufferSize + 15 ) & ~15ull;
+                region.imageSubresource = { aspect, ( uint32_t ) mip, ( uint32_t ) layer, 1 };
+                region.imageExtent.width = ( uint32_t ) mipData.dimensions.x;
+                region.imageExtent.height = ( uint32_t ) mipData.dimensions.y;
+                region.imageExtent.depth = btex.info.target == nvrhi::TextureDimension::Texture3D ? ( uint32_t ) mipData.dimensions.z : 1;
+                regions.push_back( region );
+
+                uint64_t outOffset = ( uint64_t ) ( ( layer - layerStart ) * totalLayerSize + ( mipData.offset - btex.mipInfo[mipStart].offset ) );
+                readback.spans.push_back( { .bufferOffset = region.bufferOffset, .outOffset = outOffset, .size = ( uint64_t ) mipData.size } );
+                bufferSize = region.bufferOffset + mipData.size;
+            }
+        }
 
-        // For this slow-path operation, just use Graphics queue for everything
-        // (avoids complexity with transfer queue barriers)
+        readback.buffer = readbackPool.acquire( bufferSize );
+        if ( !readback.buffer )
         {
-            std::lock_guard<std::mutex> lock( g_nvRHIStateMutex );
-            
-            nvrhi::CommandListParameters params = { .queueType = nvrhi::CommandQueue::Graphics };
-            auto cmdList = g_vhDevice->createCommandList( params );
-            cmdList->open();
-            
-            nvrhi::TextureSlice slice;
-            slice.mipLevel = mip;
-            slice.arraySlice = layer;
+            VRHI_ERR( "vhReadTextureAsync() : Failed to create a %llu byte readback buffer for %s!\n", bufferSize, btex.name.c_str() );
+            BE_CompleteReadbackTicket( ticket );
+            return;
+        }
 
-            // Make sure source is in CopySource state
-            cmdList->setTextureState( btex.handle, nvrhi::AllSubresources, nvrhi::ResourceStates::CopySource );
-            cmdList->commitBarriers();
+        auto cmdlist = vhCmdListGet( nvrhi::CommandQueue::Graphics );
+        BE_MarkGraphicsUse( btex );
+        {
+            std::lock_guard< std::mutex > lock( g_nvRHIStateMutex );
+            cmdlist->setTextureState( btex.handle, nvrhi::AllSubresources, nvrhi::ResourceStates::CopySource );
+            cmdlist->setBufferState( readback.buffer, nvrhi::ResourceStates::CopyDest );
+            cmdlist->commitBarriers();
 
-            cmdList->copyTexture( stagingTex, slice, btex.handle, slice );
-            
-            cmdList->close();
-            g_vhDevice->executeCommandList( cmdList, nvrhi::CommandQueue::Graphics );
-            g_vhDevice->waitForIdle();
+            // NVRHI has no texture to buffer copy either, see BE_UploadTextureStaged().
+            VkCommandBuffer vkCmdBuf = cmdlist->getNativeObject( nvrhi::ObjectTypes::VK_CommandBuffer );
+            VkImage vkImage = btex.handle->getNativeObject( nvrhi::ObjectTypes::VK_Image );
+            VkBuffer vkBuffer = readback.buffer->getNativeObject( nvrhi::ObjectTypes::VK_Buffer );
+            vkCmdCopyImageToBuffer( vkCmdBuf, vkImage, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, vkBuffer, ( uint32_t ) regions.size(), regions.data() );
+            BE_Util_HostReadBarrier( vkCmdBuf );
         }
+        BE_SubmitReadback( std::move( readback ) );
+    }
 
-        // CPU copy
-        void* pData = nullptr;
-        size_t rowPitch = 0;
-        
+    void BE_ReadbackBuffer( vhBackendBuffer& bbuf, uint64_t offset, uint64_t size, vhReadbackTicket ticket, vhMem* outData )
+    {
+        vhPendingReadback readback = { .ticket = ticket, .spans = { { .bufferOffset = 0, .outOffset = 0, .size = size } }, .outSize = size, .outData = outData };
+        readback.buffer = readbackPool.acquire( size );
+        if ( !readback.buffer )
         {
-            std::lock_guard<std::mutex> lock( g_nvRHIStateMutex );
-            nvrhi::TextureSlice slice;
-            slice.mipLevel = mip;
-            slice.arraySlice = layer;
-            pData = g_vhDevice->mapStagingTexture( stagingTex, slice, nvrhi::CpuAccessMode::Read, &rowPitch );
+            VRHI_ERR( "vhReadBufferAsync() : Failed to create a %llu byte readback buffer for %s!\n", size, bbuf.name.c_str() );
+            BE_CompleteReadbackTicket( ticket );
+            return;
         }
 
-        if ( pData )
+        auto cmdlist = vhCmdListGet( nvrhi::CommandQueue::Graphics );
+        BE_MarkGraphicsUse( bbuf );
         {
-            const auto& mipInfo = btex.mipInfo[mip];
-            int height = mipInfo.dimensions.y;
-            int expectedPitch = mipInfo.pitch;
+            std::lock_guard< std::mutex > lock( g_nvRHIStateMutex );
+            cmdlist->copyBuffer( readback.buffer, 0, bbuf.handle, bbuf.poolOffset + offset, size );
+            BE_Util_HostReadBarrier( cmdlist->getNativeObject( nvrhi::ObjectTypes::VK_CommandBuffer ) );
+        }
+        BE_SubmitReadback( std::move( readback ) );
+    }
 
-            if ( outData->size() < ( size_t ) mipInfo.slice_size )
-            {
-                outData->resize( mipInfo.slice_size );
-            }
+    // Makes transfer writes visible to the host once the submission has completed. NVRHI only tracks device-side states.
+    static void BE_Util_HostReadBarrier( VkCommandBuffer vkCmdBuf )
+    {
+        VkMemoryBarrier barrier = { .sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER, .srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT, .dstAccessMask = VK_ACCESS_HOST_READ_BIT };
+        vkCmdPipelineBarrier( vkCmdBuf, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_HOST_BIT, 0, 1, &barrier, 0, nullptr, 0, nullptr );
+    }
 
-            uint8_t* src = ( uint8_t* ) pData;
-            uint8_t* dst = outData->data();
+    // Submits the graphics command list holding |readback| right away, so it is in flight without anyone waiting on it.
+    void BE_SubmitReadback( vhPendingReadback&& readback )
+    {
+        readback.graphicsSerial = vhCmdListOpenSerial( nvrhi::CommandQueue::Graphics );
+        pendingReadbacks.push_back( std::move( readback ) );
+        vhCmdListFlush( nvrhi::CommandQueue::Graphics );
+    }
 
-            for ( int y = 0; y < height; ++y )
+    // Hands every readback whose copy has completed to its caller, oldest first. If |waitTicket| is still in flight,
+    // blocks until the GPU has finished that readback first.
+    void BE_RetireReadbacks( vhReadbackTicket waitTicket = 0 )
+    {
+        if ( waitTicket )
+        {
+            for ( const auto& readback : pendingReadbacks )
             {
-                memcpy( dst + ( size_t ) y * expectedPitch, src + ( size_t ) y * rowPitch, expectedPitch );
+                if ( readback.ticket != waitTicket ) continue;
+                vhCmdListWaitSerialComplete( nvrhi::CommandQueue::Graphics, readback.graphicsSerial );
+                break;
             }
+        }
 
+        while ( !pendingReadbacks.empty() && vhCmdListSerialComplete( nvrhi::CommandQueue::Graphics, pendingReadbacks.front().graphicsSerial ) )
+        {
+            auto& readback = pendingReadbacks.front();
+            if ( readback.outData )
             {
-                std::lock_guard<std::mutex> lock( g_nvRHIStateMutex );
-                g_vhDevice->unmapStagingTexture( stagingTex );
+                readback.outData->resize( readback.outSize );
+                std::lock_guard< std::mutex > lock( g_nvRHIStateMutex );
+                const uint8_t* mapped = ( const uint8_t* ) g_vhDevice->mapBuffer( readback.buffer, nvrhi::CpuAccessMode::Read );
+                if ( mapped )
+                {
+                    for ( const auto& span : readback.spans ) memcpy( readback.outData->data() + span.outOffset, mapped + span.bufferOffset, span.size );
+                    g_vhDevice->unmapBuffer( readback.buffer );
+                }
             }
+            readbackPool.release( readback.buffer );
+            BE_CompleteReadbackTicket( readback.ticket );
+            pendingReadbacks.pop_front();
+        }
+    }
+
+    void BE_PublishTexture( const vhBackendTexture& btex )
+    {
+        textureSnapshots.publish( btex.id, { .info = btex.info, .mipInfo = btex.mipInfo, .handle = btex.handle.Get() } );
+    }
+
+    void BE_PublishBuffer( const vhBackendBuffer& bbuf )
+    {
+        bufferSnapshots.publish( bbuf.id, { .byteSize = bbuf.byteSize, .stride = bbuf.stride, .flags = bbuf.flags, .handle = bbuf.handle.Get(), .offset = bbuf.poolOffset } );
+    }
+
+    void BE_PublishShader( const vhBackendShader& bshader )
+    {
+        shaderSnapshots.publish( bshader.id, {
+            .threadGroupSize = bshader.threadGroupSize, .reflection = bshader.reflection,
+            .pushConstants = bshader.pushConstants, .specConstants = bshader.specConstants, .handle = bshader.handle.Get()
+        } );
+    }
+
+    // Returns the state for |id| for modification, marking it for republishing.
+    vhState& BE_State( vhStateId id )
+    {
+        stateSnapshotsDirty.insert( id );
+        return backendStates[id];
+    }
+
+    void BE_PublishDirtyStates()
+    {
+        for ( vhStateId id : stateSnapshotsDirty )
+        {
+            stateSnapshots.publish( id, backendStates[id] );
+        }
+        stateSnapshotsDirty.clear();
+    }
+
+    // Places a VRHI_BUFFER_POOLED buffer in a shared page. Returns false if the buffer should get a dedicated allocation
+    // instead: GPU-writable, indirect and resizable buffers never share, and neither do large ones.
+    bool BE_AllocPooledBuffer( vhBackendBuffer& bbuf, const nvrhi::BufferDesc& desc, uint64_t flags )
+    {
+        if ( !( flags & VRHI_BUFFER_POOLED ) || ( flags & VRHI_BUFFER_ALLOW_RESIZE ) ) return false;
+        if ( desc.canHaveUAVs || desc.isDrawIndirectArgs || desc.byteSize > vhBufferPool::kMaxPooledSize ) return false;
+
+        uint64_t key = vhBufferPoolKey( desc );
+        auto& pool = backendBufferPools[key];
+        if ( pool.pages.empty() )
+        {
+            // Uniform and shader-readable ranges get bound at their offset, which has to meet the device's alignment.
+            pool.desc = desc;
+            pool.alignment = ( desc.isConstantBuffer || desc.canHaveTypedViews || desc.canHaveRawViews ) ? 256 : 16;
         }
+
+        uint32_t page = 0, block = 0;
+        uint64_t offset = 0;
+        if ( !pool.alloc( desc.byteSize, page, block, offset ) ) return false;
+
+        bbuf.handle = pool.pages[page].buffer;
+        bbuf.poolKey = key;
+        bbuf.poolPage = page;
+        bbuf.poolBlock = block;
+        bbuf.poolOffset = offset;
+        return true;
+    }
+
+    // The range of a destroyed pooled buffer goes back to its page once the GPU is past the last use of it.
+    void BE_ReleasePooledBuffer( const vhBackendBuffer& bbuf )
+    {
+        if ( !bbuf.poolKey ) return;
+        pendingPoolReleases.push_back( {
+            .poolKey = bbuf.poolKey, .page = bbuf.poolPage, .block = bbuf.poolBlock,
+            .graphicsSerial = bbuf.graphicsUseSerial, .copySerial = bbuf.copyUseSerial, .computeSerial = bbuf.computeUseSerial
+        } );
     }
 
+    void BE_RetirePoolReleases()
+    {
+        std::erase_if( pendingPoolReleases, [this]( const vhPendingPoolRelease& release )
+        {
+            if ( release.graphicsSerial != UINT64_MAX && !vhCmdListSerialComplete( nvrhi::CommandQueue::Graphics, release.graphicsSerial ) ) return false;
+            if ( release.copySerial != UINT64_MAX && !vhCmdListSerialComplete( nvrhi::CommandQueue::Copy, release.copySerial ) ) return false;
+            if ( release.computeSerial != UINT64_MAX && !vhCmdListSerialComplete( nvrhi::CommandQueue::Compute, release.computeSerial ) ) return false;
+            backendBufferPools[release.poolKey].pages[release.page].allocator->release( release.block );
+            return true;
+        } );
+    }
+
+    // Sets the logical size of a resizable buffer. Shrinking and growing within capacity happen in place; growing past
+    // it reallocates to at least double the capacity, so a buffer grown by appends copies O(n) bytes in total.
     void BE_ResizeBuffer( vhBackendBuffer& bbuf, uint64_t size )
     {
         if ( !bbuf.handle ) return;
 
+        if ( size > bbuf.desc.byteSize && !BE_ReallocateBuffer( bbuf, std::max( size, bbuf.desc.byteSize * 2 ) ) ) return;
+        bbuf.byteSize = size;
+        if ( bbuf.id != VRHI_INVALID_HANDLE ) BE_PublishBuffer( bbuf );
+    }
+
+    // Moves the buffer into a new allocation of |capacity| bytes, carrying over its contents.
+    bool BE_ReallocateBuffer( vhBackendBuffer& bbuf, uint64_t capacity )
+    {
         auto oldHandle = bbuf.handle;
-        auto oldSize = bbuf.desc.byteSize;
+        auto oldDesc = bbuf.desc;
 
-        bbuf.desc.setByteSize( size );
+        bbuf.desc.setByteSize( capacity );
         {
             std::lock_guard< std::mutex > lock( g_nvRHIStateMutex );
             bbuf.handle = g_vhDevice->createBuffer( bbuf.desc );
@@ -328,80 +1403,194 @@ struct vhCmdBackendState : public VIDLHandler
 
         if ( !bbuf.handle )
         {
-            VRHI_ERR( "vhCreateVertexBuffer() : Failed to create bhandle!\n" );
-            return;
+            VRHI_ERR( "BE_ReallocateBuffer() : Failed to grow %s to %llu bytes!\n", bbuf.name.c_str(), capacity );
+            bbuf.handle = oldHandle;
+            bbuf.desc = oldDesc;
+            return false;
         }
 
+        // Binding sets still point at the old buffer. The caller republishes it.
+        BE_EvictBindingSets( oldHandle.Get() );
+
+        // Only the logical contents need to move.
+        uint64_t copySize = glm::min( bbuf.byteSize, capacity );
+        if ( !copySize ) return true;
         auto cmdlist = vhCmdListGet( nvrhi::CommandQueue::Graphics );
-        cmdlist->copyBuffer( bbuf.handle, 0, oldHandle, 0, glm::min( bbuf.desc.byteSize, oldSize ) );
+        BE_MarkGraphicsUse( bbuf );
+        {
+            std::lock_guard< std::mutex > lock( g_nvRHIStateMutex );
+            cmdlist->copyBuffer( bbuf.handle, 0, oldHandle, 0, copySize );
+        }
+        g_vhBufferResizeBytesCopied += copySize;
+        return true;
     }
 
     void BE_UpdateBuffer( vhBackendBuffer& bbuf, uint64_t offset, const vhMem* data )
     {
         if ( !bbuf.handle || !data || !data->size() ) return;
 
-        if ( offset + data->size() > bbuf.desc.byteSize )
+        if ( offset + data->size() > bbuf.byteSize )
         {
             assert( bbuf.flags & VRHI_BUFFER_ALLOW_RESIZE );
             BE_ResizeBuffer( bbuf, offset + data->size() );
         }
 
+        if ( BE_UploadQueueFor( bbuf ) == nvrhi::CommandQueue::Copy )
+        {
+            auto staging = stagingRing.alloc( data->size() );
+            if ( !staging.buffer )
+            {
+                VRHI_ERR( "vhUpdateBuffer() : Failed to allocate %llu bytes of staging memory for %s!\n", ( uint64_t ) data->size(), bbuf.name.c_str() );
+                return;
+            }
+            memcpy( staging.mapped + staging.offset, data->data(), data->size() );
+            BE_Util_CopyBufferTransfer( bbuf, offset, staging.buffer, staging.offset, data->size() );
+            g_vhCmdListTransferSizeHeuristic += data->size();
+            vhCmdListFlushTransferIfNeeded();
+            return;
+        }
+
         auto cmdlist = vhCmdListGet( nvrhi::CommandQueue::Graphics );
+        BE_MarkGraphicsUse( bbuf );
         {
             std::lock_guard<std::mutex> lock( g_nvRHIStateMutex );
-            cmdlist->writeBuffer( bbuf.handle, data->data(), data->size(), offset );
+            cmdlist->writeBuffer( bbuf.handle, data->data(), data->size(), bbuf.poolOffset + offset );
         }
     }
 
+    // Returns the cached framebuffer for |colours| and |depth| at |mip| / |layer|, creating it on a miss, or null if an
+    // attachment isn't a live texture. Entries are keyed by the NVRHI textures, so a texture created again under the
+    // same handle gets a new framebuffer; BE_EvictFramebuffers() drops the old ones.
     nvrhi::FramebufferHandle BE_GetFrameBuffer( const std::vector< vhTexture >& colours, vhTexture depth, int mip = 0, int layer = 0 )
     {
-        // TODO: ################ Finish implementation ################
-        // TODO: THIS IS UNTESTED!! Use this at graphics render time in future.
-        
-        // Combine all inputs into a hash key
-        uint64_t hashInput[32]; // Enough for color attachments + depth + mip/layer
-        int i = 0;
-        for ( auto c : colours ) hashInput[i++] = ( uint64_t ) c;
-        hashInput[i++] = ( uint64_t ) depth;
-        hashInput[i++] = ( uint32_t ) mip | ( ( uint32_t ) layer << 16 );
-        
-        uint64_t key = komihash( hashInput, i * sizeof( uint64_t ), 0 );
-        
-        if ( backendFramebuffers.find( key ) == backendFramebuffers.end() )
+        if ( colours.size() > nvrhi::c_MaxRenderTargets ) return nullptr;
+
+        // Colour textures, then depth, then mip / layer.
+        vhBackendTexture* textures[nvrhi::c_MaxRenderTargets + 1] = {};
+        uint64_t hashInput[nvrhi::c_MaxRenderTargets + 2] = {};
+        size_t count = 0;
+        for ( vhTexture texture : colours )
+        {
+            auto* it = backendTextures.find( texture );
+            if ( !it || !( *it )->handle ) return nullptr;
+            textures[count] = it->get();
+            hashInput[count++] = ( uint64_t ) ( *it )->handle.Get();
+        }
+        if ( depth != VRHI_INVALID_HANDLE )
+        {
+            auto* it = backendTextures.find( depth );
+            if ( !it || !( *it )->handle ) return nullptr;
+            textures[colours.size()] = it->get();
+            hashInput[count] = ( uint64_t ) ( *it )->handle.Get();
+        }
+        count++;
+        hashInput[count++] = ( uint32_t ) mip | ( ( uint64_t ) ( uint32_t ) layer << 32 );
+        uint64_t key = komihash( hashInput, count * sizeof( uint64_t ), 0 );
+
+        auto itFramebuffer = backendFramebuffers.find( key );
+        if ( itFramebuffer == backendFramebuffers.end() )
         {
             nvrhi::FramebufferDesc desc;
-            for ( auto texture : colours )
+            for ( size_t i = 0; i < colours.size(); i++ )
+            {
+                desc.addColorAttachment( nvrhi::FramebufferAttachment( textures[i]->handle ).setArraySlice( layer ).setMipLevel( mip ) );
+            }
+            if ( textures[colours.size()] )
+            {
+                desc.setDepthAttachment( nvrhi::FramebufferAttachment( textures[colours.size()]->handle ).setArraySlice( layer ).setMipLevel( mip ) );
+            }
+
+            std::lock_guard< std::mutex > lock( g_nvRHIStateMutex );
+            nvrhi::FramebufferHandle framebuffer = g_vhDevice->createFramebuffer( desc );
+            if ( !framebuffer ) return nullptr;
+            itFramebuffer = backendFramebuffers.emplace( key, framebuffer ).first;
+        }
+
+        for ( auto* texture : textures )
+        {
+            if ( texture ) BE_MarkGraphicsUse( *texture );
+        }
+        return itFramebuffer->second;
+    }
+
+    // Drops every cached framebuffer that has |texture| attached.
+    void BE_EvictFramebuffers( nvrhi::ITexture* texture )
+    {
+        if ( !texture ) return;
+        std::lock_guard< std::mutex > lock( g_nvRHIStateMutex );
+        std::erase_if( backendFramebuffers, [texture]( const auto& entry )
+        {
+            const auto& desc = entry.second->getDesc();
+            if ( desc.depthAttachment.texture == texture ) return true;
+            for ( const auto& attachment : desc.colorAttachments )
+            {
+                if ( attachment.texture == texture ) return true;
+            }
+            return false;
+        } );
+    }
+
+    // Builds the input layout of the vertex buffers bound to |state|, one buffer slot per stream, with attributes in
+    // stream order. Vulkan assigns attribute locations in that order, so vertex shader inputs have to follow it.
+    // |outLayout| stays null without vertex buffers.
+    bool BE_GetInputLayout( const vhState& state, nvrhi::IShader* vertexShader, nvrhi::InputLayoutHandle& outLayout )
+    {
+        auto& attributes = scratchVertexAttributes;
+        attributes.clear();
+        outLayout = nullptr;
+
+        uint64_t key = 0;
+        for ( const auto& binding : state.vertexBindings )
+        {
+            if ( binding.buffer == VRHI_INVALID_HANDLE ) continue;
+            auto* it = backendBuffers.find( binding.buffer );
+            if ( !it || !( *it )->handle || ( *it )->vertexLayout.empty() )
             {
-                auto it = backendTextures.find( texture );
-                if ( it != backendTextures.end() && it->second->handle )
-                {
-                    desc.addColorAttachment( nvrhi::FramebufferAttachment( it->second->handle )
-                        .setArraySlice( layer )
-                        .setMipLevel( mip ) );
-                }
+                VRHI_ERR( "vhSetState() : Buffer %u on stream %d is not a vertex buffer!\n", binding.buffer, binding.stream );
+                return false;
             }
-
-            if ( depth != VRHI_INVALID_HANDLE )
+            for ( const auto& def : ( *it )->vertexLayout )
             {
-                auto it = backendTextures.find( depth );
-                if ( it != backendTextures.end() && it->second->handle )
+                nvrhi::Format format = vhVertexLayoutDefFormat( def );
+                if ( format == nvrhi::Format::UNKNOWN )
                 {
-                    desc.setDepthAttachment( nvrhi::FramebufferAttachment( it->second->handle )
-                        .setArraySlice( layer )
-                        .setMipLevel( mip ) );
+                    VRHI_ERR( "vhSetState() : Vertex attribute %s%d of buffer %u has no vertex format!\n", def.semantic.c_str(), def.semanticIndex, binding.buffer );
+                    return false;
                 }
+                attributes.push_back( nvrhi::VertexAttributeDesc()
+                    .setName( def.semanticIndex ? def.semantic + std::to_string( def.semanticIndex ) : def.semantic )
+                    .setFormat( format )
+                    .setBufferIndex( binding.stream )
+                    .setOffset( ( uint32_t ) def.offset )
+                    .setElementStride( ( *it )->stride ) );
+
+                const auto& attr = attributes.back();
+                key = komihash( attr.name.data(), attr.name.size(), key );
+                uint32_t fields[4] = { ( uint32_t ) attr.format, attr.bufferIndex, attr.offset, attr.elementStride };
+                key = komihash( fields, sizeof( fields ), key );
             }
+        }
+        if ( attributes.empty() ) return true;
 
+        auto it = backendInputLayouts.find( key );
+        if ( it == backendInputLayouts.end() )
+        {
             std::lock_guard< std::mutex > lock( g_nvRHIStateMutex );
-            backendFramebuffers[key] = g_vhDevice->createFramebuffer( desc );
+            nvrhi::InputLayoutHandle layout = g_vhDevice->createInputLayout( attributes.data(), ( uint32_t ) attributes.size(), vertexShader );
+            if ( !layout )
+            {
+                VRHI_ERR( "vhSetState() : Failed to create input layout!\n" );
+                return false;
+            }
+            it = backendInputLayouts.emplace( key, layout ).first;
         }
-        
-        return backendFramebuffers[key];
+        outLayout = it->second;
+        return true;
     }
 
     bool BE_PresubmitPipelineDescCommon(
         vhState& state,
-        vhBackendShader* shaders,
+        vhBackendShader* const* shaders,
         int shaderCount,
         nvrhi::ComputePipelineDesc* computePipelineDesc, // set to nullptr if not using compute.
         nvrhi::GraphicsPipelineDesc* graphicsPipelineDesc // set to nullptr if not using graphics.
@@ -414,13 +1603,13 @@ struct vhCmdBackendState : public VIDLHandler
     
         for ( int shaderIdx = 0; shaderIdx < shaderCount; ++shaderIdx )
         {
-            auto& shader = shaders[shaderIdx];
+            auto& shader = *shaders[shaderIdx];
             nvrhi::BindingSetDesc bsetDesc = nvrhi::BindingSetDesc();
             if ( !BE_Util_ShaderStageMatches( shader.flags, computePipelineDesc != nullptr, graphicsPipelineDesc != nullptr ) )
                 continue;
 
-            if ( computePipelineDesc ) computePipelineDesc->addBindingLayout( shader.layout );
-            if ( graphicsPipelineDesc ) graphicsPipelineDesc->addBindingLayout( shader.layout );
+            if ( computePipelineDesc && shader.layout ) computePipelineDesc->addBindingLayout( shader.layout );
+            if ( graphicsPipelineDesc && shader.layout ) graphicsPipelineDesc->addBindingLayout( shader.layout );
 
             if ( shader.flags & VRHI_SHADER_STAGE_COMPUTE && computePipelineDesc )
             {   
@@ -442,9 +1631,9 @@ struct vhCmdBackendState : public VIDLHandler
             graphicsPipelineDesc->renderState.blendState = vhTranslateBlendState( state.stateFlags );
             graphicsPipelineDesc->renderState.depthStencilState = vhTranslateDepthStencilState( state.stateFlags, state.frontStencil, state.backStencil );
             graphicsPipelineDesc->renderState.rasterState = vhTranslateRasterState( state.stateFlags );
+            if ( !BE_GetInputLayout( state, graphicsPipelineDesc->VS, graphicsPipelineDesc->inputLayout ) ) return false;
 
             // [TODO] The following fields are not currently populated from vhState:
-            // - inputLayout: requires separate resolution from vertex layout strings.
             // - HS, DS, GS: hull, domain, and geometry shaders are not currently supported by VRHI.
             // - patchControlPoints: tessellation is not currently supported.
             // - shadingRateState: variable rate shading is not currently supported.
@@ -454,43 +1643,105 @@ struct vhCmdBackendState : public VIDLHandler
         return true;
     }
 
+    // Streams state.constants and state.uniforms into the volatile constant buffers of |shader|, see vhConstantRing.
+    // Values are matched to constant buffers by name. Uniforms go last, so a per-draw value wins over a global one.
+    // Volatile buffers must be written in every command list that reads them, so slots without a value are zeroed.
+    void BE_BindConstants( vhState& state, vhBackendShader& shader, nvrhi::BindingSetDesc& bsetDesc, std::unordered_map< uint32_t, bool >& slotBindingFilled, nvrhi::CommandQueue queue )
+    {
+        for ( const auto& binding : shader.layoutDesc.bindings )
+        {
+            if ( binding.type != nvrhi::ResourceType::VolatileConstantBuffer || slotBindingFilled.count( binding.slot ) )
+                continue;
+
+            const vhShaderReflectionResource* resource = nullptr;
+            for ( const auto& it : shader.reflection )
+            {
+                if ( it.slot == binding.slot && it.type == nvrhi::ResourceType::ConstantBuffer ) { resource = &it; break; }
+            }
+
+            const std::vector< glm::vec4 >* values = nullptr;
+            if ( resource )
+            {
+                for ( const auto& constant : state.constants ) if ( constant.name && resource->name == constant.name ) values = &constant.data;
+                for ( const auto& uniform : state.uniforms ) if ( uniform.name && resource->name == uniform.name ) values = &uniform.data;
+            }
+            if ( !values && ( state.debugFlags & VRHI_STATE_DEBUG_LOG_MISSING_BINDINGS ) )
+            {
+                VRHI_ERR( "vhSetState() : Missing value for constant buffer slot %d! Binding zeroes. (Disable VRHI_STATE_DEBUG_LOG_MISSING_BINDINGS to remove this warning).\n", binding.slot );
+            }
+
+            nvrhi::IBuffer* buffer = constantRing.get( shader.id, binding.slot, resource ? resource->sizeInBytes : 0 );
+            if ( !buffer )
+            {
+                VRHI_ERR( "vhSetState() : Failed to create constant ring buffer for slot %d!\n", binding.slot );
+                continue;
+            }
+
+            // Values larger than the buffer are truncated, smaller ones are padded with zeroes.
+            size_t size = buffer->getDesc().byteSize;
+            size_t valuesSize = values ? values->size() * sizeof( glm::vec4 ) : 0;
+            const void* data = values ? ( const void* ) values->data() : nullptr;
+            if ( valuesSize < size )
+            {
+                constantRing.scratch.assign( size, 0 );
+                if ( valuesSize ) std::memcpy( constantRing.scratch.data(), data, valuesSize );
+                data = constantRing.scratch.data();
+            }
+            if ( state.debugFlags & VRHI_STATE_DEBUG_LOG_ALL_BINDINGS )
+            {
+                VRHI_ERR( "vhSetState() : Binding %zu bytes of constants to slot %d.\n", valuesSize, binding.slot );
+            }
+
+            // Volatile buffer contents live in the command list that writes them, so this has to be the submitting one.
+            auto cmdlist = vhCmdListGet( queue );
+            {
+                std::lock_guard< std::mutex > lock( g_nvRHIStateMutex );
+                cmdlist->writeBuffer( buffer, data, size );
+            }
+            bsetDesc.addItem( nvrhi::BindingSetItem::ConstantBuffer( binding.slot, buffer ) );
+            slotBindingFilled[binding.slot] = true;
+        }
+    }
+
     bool BE_PreSubmitCommon(
         vhState& state,
-        vhBackendShader* shaders,
+        vhBackendShader* const* shaders,
         int shaderCount,
         nvrhi::ComputeState* computeState, // set to nullptr if not using compute.
-        nvrhi::GraphicsState* graphicsState // set to nullptr if not using graphics.
+        nvrhi::GraphicsState* graphicsState, // set to nullptr if not using graphics.
+        nvrhi::CommandQueue queue = nvrhi::CommandQueue::Graphics // queue the submit is recorded on.
     )
     {
-        // TODO: ################ Finish implementation ################
-    
         assert( shaders && shaderCount > 0 );
         bool matchedAny = false;
         bool complete = true;
-        static std::unordered_map< uint32_t, bool > slotBindingFilled;
-        slotBindingFilled.clear();
+        auto& slotBindingFilled = scratchSlotBindingFilled;
 
         for ( int shaderIdx = 0; shaderIdx < shaderCount; ++shaderIdx )
         {
-            auto& shader = shaders[shaderIdx];
+            auto& shader = *shaders[shaderIdx];
             nvrhi::BindingSetDesc bsetDesc = nvrhi::BindingSetDesc();
 
             // We only bind resources for the shader stage that is being used.
             if ( !BE_Util_ShaderStageMatches( shader.flags, computeState != nullptr, graphicsState != nullptr ) )
                 continue;
             matchedAny = true;
+            if ( !shader.layout ) continue; // No bindings, so nothing to bind.
+            slotBindingFilled.clear(); // Every shader has its own binding layout.
 
             // Bind Textures.
             for ( auto& texture : state.textures )
             {
                 if ( texture.texture == VRHI_INVALID_HANDLE ) continue;
-                if ( backendTextures.find( texture.texture ) == backendTextures.end() )
+                auto* it = backendTextures.find( texture.texture );
+                if ( !it )
                 {
                     VRHI_ERR( "vhCreateTexture() : Failed to find texture %u!\n", texture.texture );
                     continue;
                 }
-                assert( backendTextures[texture.texture].get() );
-                auto& btex = *backendTextures[texture.texture];
+                assert( it->get() );
+                auto& btex = **it;
+                BE_MarkQueueUse( btex, queue );
 
                 int32_t slot = texture.slot;
                 nvrhi::ResourceType type = nvrhi::ResourceType::Texture_SRV;
@@ -526,6 +1777,80 @@ struct vhCmdBackendState : public VIDLHandler
                 slotBindingFilled[slot] = true;
             }
 
+            // Bind Buffers. A name picks SRV or UAV from the shader, a slot from computeUAV.
+            for ( const auto& buffer : state.buffers )
+            {
+                if ( buffer.buffer == VRHI_INVALID_HANDLE ) continue;
+                auto* it = backendBuffers.find( buffer.buffer );
+                if ( !it || !( *it )->handle )
+                {
+                    VRHI_ERR( "vhSetState() : Failed to find buffer %u!\n", buffer.buffer );
+                    continue;
+                }
+                auto& bbuf = **it;
+
+                const vhShaderReflectionResource* resource = BE_Util_FindBufferResource( buffer, buffer.computeUAV, shader );
+                if ( !resource )
+                {
+                    if ( state.debugFlags & VRHI_STATE_DEBUG_LOG_MISSING_BINDINGS )
+                    {
+                        VRHI_ERR( "vhSetState() : Missing binding for buffer %u! (Disable VRHI_STATE_DEBUG_LOG_MISSING_BINDINGS to remove this warning).\n", buffer.buffer );
+                    }
+                    continue;
+                }
+                if ( BE_Util_IsBufferUAV( resource->type ) && !( bbuf.flags & VRHI_BUFFER_COMPUTE_WRITE ) )
+                {
+                    VRHI_ERR( "vhSetState() : Buffer %s is bound as a UAV but was not created with VRHI_BUFFER_COMPUTE_WRITE!\n", bbuf.name.c_str() );
+                    continue;
+                }
+                uint64_t byteSize = buffer.byteSize ? buffer.byteSize : bbuf.byteSize - std::min( buffer.byteOffset, bbuf.byteSize );
+                if ( buffer.byteOffset + byteSize > bbuf.byteSize || byteSize == 0 )
+                {
+                    VRHI_ERR( "vhSetState() : Range [%llu, %llu] of buffer %s is out of bounds!\n", buffer.byteOffset, buffer.byteOffset + byteSize, bbuf.name.c_str() );
+                    continue;
+                }
+                BE_MarkQueueUse( bbuf, queue );
+                if ( state.debugFlags & VRHI_STATE_DEBUG_LOG_ALL_BINDINGS )
+                {
+                    VRHI_ERR( "vhSetState() : Binding buffer %u to slot %d.\n", buffer.buffer, resource->slot );
+                }
+
+                nvrhi::BufferRange range( bbuf.poolOffset + buffer.byteOffset, byteSize );
+                nvrhi::BindingSetItem item;
+                switch ( resource->type )
+                {
+                    case nvrhi::ResourceType::StructuredBuffer_SRV: item = nvrhi::BindingSetItem::StructuredBuffer_SRV( resource->slot, bbuf.handle, nvrhi::Format::UNKNOWN, range ); break;
+                    case nvrhi::ResourceType::StructuredBuffer_UAV: item = nvrhi::BindingSetItem::StructuredBuffer_UAV( resource->slot, bbuf.handle, nvrhi::Format::UNKNOWN, range ); break;
+                    case nvrhi::ResourceType::RawBuffer_SRV: item = nvrhi::BindingSetItem::RawBuffer_SRV( resource->slot, bbuf.handle, range ); break;
+                    case nvrhi::ResourceType::RawBuffer_UAV: item = nvrhi::BindingSetItem::RawBuffer_UAV( resource->slot, bbuf.handle, range ); break;
+                    case nvrhi::ResourceType::TypedBuffer_SRV: item = nvrhi::BindingSetItem::TypedBuffer_SRV( resource->slot, bbuf.handle, bbuf.desc.format, range ); break;
+                    default: item = nvrhi::BindingSetItem::TypedBuffer_UAV( resource->slot, bbuf.handle, bbuf.desc.format, range ); break;
+                }
+                bsetDesc.addItem( item );
+                slotBindingFilled[resource->slot] = true;
+            }
+
+            // Bind Samplers.
+            for ( const auto& sampler : state.samplers )
+            {
+                int32_t slot = sampler.name ? BE_Util_ResolveBindingSlot( sampler.name, nvrhi::ResourceType::Sampler, shader ) : sampler.slot;
+                if ( slot == -1 )
+                {
+                    if ( state.debugFlags & VRHI_STATE_DEBUG_LOG_MISSING_BINDINGS )
+                    {
+                        VRHI_ERR( "vhSetState() : Missing binding for sampler %s! (Disable VRHI_STATE_DEBUG_LOG_MISSING_BINDINGS to remove this warning).\n", sampler.name ? sampler.name : "" );
+                    }
+                    continue;
+                }
+                nvrhi::SamplerHandle handle = BE_GetSampler( sampler.flags );
+                if ( !handle ) continue;
+                bsetDesc.addItem( nvrhi::BindingSetItem::Sampler( slot, handle ) );
+                slotBindingFilled[slot] = true;
+            }
+
+            // Bind Constants & Uniforms.
+            BE_BindConstants( state, shader, bsetDesc, slotBindingFilled, queue );
+
             // Iterate layout and fill any empty slots with dummy bindings.
             for ( const auto& binding : shader.layoutDesc.bindings )
             {
@@ -535,54 +1860,562 @@ struct vhCmdBackendState : public VIDLHandler
                 {
                     VRHI_ERR( "vhSetState() : Missing binding for slot %d! Binding dummy resource. (Disable VRHI_STATE_DEBUG_LOG_MISSING_BINDINGS to remove this warning).\n", binding.slot );
                 }
-                // TODO: Dummy resource support.
-                assert( !"Unimplemented!" );
+                bsetDesc.addItem( vhGetDummyBindingItem( binding ) );
+                slotBindingFilled[binding.slot] = true;
+            }
+
+            // Create Binding Set.
+            nvrhi::BindingSetHandle bset = BE_GetBindingSet( bsetDesc, shader.layout );
+            if ( !bset )
+            {
+                VRHI_ERR( "vhSetState() : Failed to create NVRHI binding set for shader %u!\n", shader.handle );
+                complete = false;
+                break;
+            }
+
+            if ( computeState )  computeState->addBindingSet( bset );
+            if ( graphicsState ) graphicsState->addBindingSet( bset );
+        }
+
+        return matchedAny && complete;
+    }
+
+    // Returns the sampler for vhGetSamplerDesc( |flags| ), creating it on first use.
+    nvrhi::SamplerHandle BE_GetSampler( uint64_t flags )
+    {
+        auto it = backendSamplers.find( flags );
+        if ( it != backendSamplers.end() ) return it->second;
+
+        nvrhi::SamplerHandle sampler = nullptr;
+        {
+            std::lock_guard<std::mutex> lock( g_nvRHIStateMutex );
+            sampler = g_vhDevice->createSampler( vhGetSamplerDesc( flags ) );
+        }
+        if ( !sampler )
+        {
+            VRHI_ERR( "vhSetState() : Failed to create sampler for flags 0x%llx!\n", ( unsigned long long ) flags );
+            return nullptr;
+        }
+        backendSamplers[flags] = sampler;
+        return sampler;
+    }
+
+    // Returns the cached binding set for |desc| on |layout|, creating it on a miss.
+    nvrhi::BindingSetHandle BE_GetBindingSet( const nvrhi::BindingSetDesc& desc, nvrhi::BindingLayoutHandle layout )
+    {
+        uint64_t key = vhHashBindingSet( desc, layout );
+        auto it = backendBindingSets.find( key );
+        if ( it != backendBindingSets.end() && it->second.layout == layout && it->second.desc == desc )
+        {
+            bindingSetCacheHits++;
+            return it->second.handle;
+        }
+        bindingSetCacheMisses++;
+
+        nvrhi::BindingSetHandle bset = nullptr;
+        {
+            std::lock_guard<std::mutex> lock( g_nvRHIStateMutex );
+            bset = g_vhDevice->createBindingSet( desc, layout );
+        }
+        if ( !bset ) return nullptr;
+
+        backendBindingSets[key] = { .handle = bset, .layout = layout, .desc = desc };
+        return bset;
+    }
+
+    // Drops every cached binding set that references |resource|.
+    void BE_EvictBindingSets( nvrhi::IResource* resource )
+    {
+        if ( !resource ) return;
+        std::lock_guard< std::mutex > lock( g_nvRHIStateMutex );
+        std::erase_if( backendBindingSets, [resource]( const auto& entry )
+        {
+            const auto& bindings = entry.second.desc.bindings;
+            return std::any_of( bindings.begin(), bindings.end(), [resource]( const nvrhi::BindingSetItem& item ) { return item.resourceHandle == resource; } );
+        } );
+    }
+
+    // Drops every cached binding set that was created against |layout|.
+    void BE_EvictBindingSets( nvrhi::IBindingLayout* layout )
+    {
+        if ( !layout ) return;
+        std::lock_guard< std::mutex > lock( g_nvRHIStateMutex );
+        std::erase_if( backendBindingSets, [layout]( const auto& entry ) { return entry.second.layout == layout; } );
+    }
+
+    // Returns the cached compute pipeline for |state|, creating it on a miss.
+    nvrhi::ComputePipelineHandle BE_GetComputePipeline( vhState& state, vhBackendShader& computeShader )
+    {
+        nvrhi::ComputePipelineDesc desc;
+        vhBackendShader* shader = &computeShader;
+        if ( !BE_PresubmitPipelineDescCommon( state, &shader, 1, &desc, nullptr ) ) return nullptr;
+
+        uint64_t key = vhHashComputePipeline( desc );
+        std::array< nvrhi::ShaderHandle, 5 > stages = { desc.CS };
+        auto it = backendComputePipelines.find( key );
+        if ( it != backendComputePipelines.end() && it->second.matches( stages ) )
+        {
+            pipelineCacheHits++;
+            return it->second.handle;
+        }
+        pipelineCacheMisses++;
+
+        nvrhi::ComputePipelineHandle pipeline = nullptr;
+        {
+            std::lock_guard<std::mutex> lock( g_nvRHIStateMutex );
+            pipeline = g_vhDevice->createComputePipeline( desc );
+        }
+        if ( !pipeline )
+        {
+            VRHI_ERR( "vhDispatch() : Failed to create NVRHI compute pipeline for shader %s!\n", computeShader.name.c_str() );
+            return nullptr;
+        }
+        backendComputePipelines[key] = { .handle = pipeline, .shaders = state.program, .stages = stages };
+        return pipeline;
+    }
+
+    // Returns the cached graphics pipeline for |state| rendering into |fbInfo|, creating it on a miss.
+    nvrhi::GraphicsPipelineHandle BE_GetGraphicsPipeline( vhState& state, vhBackendShader* const* shaders, int shaderCount, const nvrhi::FramebufferInfo& fbInfo )
+    {
+        nvrhi::GraphicsPipelineDesc desc;
+        if ( !BE_PresubmitPipelineDescCommon( state, shaders, shaderCount, nullptr, &desc ) ) return nullptr;
+        return BE_GetGraphicsPipeline( desc, state.program, fbInfo );
+    }
+
+    // Same, for an already translated |desc|, see vhBackendStateBlock.
+    nvrhi::GraphicsPipelineHandle BE_GetGraphicsPipeline( const nvrhi::GraphicsPipelineDesc& desc, const vhProgram& program, const nvrhi::FramebufferInfo& fbInfo )
+    {
+        uint64_t key = vhHashGraphicsPipeline( desc, fbInfo );
+        std::array< nvrhi::ShaderHandle, 5 > stages = { desc.VS, desc.HS, desc.DS, desc.GS, desc.PS };
+        auto it = backendGraphicsPipelines.find( key );
+        if ( it != backendGraphicsPipelines.end() && it->second.matches( stages ) )
+        {
+            pipelineCacheHits++;
+            return it->second.handle;
+        }
+        pipelineCacheMisses++;
+
+        nvrhi::GraphicsPipelineHandle pipeline = nullptr;
+        {
+            std::lock_guard<std::mutex> lock( g_nvRHIStateMutex );
+            pipeline = g_vhDevice->createGraphicsPipeline( desc, fbInfo );
+        }
+        if ( !pipeline )
+        {
+            VRHI_ERR( "vhSubmit() : Failed to create NVRHI graphics pipeline!\n" );
+            return nullptr;
+        }
+        backendGraphicsPipelines[key] = { .handle = pipeline, .shaders = program, .stages = stages };
+        return pipeline;
+    }
+
+    // Drops every cached pipeline that was built from |shader|.
+    void BE_EvictPipelines( vhShader shader )
+    {
+        auto fnBuiltFromShader = [shader]( const auto& entry )
+        {
+            const auto& shaders = entry.second.shaders;
+            return std::find( shaders.begin(), shaders.end(), shader ) != shaders.end();
+        };
+        std::lock_guard< std::mutex > lock( g_nvRHIStateMutex );
+        std::erase_if( backendComputePipelines, fnBuiltFromShader );
+        std::erase_if( backendGraphicsPipelines, fnBuiltFromShader );
+    }
+
+    vhBackendStateBlock* BE_FindStateBlock( vhStateId id )
+    {
+        auto it = backendStateBlocks.find( id );
+        return it == backendStateBlocks.end() ? nullptr : &it->second;
+    }
+
+    // Drops the pipelines of every state block whose program uses |shader|.
+    void BE_EvictStateBlockPipelines( vhShader shader )
+    {
+        for ( auto& [id, block] : backendStateBlocks )
+        {
+            const auto& program = backendStates[id].program;
+            if ( std::find( program.begin(), program.end(), shader ) == program.end() ) continue;
+            std::lock_guard< std::mutex > lock( g_nvRHIStateMutex );
+            block = vhBackendStateBlock();
+        }
+    }
+
+    // Dispatches are recorded on the graphics queue so they stay ordered with draws and copies, unless the state asks
+    // for VRHI_STATE_ASYNC_COMPUTE. Those go to the compute queue, and wait for graphics work pending on the resources
+    // they bind, as graphics work waits for them; see BE_MarkQueueUse(). Either way NVRHI tracks resource states within
+    // the command list and inserts the transitions and UAV barriers between dispatches.
+    // Resources are EXCLUSIVE, so a compute queue in another queue family would need ownership transfers both ways for
+    // everything an async dispatch touches. Those dispatches stay on the graphics queue instead; vhInit() prefers a
+    // second graphics family queue for async compute where the device has one.
+    nvrhi::CommandQueue BE_DispatchQueue( const vhState& state )
+    {
+        if ( !( state.stateFlags & VRHI_STATE_ASYNC_COMPUTE ) || g_QueueFamilyCompute != g_QueueFamilyGraphics ) return nvrhi::CommandQueue::Graphics;
+        return nvrhi::CommandQueue::Compute;
+    }
+
+    bool BE_DispatchCommon( vhState& state, vhBackendShader& computeShader, nvrhi::ComputeState& computeState, const vhBackendStateBlock* block, nvrhi::CommandQueue queue )
+    {
+        assert( computeShader.handle );
+
+        if ( !computeState.pipeline )
+            computeState.setPipeline( block && block->computePipeline ? block->computePipeline : BE_GetComputePipeline( state, computeShader ) );
+        if ( !computeState.pipeline ) return false;
+        vhBackendShader* shader = &computeShader;
+        if ( !BE_PreSubmitCommon( state, &shader, 1, &computeState, nullptr, queue ) ) return false;
+        return true;
+    }
+
+    void BE_Dispatch( vhState& state, vhBackendShader& computeShader, glm::uvec3 workGroupCount, vhQueueToken token, const vhBackendStateBlock* block = nullptr )
+    {
+        auto queue = BE_DispatchQueue( state );
+        nvrhi::ComputeState computeState;
+        if ( !BE_DispatchCommon( state, computeShader, computeState, block, queue ) ) return;
+
+        auto cmdlist = vhCmdListGet( queue );
+        {
+            std::lock_guard<std::mutex> lock( g_nvRHIStateMutex );
+            cmdlist->setComputeState( computeState );
+            cmdlist->dispatch( workGroupCount.x, workGroupCount.y, workGroupCount.z );
+        }
+        BE_RecordQueueToken( token, queue );
+    }
+
+    void BE_DispatchIndirect( vhState& state, vhBackendShader& computeShader, vhBackendBuffer& indirectBuffer, uint64_t byteOffset, vhQueueToken token, const vhBackendStateBlock* block = nullptr )
+    {
+        // NOTE: byteOffset should be 4-byte aligned (checked in frontend).
+        if ( !( indirectBuffer.flags & VRHI_BUFFER_DRAW_INDIRECT ) )
+        {
+            VRHI_ERR( "vhDispatchIndirect() : Buffer %s was not created with VRHI_BUFFER_DRAW_INDIRECT!\n", indirectBuffer.name.c_str() );
+            return;
+        }
+
+        auto queue = BE_DispatchQueue( state );
+        nvrhi::ComputeState computeState;
+        computeState.setIndirectParams( indirectBuffer.handle );
+        if ( !BE_DispatchCommon( state, computeShader, computeState, block, queue ) ) return;
+        BE_MarkQueueUse( indirectBuffer, queue );
+
+        auto cmdlist = vhCmdListGet( queue );
+        {
+            std::lock_guard<std::mutex> lock( g_nvRHIStateMutex );
+            cmdlist->setComputeState( computeState );
+            cmdlist->dispatchIndirect( ( uint32_t ) byteOffset );
+        }
+        BE_RecordQueueToken( token, queue );
+    }
+
+    void BE_DispatchBatch( const vhDispatchDesc* descs, uint32_t count, vhQueueToken token )
+    {
+        auto& batch = scratchDispatchBatch;
+        batch.clear();
+
+        for ( uint32_t i = 0; i < count; i++ )
+        {
+            const auto& desc = descs[i];
+            if ( desc.stateID == VRHI_INVALID_HANDLE || desc.workGroupCount.x == 0 || desc.workGroupCount.y == 0 || desc.workGroupCount.z == 0 ) continue;
+
+            auto itState = backendStates.find( desc.stateID );
+            if ( itState == backendStates.end() )
+            {
+                VRHI_ERR( "vhDispatchBatch: State %llu not found!\n", desc.stateID );
+                continue;
+            }
+            auto& state = itState->second;
+            if ( state.program.empty() )
+            {
+                VRHI_ERR( "vhDispatchBatch: State %llu has no program set!\n", desc.stateID );
+                continue;
+            }
+            auto* itShader = backendShaders.find( state.program[0] );
+            if ( !itShader )
+            {
+                VRHI_ERR( "vhDispatchBatch: Shader %llu not found for state %llu!\n", state.program[0], desc.stateID );
+                continue;
+            }
+
+            auto* block = BE_FindStateBlock( desc.stateID );
+            auto pipeline = block && block->computePipeline ? block->computePipeline : BE_GetComputePipeline( state, **itShader );
+            if ( !pipeline ) continue;
+
+            batch.push_back( { &state, itShader->get(), block, pipeline, BE_DispatchQueue( state ), desc.stateID, desc.workGroupCount } );
+        }
+
+        // Group by queue, then pipeline, then state, so consecutive dispatches share binds. NVRHI skips binding a
+        // pipeline or binding set that is already bound.
+        std::stable_sort( batch.begin(), batch.end(), []( const vhBatchedDispatch& a, const vhBatchedDispatch& b )
+        {
+            if ( a.queue != b.queue ) return a.queue < b.queue;
+            if ( a.pipeline != b.pipeline ) return a.pipeline.Get() < b.pipeline.Get();
+            return a.stateID < b.stateID;
+        } );
+
+        // NVRHI tracks the state of every texture and buffer, so dispatches that share no resources get no barriers in
+        // between. UAV barriers are only placed between dispatches writing the same texture or buffer, and those stay:
+        // entries may write overlapping ranges, or read what an earlier one wrote.
+        for ( const auto& entry : batch )
+        {
+            nvrhi::ComputeState computeState;
+            computeState.setPipeline( entry.pipeline );
+            if ( !BE_DispatchCommon( *entry.state, *entry.shader, computeState, entry.block, entry.queue ) ) continue;
+
+            auto cmdlist = vhCmdListGet( entry.queue );
+            std::lock_guard<std::mutex> lock( g_nvRHIStateMutex );
+            cmdlist->setComputeState( computeState );
+            cmdlist->dispatch( entry.workGroupCount.x, entry.workGroupCount.y, entry.workGroupCount.z );
+        }
+
+        for ( size_t i = 0; i < batch.size(); i++ )
+        {
+            if ( i == 0 || batch[i].queue != batch[i - 1].queue ) BE_RecordQueueToken( token, batch[i].queue );
+        }
+    }
+
+    // Ties |token| to the command list currently recording on |queue|.
+    void BE_RecordQueueToken( vhQueueToken token, nvrhi::CommandQueue queue )
+    {
+        if ( token ) queueTokens[token].serials[( uint64_t ) queue] = vhCmdListOpenSerial( queue );
+    }
+
+    void BE_PruneQueueTokens()
+    {
+        std::erase_if( queueTokens, []( const auto& entry )
+        {
+            for ( uint64_t queue = 0; queue < ( uint64_t ) nvrhi::CommandQueue::Count; queue++ )
+            {
+                uint64_t serial = entry.second.serials[queue];
+                if ( serial != UINT64_MAX && !vhCmdListSerialComplete( ( nvrhi::CommandQueue ) queue, serial ) ) return false;
+            }
+            return true;
+        } );
+    }
+
+    // Clears the attachments of |state| as its clearFlags ask. clearRgba is 0xRRGGBBAA.
+    void BE_ClearAttachments( const vhState& state )
+    {
+        if ( !( state.clearFlags & ( VRHI_CLEAR_COLOR | VRHI_CLEAR_DEPTH | VRHI_CLEAR_STENCIL ) ) ) return;
+
+        auto cmdlist = vhCmdListGet( nvrhi::CommandQueue::Graphics );
+        std::lock_guard<std::mutex> lock( g_nvRHIStateMutex );
+        if ( state.clearFlags & VRHI_CLEAR_COLOR )
+        {
+            uint32_t rgba = state.clearRgba;
+            nvrhi::Color colour( ( rgba >> 24 ) / 255.0f, ( ( rgba >> 16 ) & 0xFF ) / 255.0f, ( ( rgba >> 8 ) & 0xFF ) / 255.0f, ( rgba & 0xFF ) / 255.0f );
+            for ( const auto& target : state.colourAttachment )
+            {
+                auto* it = backendTextures.find( target.texture );
+                if ( it && ( *it )->handle ) cmdlist->clearTextureFloat( ( *it )->handle, nvrhi::TextureSubresourceSet( target.mipLevel, 1, target.arrayLayer, 1 ), colour );
+            }
+        }
+        if ( state.clearFlags & ( VRHI_CLEAR_DEPTH | VRHI_CLEAR_STENCIL ) )
+        {
+            const auto& target = state.depthAttachment;
+            auto* it = backendTextures.find( target.texture );
+            if ( it && ( *it )->handle )
+            {
+                cmdlist->clearDepthStencilTexture( ( *it )->handle, nvrhi::TextureSubresourceSet( target.mipLevel, 1, target.arrayLayer, 1 ),
+                    ( state.clearFlags & VRHI_CLEAR_DEPTH ) != 0, state.clearDepth, ( state.clearFlags & VRHI_CLEAR_STENCIL ) != 0, state.clearStencil );
+            }
+        }
+    }
+
+    // Fills |graphicsState| with everything |state| needs to draw. |outIndexed| is set if it has an index buffer.
+    bool BE_PrepareDraw( vhStateId stateID, vhState& state, nvrhi::GraphicsState& graphicsState, bool& outIndexed )
+    {
+        auto& shaders = scratchDrawShaders;
+        auto& colours = scratchDrawColours;
+        shaders.clear();
+        colours.clear();
+
+        for ( vhShader shader : state.program )
+        {
+            auto* it = backendShaders.find( shader );
+            if ( !it )
+            {
+                VRHI_ERR( "vhSubmit: Shader %u not found for state %llu!\n", shader, stateID );
+                return false;
             }
+            if ( BE_Util_ShaderStageMatches( ( *it )->flags, false, true ) ) shaders.push_back( it->get() );
+        }
+        if ( shaders.empty() )
+        {
+            VRHI_ERR( "vhSubmit: State %llu has no graphics program set!\n", stateID );
+            return false;
+        }
+
+        for ( const auto& target : state.colourAttachment ) colours.push_back( target.texture );
+        if ( colours.empty() && state.depthAttachment.texture == VRHI_INVALID_HANDLE )
+        {
+            VRHI_ERR( "vhSubmit: State %llu has no attachments!\n", stateID );
+            return false;
+        }
+        const auto& first = colours.empty() ? state.depthAttachment : state.colourAttachment[0];
+        nvrhi::FramebufferHandle framebuffer = BE_GetFrameBuffer( colours, state.depthAttachment.texture, first.mipLevel, first.arrayLayer );
+        if ( !framebuffer )
+        {
+            VRHI_ERR( "vhSubmit: Failed to create framebuffer for state %llu!\n", stateID );
+            return false;
+        }
+        const nvrhi::FramebufferInfoEx& fbInfo = framebuffer->getFramebufferInfo();
+
+        auto* block = BE_FindStateBlock( stateID );
+        nvrhi::GraphicsPipelineHandle pipeline = block && block->graphicsPipeline ? block->graphicsPipeline : BE_GetGraphicsPipeline( state, shaders.data(), ( int ) shaders.size(), fbInfo );
+        if ( !pipeline ) return false;
+        graphicsState.setPipeline( pipeline ).setFramebuffer( framebuffer );
+
+        // viewRect and viewScissor are ( x, y, width, height ) in pixels. An empty rect covers the whole framebuffer.
+        glm::vec4 rect = state.viewRect;
+        if ( rect.z <= 0.0f || rect.w <= 0.0f ) rect = glm::vec4( 0.0f, 0.0f, ( float ) fbInfo.width, ( float ) fbInfo.height );
+        nvrhi::Viewport viewport( rect.x, rect.x + rect.z, rect.y, rect.y + rect.w, 0.0f, 1.0f );
+        nvrhi::Rect scissor( viewport );
+        const glm::vec4& sr = state.viewScissor;
+        if ( sr.z > 0.0f && sr.w > 0.0f ) scissor = nvrhi::Rect( ( int ) sr.x, ( int ) ( sr.x + sr.z ), ( int ) sr.y, ( int ) ( sr.y + sr.w ) );
+        graphicsState.viewport.addViewport( viewport ).addScissorRect( scissor );
 
-            // Create Binding Set.
-            nvrhi::BindingSetHandle bset = nullptr;
+        for ( const auto& binding : state.vertexBindings )
+        {
+            if ( binding.buffer == VRHI_INVALID_HANDLE ) continue;
+            auto* it = backendBuffers.find( binding.buffer );
+            if ( !it || !( *it )->handle )
             {
-                std::lock_guard<std::mutex> lock( g_nvRHIStateMutex );
-                bset = g_vhDevice->createBindingSet( bsetDesc, shader.layout );
+                VRHI_ERR( "vhSubmit: Vertex buffer %u not found for state %llu!\n", binding.buffer, stateID );
+                return false;
             }
-            if ( !bset )
+            auto& bbuf = **it;
+            BE_MarkGraphicsUse( bbuf );
+            graphicsState.addVertexBuffer( {
+                .buffer = bbuf.handle,
+                .slot = binding.stream,
+                .offset = bbuf.poolOffset + binding.byteOffset + ( uint64_t ) binding.startVertex * bbuf.stride
+            } );
+        }
+
+        outIndexed = false;
+        if ( state.indexBinding.buffer != VRHI_INVALID_HANDLE )
+        {
+            auto* it = backendBuffers.find( state.indexBinding.buffer );
+            if ( !it || !( *it )->handle )
             {
-                VRHI_ERR( "vhSetState() : Failed to create NVRHI binding set for shader %u!\n", shader.handle );
-                complete = false;
-                break;
+                VRHI_ERR( "vhSubmit: Index buffer %u not found for state %llu!\n", state.indexBinding.buffer, stateID );
+                return false;
             }
+            auto& bbuf = **it;
 
-            if ( computeState )  computeState->addBindingSet( bset );
-            if ( graphicsState ) graphicsState->addBindingSet( bset );
+            // NVRHI takes a 32-bit index buffer offset, which pooled buffers add their place in the pool to.
+            uint64_t offset = bbuf.poolOffset + state.indexBinding.byteOffset;
+            if ( state.indexBinding.byteOffset >= bbuf.byteSize || offset > UINT32_MAX )
+            {
+                VRHI_ERR( "vhSubmit: Index buffer offset %llu is out of range for %s in state %llu!\n", state.indexBinding.byteOffset, bbuf.name.c_str(), stateID );
+                return false;
+            }
+            BE_MarkGraphicsUse( bbuf );
+            graphicsState.setIndexBuffer( {
+                .buffer = bbuf.handle,
+                .format = ( bbuf.flags & VRHI_BUFFER_INDEX32 ) ? nvrhi::Format::R32_UINT : nvrhi::Format::R16_UINT,
+                .offset = ( uint32_t ) offset
+            } );
+            outIndexed = true;
         }
 
-        return matchedAny && complete;
+        return BE_PreSubmitCommon( state, shaders.data(), ( int ) shaders.size(), nullptr, &graphicsState );
     }
 
-    void BE_Dispatch( vhState& state, vhBackendShader& computeShader, glm::uvec3 workGroupCount )
+    // Sorts the draws of |frame| by key and records them on the graphics queue, then submits it. Consecutive draws of
+    // the same state share one setGraphicsState(); NVRHI skips rebinding a pipeline or binding set that is already bound.
+    // Clears all go first, in submission order, so a state sorted after another can't clear away its draws.
+    void BE_RecordFrame( uint64_t index, vhBackendFrame& frame )
     {
-        // Suggested Implementation:
-        // 1. Get Compute Queue command list: auto cmdlist = vhCmdListGet( nvrhi::CommandQueue::Compute );
-        // 2. Create/Get Compute Pipeline (using nvrhi::ComputePipelineDesc with computeShader.handle).
-        // 3. Bind Compute Pipeline to cmdlist.
-        // 4. Bind Resources (descriptors, push constants, uniforms) to cmdlist (using state).
-        //    IMPORTANT: Skip Viewport/Scissor as they are not for compute.
-        // 5. cmdlist->dispatch( workGroupCount.x, workGroupCount.y, workGroupCount.z );
+        auto& keys = scratchFrameKeys;
+        auto& tempKeys = scratchFrameTempKeys;
+        auto& order = scratchFrameOrder;
+        auto& tempOrder = scratchFrameTempOrder;
+        auto& cleared = scratchFrameCleared;
+        const auto& draws = frame.draws;
+        size_t count = draws.size();
 
-        assert( computeShader.handle );
+        auto start = std::chrono::high_resolution_clock::now();
+        keys.resize( count );
+        tempKeys.resize( count );
+        order.resize( count );
+        tempOrder.resize( count );
+        for ( size_t i = 0; i < count; i++ )
+        {
+            keys[i] = draws[i].sortKey;
+            order[i] = ( uint32_t ) i;
+        }
+        vhRadixSort64( keys.data(), order.data(), tempKeys.data(), tempOrder.data(), count );
+        auto sorted = std::chrono::high_resolution_clock::now();
+
+        cleared.clear();
+        for ( const vhDraw& draw : draws )
+        {
+            if ( !cleared.insert( draw.stateID ).second ) continue;
+            auto itState = backendStates.find( draw.stateID );
+            if ( itState != backendStates.end() ) BE_ClearAttachments( itState->second );
+        }
+
+        vhFrameStats stats;
+        stats.frame = index;
+        nvrhi::IGraphicsPipeline* lastPipeline = nullptr;
+        for ( size_t begin = 0, end = 0; begin < count; begin = end )
+        {
+            vhStateId stateID = draws[order[begin]].stateID;
+            for ( end = begin + 1; end < count && draws[order[end]].stateID == stateID; end++ );
+
+            auto itState = backendStates.find( stateID );
+            if ( itState == backendStates.end() )
+            {
+                VRHI_ERR( "vhSubmit: State %llu not found!\n", stateID );
+                continue;
+            }
+            auto& state = itState->second;
+
+            nvrhi::GraphicsState graphicsState;
+            bool indexed = false;
+            if ( !BE_PrepareDraw( stateID, state, graphicsState, indexed ) ) continue;
+
+            auto cmdlist = vhCmdListGet( nvrhi::CommandQueue::Graphics );
+            std::lock_guard<std::mutex> lock( g_nvRHIStateMutex );
+            cmdlist->setGraphicsState( graphicsState );
+            for ( size_t i = begin; i < end; i++ )
+            {
+                const vhDraw& draw = draws[order[i]];
+                auto args = nvrhi::DrawArguments()
+                    .setVertexCount( draw.vertexCount )
+                    .setInstanceCount( draw.instanceCount )
+                    .setStartInstanceLocation( draw.startInstance );
+                if ( indexed )
+                {
+                    cmdlist->drawIndexed( args.setStartIndexLocation( state.indexBinding.firstIndex + draw.startVertex ) );
+                }
+                else
+                {
+                    cmdlist->draw( args.setStartVertexLocation( draw.startVertex ) );
+                }
+            }
+            if ( graphicsState.pipeline != lastPipeline ) stats.pipelineChanges++;
+            lastPipeline = graphicsState.pipeline;
+            stats.stateChanges++;
+            stats.draws += end - begin;
+        }
+        vhCmdListFlush( nvrhi::CommandQueue::Graphics );
+        auto recorded = std::chrono::high_resolution_clock::now();
 
+        stats.sortMs = std::chrono::duration< double, std::milli >( sorted - start ).count();
+        stats.recordMs = std::chrono::duration< double, std::milli >( recorded - sorted ).count();
+        frameStats = stats;
     }
 
-    void BE_DispatchIndirect( vhState& state, vhBackendShader& computeShader, vhBackendBuffer& indirectBuffer, uint64_t byteOffset )
+    // Records every complete frame that is due, in order.
+    void BE_RecordFrames()
     {
-        // Suggested Implementation:
-        // 1. Get Compute Queue command list: auto cmdlist = vhCmdListGet( nvrhi::CommandQueue::Compute );
-        // 2. Validate indirect buffer flags: 
-        //    if ( !(indirectBuffer.flags & VRHI_BUFFER_DRAW_INDIRECT) ) return;
-        // 3. Validate state and create/bind Compute Pipeline (similar to BE_Dispatch).
-        // 4. Bind Resources (using state).
-        // 5. cmdlist->dispatchIndirect( indirectBuffer.handle, byteOffset );
-        // NOTE: byteOffset should be 4-byte aligned (checked in frontend, but check here if needed).
+        while ( !pendingFrames.empty() )
+        {
+            auto it = pendingFrames.begin();
+            if ( it->first != nextFrame || it->second.received != it->second.expected ) return;
+            BE_RecordFrame( it->first, it->second );
+            pendingFrames.erase( it );
+            nextFrame++;
+        }
     }
 
     void BE_BlitBuffer( vhBackendBuffer& dst, vhBackendBuffer& src, uint64_t dstOffset, uint64_t srcOffset, uint64_t size )
@@ -590,16 +2423,37 @@ struct vhCmdBackendState : public VIDLHandler
         // Should already have been validated by handler.
         assert( dst.handle );
         assert( src.handle );
-        assert( dstOffset + size <= dst.desc.byteSize );
-        assert( srcOffset + size <= src.desc.byteSize );
+        assert( dstOffset + size <= dst.byteSize );
+        assert( srcOffset + size <= src.byteSize );
 
         auto cmdlist = vhCmdListGet( nvrhi::CommandQueue::Graphics );
+        BE_MarkGraphicsUse( dst );
+        BE_MarkGraphicsUse( src );
         {
             std::lock_guard<std::mutex> lock( g_nvRHIStateMutex );
-            cmdlist->copyBuffer( dst.handle, dstOffset, src.handle, srcOffset, size );
+            cmdlist->copyBuffer( dst.handle, dst.poolOffset + dstOffset, src.handle, src.poolOffset + srcOffset, size );
+        }
+    }
+
+    // Tickets are issued in order, but commands from different threads can reach us out of order. Publish the
+    // completed watermark only once every ticket up to it has been processed, then wake the waiters.
+    void BE_CompleteTicket( std::set< uint64_t >& outOfOrder, std::atomic< uint64_t >& watermark, uint64_t ticket )
+    {
+        if ( !ticket ) return;
+        uint64_t completed = watermark.load( std::memory_order_relaxed );
+        outOfOrder.insert( ticket );
+        while ( !outOfOrder.empty() && *outOfOrder.begin() == completed + 1 )
+        {
+            outOfOrder.erase( outOfOrder.begin() );
+            completed++;
         }
+        watermark.store( completed, std::memory_order_release );
+        watermark.notify_all();
     }
 
+    void BE_CompleteFlushTicket( vhFlushTicket ticket ) { BE_CompleteTicket( flushTicketsOutOfOrder, g_vhFlushTicketCompleted, ticket ); }
+    void BE_CompleteReadbackTicket( vhReadbackTicket ticket ) { BE_CompleteTicket( readbackTicketsOutOfOrder, g_vhReadbackTicketCompleted, ticket ); }
+
 public:
     void init()
     {
@@ -609,11 +2463,34 @@ public:
     void shutdown()
     {
         std::lock_guard< std::mutex > lock( backendMutex );
+        stagingRing.clear();
+        uploadArena.clear();
+
+        // vhShutdown() finishes first, so nothing should be left in flight. Release any waiters regardless.
+        for ( const auto& readback : pendingReadbacks ) BE_CompleteReadbackTicket( readback.ticket );
+        pendingReadbacks.clear();
+        readbackPool.freeBuffers.clear();
         std::lock_guard< std::mutex > lock2( g_nvRHIStateMutex );
         backendTextures.clear();
         backendBuffers.clear();
+        pendingPoolReleases.clear();
+        backendBufferPools.clear();
         backendShaders.clear();
+        backendStateBlocks.clear();
+        queueTokens.clear();
+        pendingFrames.clear();
+        constantRing.clear();
         backendFramebuffers.clear();
+        backendComputePipelines.clear();
+        backendGraphicsPipelines.clear();
+        backendInputLayouts.clear();
+        backendSamplers.clear();
+        backendBindingSets.clear();
+        textureSnapshots.clear();
+        bufferSnapshots.clear();
+        shaderSnapshots.clear();
+        stateSnapshots.clear();
+        stateSnapshotsDirty.clear();
     }
 
 
@@ -630,7 +2507,7 @@ public:
         }
 
         // Ensure entry exists to make subsequent Destroy/Update safe
-        if ( backendTextures.find( cmd->texture ) == backendTextures.end() )
+        if ( !backendTextures.contains( cmd->texture ) )
         {
             backendTextures[ cmd->texture ] = std::make_unique<vhBackendTexture>();
         }
@@ -651,12 +2528,17 @@ public:
             return;
         }
 
-        if ( backendTextures.find( cmd->texture ) == backendTextures.end() )
+        auto* it = backendTextures.find( cmd->texture );
+        if ( !it )
         {
             VRHI_ERR( "vhDestroyTexture() : Texture %d not found!\n", cmd->texture );
             return;
         }
 
+        BE_EvictBindingSets( ( *it )->handle.Get() );
+        BE_EvictFramebuffers( ( *it )->handle.Get() );
+        textureSnapshots.remove( cmd->texture );
+
         // Destroy texture by releasing our reference. NVRHI handles GPU destruction safety.
         {
             std::lock_guard< std::mutex > lock( g_nvRHIStateMutex );
@@ -710,6 +2592,7 @@ public:
 
         // Calculate metadata for the texture.
         auto btex = std::make_unique< vhBackendTexture >();
+        btex->id = cmd->texture;
         btex->handle = texture;
         btex->name = temps;
         btex->info.target = cmd->target;
@@ -725,6 +2608,12 @@ public:
             BE_UpdateTexture( *btex, cmd->data );
         }
 
+        BE_PublishTexture( *btex );
+        if ( auto* it = backendTextures.find( cmd->texture ) )
+        {
+            BE_EvictBindingSets( ( *it )->handle.Get() );
+            BE_EvictFramebuffers( ( *it )->handle.Get() );
+        }
         backendTextures[ cmd->texture ] = std::move( btex );
     }
 
@@ -738,13 +2627,13 @@ public:
             return;
         }
 
-        auto it = backendTextures.find( cmd->texture );
-        if ( it == backendTextures.end() )
+        auto* it = backendTextures.find( cmd->texture );
+        if ( !it )
         {
             VRHI_ERR( "vhUpdateTexture() : Texture %d not found!\n", cmd->texture );
             return;
         }
-        auto& btex = *it->second;
+        auto& btex = **it;
 
         // Calculate expected data size for the range.
         int32_t mipStart = cmd->startMips, mipEnd = cmd->startMips + cmd->numMips;
@@ -776,30 +2665,51 @@ public:
         BE_UpdateTexture( btex, cmd->data, range );
     }
 
-    void Handle_vhReadTextureSlow( VIDL_vhReadTextureSlow* cmd ) override
+    void Handle_vhReadTextureAsyncInternal( VIDL_vhReadTextureAsyncInternal* cmd ) override
     {
         BE_CmdRAII cmdRAII( cmd );
         // NO dataRAII here - outData is owned by the caller.
 
         if ( cmd->texture == VRHI_INVALID_HANDLE )
         {
+            BE_CompleteReadbackTicket( cmd->ticket );
             return;
         }
 
-        if ( backendTextures.find( cmd->texture ) == backendTextures.end() )
+        auto* it = backendTextures.find( cmd->texture );
+        if ( !it || !( *it )->handle )
         {
-            VRHI_ERR( "vhReadTextureSlow() : Texture %d not found!\n", cmd->texture );
+            VRHI_ERR( "vhReadTextureAsync() : Texture %d not found!\n", cmd->texture );
+            BE_CompleteReadbackTicket( cmd->ticket );
             return;
         }
 
-        auto& btex = *backendTextures[ cmd->texture ];
-        if ( btex.info.target == nvrhi::TextureDimension::Texture3D )
+        auto& btex = **it;
+        int32_t mipStart = cmd->startMips, layerStart = cmd->startLayers;
+        int32_t mipEnd = cmd->numMips > 0 ? mipStart + cmd->numMips : btex.info.mipLevels;
+        int32_t layerEnd = cmd->numLayers > 0 ? layerStart + cmd->numLayers : btex.info.arrayLayers;
+        if ( mipStart < 0 || mipStart >= mipEnd || mipEnd > btex.info.mipLevels ||
+             layerStart < 0 || layerStart >= layerEnd || layerEnd > btex.info.arrayLayers )
         {
-            VRHI_ERR( "vhReadTextureSlow() : 3D textures are not supported for readback yet!\n" );
+            VRHI_ERR( "vhReadTextureAsync() : Mips [%d, %d) / layers [%d, %d) out of range for %s!\n", mipStart, mipEnd, layerStart, layerEnd, btex.name.c_str() );
+            BE_CompleteReadbackTicket( cmd->ticket );
             return;
         }
+        if ( nvrhi::getFormatInfo( btex.info.format ).hasStencil )
+        {
+            VRHI_ERR( "vhReadTextureAsync() : Stencil formats are not supported for readback!\n" );
+            BE_CompleteReadbackTicket( cmd->ticket );
+            return;
+        }
+
+        BE_ReadbackTexture( btex, mipStart, mipEnd, layerStart, layerEnd, cmd->ticket, cmd->outData );
+    }
 
-        BE_ReadTextureSlow( btex, cmd->outData, cmd->mip, cmd->layer );
+    void Handle_vhRetireReadbacksInternal( VIDL_vhRetireReadbacksInternal* cmd ) override
+    {
+        BE_CmdRAII cmdRAII( cmd );
+        g_vhReadbackPollPending = false;
+        BE_RetireReadbacks( cmd->waitTicket );
     }
 
     void Handle_vhBlitTexture( VIDL_vhBlitTexture* cmd ) override
@@ -811,15 +2721,15 @@ public:
             return;
         }
 
-        auto itDst = backendTextures.find( cmd->dst );
-        auto itSrc = backendTextures.find( cmd->src );
-        if ( itDst == backendTextures.end() || itSrc == backendTextures.end() )
+        auto* itDst = backendTextures.find( cmd->dst );
+        auto* itSrc = backendTextures.find( cmd->src );
+        if ( !itDst || !itSrc )
         {
             VRHI_ERR( "vhBlitTexture() : Texture handle(s) %d or %d not found!\n", cmd->dst, cmd->src );
             return;
         }
-        auto& bdst = *itDst->second;
-        auto& bsrc = *itSrc->second;
+        auto& bdst = **itDst;
+        auto& bsrc = **itSrc;
 
         glm::ivec3 extent = cmd->extent;
         if ( extent.x <= 0 || extent.y <= 0 )
@@ -860,18 +2770,19 @@ public:
         }
 
         // Ensure entry exists to make subsequent Destroy/Update safe
-        if ( backendBuffers.find( cmd->buffer ) == backendBuffers.end() )
+        if ( !backendBuffers.contains( cmd->buffer ) )
         {
             backendBuffers[ cmd->buffer ] = std::make_unique<vhBackendBuffer>();
         }
     }
 
     void Handle_vhCreateBufferCommon_Internal( const char* fn, vhBuffer buffer, nvrhi::BufferDesc& desc, const char* name, const char* autoname,
-        const vhMem* data, uint64_t count, uint64_t stride, uint64_t flags )
+        const vhMem* data, uint64_t count, uint64_t stride, uint64_t flags, std::vector< vhVertexLayoutDef >* vertexLayout = nullptr )
     {
         if ( buffer == VRHI_INVALID_HANDLE ) return;
 
-        if ( backendBuffers.find( buffer ) != backendBuffers.end() && backendBuffers[buffer]->handle )
+        auto* existing = backendBuffers.find( buffer );
+        if ( existing && *existing && ( *existing )->handle )
         {
             VRHI_ERR( "%s() : Buffer %d already exists!\n", fn, buffer );
             return;
@@ -902,30 +2813,33 @@ public:
             .setIsDrawIndirectArgs( flags & VRHI_BUFFER_DRAW_INDIRECT )
             .setDebugName( (name && name[0]) ? name : temps );
 
-        nvrhi::BufferHandle bhandle = nullptr;
+        auto bbuf = std::make_unique< vhBackendBuffer >();
+        if ( !BE_AllocPooledBuffer( *bbuf, bufferDesc, flags ) )
         {
             std::lock_guard< std::mutex > lock( g_nvRHIStateMutex );
-            bhandle = g_vhDevice->createBuffer( bufferDesc );
+            bbuf->handle = g_vhDevice->createBuffer( bufferDesc );
         }
 
-        if ( !bhandle )
+        if ( !bbuf->handle )
         {
             VRHI_ERR( "%s() : Failed to create bhandle!\n", fn );
             return;
         }
 
-        auto bbuf = std::make_unique< vhBackendBuffer >();
-        bbuf->handle = bhandle;
         bbuf->name = ( name && name[0] ) ? name : temps;
+        bbuf->id = buffer;
         bbuf->desc = bufferDesc;
+        bbuf->byteSize = byteSize;
         bbuf->stride = ( uint32_t ) stride;
         bbuf->flags = flags;
+        if ( vertexLayout ) bbuf->vertexLayout = std::move( *vertexLayout );
 
         if ( data )
         {
             BE_UpdateBuffer( *bbuf, 0, data );
         }
 
+        BE_PublishBuffer( *bbuf );
         backendBuffers[ buffer ] = std::move( bbuf );
     }
 
@@ -933,12 +2847,13 @@ public:
     {
         if ( buffer == VRHI_INVALID_HANDLE ) return;
 
-        if ( backendBuffers.find( buffer ) == backendBuffers.end() )
+        auto* it = backendBuffers.find( buffer );
+        if ( !it )
         {
             VRHI_ERR( "%s() : Buffer %d not found!\n", fn, buffer );
             return;
         }
-        auto& bbuf = backendBuffers[ buffer ];
+        auto& bbuf = *it;
 
         // Convert element offset to byte offset
         uint64_t byteOffset = 0;
@@ -955,10 +2870,10 @@ public:
 
         if ( data )
         {
-            if ( byteOffset + data->size() > bbuf->desc.byteSize && !( bbuf->flags & VRHI_BUFFER_ALLOW_RESIZE ) )
+            if ( byteOffset + data->size() > bbuf->byteSize && !( bbuf->flags & VRHI_BUFFER_ALLOW_RESIZE ) )
             {
                 VRHI_ERR( "%s() : Update range [%llu, %llu] exceeds buffer size %llu!\n", 
-                    fn, byteOffset, byteOffset + data->size(), bbuf->desc.byteSize );
+                    fn, byteOffset, byteOffset + data->size(), bbuf->byteSize );
                 return;
             }
             BE_UpdateBuffer( *bbuf, byteOffset, data );
@@ -1007,7 +2922,7 @@ public:
         desc.setIsVertexBuffer( true );
         desc.enableAutomaticStateTracking( nvrhi::ResourceStates::VertexBuffer );
 
-        Handle_vhCreateBufferCommon_Internal( "vhCreateVertexBuffer", cmd->buffer, desc, cmd->name, "VertexBuffer", cmd->data, cmd->numVerts, stride, cmd->flags );
+        Handle_vhCreateBufferCommon_Internal( "vhCreateVertexBuffer", cmd->buffer, desc, cmd->name, "VertexBuffer", cmd->data, cmd->numVerts, stride, cmd->flags, &layoutDefs );
     }
 
     void Handle_vhUpdateVertexBuffer( VIDL_vhUpdateVertexBuffer* cmd ) override
@@ -1106,6 +3021,60 @@ public:
         Handle_vhUpdateBufferCommon_Internal( "vhUpdateStorageBuffer", cmd->buffer, cmd->offset, cmd->data, cmd->size, true );
     }
 
+    void Handle_vhCommitUploadInternal( VIDL_vhCommitUploadInternal* cmd ) override
+    {
+        BE_CmdRAII cmdRAII( cmd );
+        const auto& mapping = cmd->mapping;
+
+        auto queue = nvrhi::CommandQueue::Count;
+        auto staging = uploadArena.lookup( mapping.chunk, mapping.chunkOffset );
+        if ( !staging.buffer )
+        {
+            VRHI_ERR( "vhCommitUpload() : Mapping is not from vhMapTextureUpload() / vhMapBufferUpload()!\n" );
+            return;
+        }
+
+        if ( mapping.texture != VRHI_INVALID_HANDLE )
+        {
+            queue = BE_CommitTextureUpload( mapping, staging );
+        }
+        else if ( mapping.buffer != VRHI_INVALID_HANDLE )
+        {
+            queue = BE_CommitBufferUpload( mapping, staging );
+        }
+
+        // Unpin before a transfer flush can move the copy queue on to its next serial.
+        uploadArena.unpin( mapping.chunk, queue );
+        if ( queue == nvrhi::CommandQueue::Copy )
+        {
+            g_vhCmdListTransferSizeHeuristic += mapping.size;
+            vhCmdListFlushTransferIfNeeded();
+        }
+    }
+
+    void Handle_vhReserveBuffer( VIDL_vhReserveBuffer* cmd ) override
+    {
+        BE_CmdRAII cmdRAII( cmd );
+        if ( cmd->buffer == VRHI_INVALID_HANDLE ) return;
+
+        auto* it = backendBuffers.find( cmd->buffer );
+        if ( !it || !( *it )->handle )
+        {
+            VRHI_ERR( "vhReserveBuffer() : Buffer %d not found!\n", cmd->buffer );
+            return;
+        }
+        auto& bbuf = **it;
+
+        if ( !( bbuf.flags & VRHI_BUFFER_ALLOW_RESIZE ) )
+        {
+            VRHI_ERR( "vhReserveBuffer() : %s does not have the ALLOW_RESIZE flag!\n", bbuf.name.c_str() );
+            return;
+        }
+
+        if ( cmd->capacity <= bbuf.desc.byteSize ) return;
+        if ( BE_ReallocateBuffer( bbuf, cmd->capacity ) ) BE_PublishBuffer( bbuf );
+    }
+
     void Handle_vhDestroyBuffer( VIDL_vhDestroyBuffer* cmd ) override
     {
         BE_CmdRAII cmdRAII( cmd );
@@ -1114,12 +3083,17 @@ public:
             return;
         }
 
-        if ( backendBuffers.find( cmd->buffer ) == backendBuffers.end() )
+        auto* it = backendBuffers.find( cmd->buffer );
+        if ( !it )
         {
             VRHI_ERR( "vhDestroyBuffer() : Buffer %d not found!\n", cmd->buffer );
             return;
         }
 
+        BE_EvictBindingSets( ( *it )->handle.Get() );
+        BE_ReleasePooledBuffer( **it );
+        bufferSnapshots.remove( cmd->buffer );
+
         {
             std::lock_guard< std::mutex > lock( g_nvRHIStateMutex );
             backendBuffers.erase( cmd->buffer );
@@ -1162,7 +3136,17 @@ public:
         vhReflectSpirv( cmd->spirv, layoutDesc, resources, groupSize, pushConstants );
 
         // Set visibility based on shader stage.
-        layoutDesc.visibility = type; 
+        layoutDesc.visibility = type;
+
+        // Constant buffers are streamed from vhConstantRing, see BE_BindConstants(). NVRHI caps the volatile ones per
+        // layout, any beyond that keep a static binding.
+        uint32_t volatileCount = 0;
+        for ( auto& item : layoutDesc.bindings )
+        {
+            if ( item.type != nvrhi::ResourceType::ConstantBuffer || volatileCount == nvrhi::c_MaxVolatileConstantBuffersPerLayout ) continue;
+            item.type = nvrhi::ResourceType::VolatileConstantBuffer;
+            volatileCount++;
+        }
 
         // Create Shader via NVRHI
         nvrhi::ShaderDesc desc( type );
@@ -1178,6 +3162,7 @@ public:
         if ( handle )
         {
             auto backendShader = std::make_unique< vhBackendShader >( );
+            backendShader->id = cmd->shader;
             backendShader->name = cmd->name;
             backendShader->handle = handle;
             backendShader->flags = cmd->flags;
@@ -1194,6 +3179,7 @@ public:
                  backendShader->layout = g_vhDevice->createBindingLayout( layoutDesc );
             }
             
+            BE_PublishShader( *backendShader );
             backendShaders[cmd->shader] = std::move( backendShader );
         }
         else
@@ -1210,12 +3196,18 @@ public:
             return;
         }
 
-        if ( backendShaders.find( cmd->shader ) == backendShaders.end( ) )
+        auto* it = backendShaders.find( cmd->shader );
+        if ( !it )
         {
             VRHI_ERR( "vhDestroyShader() : Shader %d not found!\n", cmd->shader );
             return;
         }
 
+        BE_EvictBindingSets( ( *it )->layout.Get() );
+        BE_EvictPipelines( cmd->shader );
+        BE_EvictStateBlockPipelines( cmd->shader );
+        constantRing.release( cmd->shader );
+        shaderSnapshots.remove( cmd->shader );
         {
             std::lock_guard< std::mutex > lock( g_nvRHIStateMutex );
             backendShaders.erase( cmd->shader );
@@ -1226,19 +3218,19 @@ public:
     void Handle_vhCmdSetStateViewRect( VIDL_vhCmdSetStateViewRect* cmd ) override
     {
         BE_CmdRAII cmdRAII( cmd );
-        backendStates[cmd->id].viewRect = cmd->rect;
+        BE_State( cmd->id ).viewRect = cmd->rect;
     }
 
     void Handle_vhCmdSetStateViewScissor( VIDL_vhCmdSetStateViewScissor* cmd ) override
     {
         BE_CmdRAII cmdRAII( cmd );
-        backendStates[cmd->id].viewScissor = cmd->scissor;
+        BE_State( cmd->id ).viewScissor = cmd->scissor;
     }
 
     void Handle_vhCmdSetStateViewClear( VIDL_vhCmdSetStateViewClear* cmd ) override
     {
         BE_CmdRAII cmdRAII( cmd );
-        auto& state = backendStates[cmd->id];
+        auto& state = BE_State( cmd->id );
         state.clearFlags = cmd->flags;
         state.clearRgba = cmd->rgba;
         state.clearDepth = cmd->depth;
@@ -1248,13 +3240,13 @@ public:
     void Handle_vhCmdSetStateProgram( VIDL_vhCmdSetStateProgram* cmd ) override
     {
         BE_CmdRAII cmdRAII( cmd );
-        backendStates[cmd->id].program = cmd->program;
+        BE_State( cmd->id ).program = cmd->program;
     }
 
     void Handle_vhCmdSetStateViewTransform( VIDL_vhCmdSetStateViewTransform* cmd ) override
     {
         BE_CmdRAII cmdRAII( cmd );
-        auto& state = backendStates[cmd->id];
+        auto& state = BE_State( cmd->id );
         state.viewMatrix = cmd->view;
         state.projMatrix = cmd->proj;
     }
@@ -1262,25 +3254,25 @@ public:
     void Handle_vhCmdSetStateWorldTransform( VIDL_vhCmdSetStateWorldTransform* cmd ) override
     {
         BE_CmdRAII cmdRAII( cmd );
-        backendStates[cmd->id].worldMatrix = cmd->matrices;
+        BE_State( cmd->id ).worldMatrix = cmd->matrices;
     }
 
     void Handle_vhCmdSetStateFlags( VIDL_vhCmdSetStateFlags* cmd ) override
     {
         BE_CmdRAII cmdRAII( cmd );
-        backendStates[cmd->id].stateFlags = cmd->flags;
+        BE_State( cmd->id ).stateFlags = cmd->flags;
     }
 
     void Handle_vhCmdSetStateDebugFlags( VIDL_vhCmdSetStateDebugFlags* cmd ) override
     {
         BE_CmdRAII cmdRAII( cmd );
-        backendStates[cmd->id].debugFlags = cmd->flags;
+        BE_State( cmd->id ).debugFlags = cmd->flags;
     }
 
     void Handle_vhCmdSetStateStencil( VIDL_vhCmdSetStateStencil* cmd ) override
     {
         BE_CmdRAII cmdRAII( cmd );
-        auto& state = backendStates[cmd->id];
+        auto& state = BE_State( cmd->id );
         state.frontStencil = cmd->front;
         state.backStencil = cmd->back;
     }
@@ -1288,7 +3280,7 @@ public:
     void Handle_vhCmdSetStateVertexBuffer( VIDL_vhCmdSetStateVertexBuffer* cmd ) override
     {
         BE_CmdRAII cmdRAII( cmd );
-        auto& state = backendStates[cmd->id];
+        auto& state = BE_State( cmd->id );
         if ( cmd->stream >= state.vertexBindings.size() ) state.vertexBindings.resize( cmd->stream + 1 );
         state.vertexBindings[cmd->stream] = { cmd->buffer, cmd->stream, cmd->start, cmd->num, cmd->offset };
     }
@@ -1296,49 +3288,173 @@ public:
     void Handle_vhCmdSetStateIndexBuffer( VIDL_vhCmdSetStateIndexBuffer* cmd ) override
     {
         BE_CmdRAII cmdRAII( cmd );
-        backendStates[cmd->id].indexBinding = { cmd->buffer, cmd->first, cmd->num, cmd->offset };
+        BE_State( cmd->id ).indexBinding = { cmd->buffer, cmd->first, cmd->num, cmd->offset };
     }
     
     void Handle_vhCmdSetStateTextures( VIDL_vhCmdSetStateTextures* cmd ) override
     {
         BE_CmdRAII cmdRAII( cmd );
-        backendStates[cmd->id].textures = cmd->textures;
+        BE_State( cmd->id ).textures = cmd->textures;
     }
 
     void Handle_vhCmdSetStateSamplers( VIDL_vhCmdSetStateSamplers* cmd ) override
     {
         BE_CmdRAII cmdRAII( cmd );
-        backendStates[cmd->id].samplers = cmd->samplers;
+        BE_State( cmd->id ).samplers = cmd->samplers;
     }
 
     void Handle_vhCmdSetStateBuffers( VIDL_vhCmdSetStateBuffers* cmd ) override
     {
         BE_CmdRAII cmdRAII( cmd );
-        backendStates[cmd->id].buffers = cmd->buffers;
+        BE_State( cmd->id ).buffers = cmd->buffers;
     }
 
     void Handle_vhCmdSetStateConstants( VIDL_vhCmdSetStateConstants* cmd ) override
     {
         BE_CmdRAII cmdRAII( cmd );
-        backendStates[cmd->id].constants = cmd->constants;
+        BE_State( cmd->id ).constants = cmd->constants;
+    }
+
+    void Handle_vhCmdSetStateTexture( VIDL_vhCmdSetStateTexture* cmd ) override
+    {
+        BE_CmdRAII cmdRAII( cmd );
+        BE_Util_SetStateSlot( BE_State( cmd->id ).textures, cmd->idx, cmd->count, cmd->texture );
+    }
+
+    void Handle_vhCmdSetStateSampler( VIDL_vhCmdSetStateSampler* cmd ) override
+    {
+        BE_CmdRAII cmdRAII( cmd );
+        BE_Util_SetStateSlot( BE_State( cmd->id ).samplers, cmd->idx, cmd->count, cmd->sampler );
+    }
+
+    void Handle_vhCmdSetStateBuffer( VIDL_vhCmdSetStateBuffer* cmd ) override
+    {
+        BE_CmdRAII cmdRAII( cmd );
+        BE_Util_SetStateSlot( BE_State( cmd->id ).buffers, cmd->idx, cmd->count, cmd->buffer );
+    }
+
+    void Handle_vhCmdSetStateConstant( VIDL_vhCmdSetStateConstant* cmd ) override
+    {
+        BE_CmdRAII cmdRAII( cmd );
+        BE_Util_SetStateSlot( BE_State( cmd->id ).constants, cmd->idx, cmd->count, cmd->constant );
     }
 
     void Handle_vhCmdSetStatePushConstants( VIDL_vhCmdSetStatePushConstants* cmd ) override
     {
         BE_CmdRAII cmdRAII( cmd );
-        backendStates[cmd->id].pushConstants = cmd->data;
+        BE_State( cmd->id ).pushConstants = cmd->data;
     }
 
     void Handle_vhCmdSetStateUniforms( VIDL_vhCmdSetStateUniforms* cmd ) override
     {
         BE_CmdRAII cmdRAII( cmd );
-        backendStates[cmd->id].uniforms = cmd->uniforms;
+        BE_State( cmd->id ).uniforms = cmd->uniforms;
+    }
+
+    void Handle_vhCmdSetStateUniform( VIDL_vhCmdSetStateUniform* cmd ) override
+    {
+        BE_CmdRAII cmdRAII( cmd );
+        BE_Util_SetStateSlot( BE_State( cmd->id ).uniforms, cmd->idx, cmd->count, cmd->uniform );
     }
     
+    void Handle_vhCmdSetStateBlock( VIDL_vhCmdSetStateBlock* cmd ) override
+    {
+        BE_CmdRAII cmdRAII( cmd );
+        if ( backendStateBlocks.count( cmd->id ) )
+        {
+            VRHI_ERR( "vhSetState() : State %llu is an immutable state block!\n", ( unsigned long long ) cmd->id );
+            return;
+        }
+        if ( !vhApplyStateBlock( BE_State( cmd->id ), cmd->dirty, vhCmdTail( cmd ), cmd->size ) )
+        {
+            VRHI_ERR( "vhSetState() : Malformed state block for state %llu!\n", ( unsigned long long ) cmd->id );
+        }
+    }
+
+    void Handle_vhCreateStateBlock( VIDL_vhCreateStateBlock* cmd ) override
+    {
+        BE_CmdRAII cmdRAII( cmd );
+        vhState state = cmd->state;
+        state.dirty = 0;
+
+        std::vector< vhBackendShader* > shaders;
+        for ( vhShader shader : state.program )
+        {
+            auto* it = backendShaders.find( shader );
+            if ( !it )
+            {
+                VRHI_ERR( "vhCreateStateBlock() : Shader %u not found for state %llu!\n", shader, ( unsigned long long ) cmd->id );
+                return;
+            }
+            shaders.push_back( it->get() );
+        }
+
+        // Resolve texture names up front. A name only becomes a slot if every shader in the program agrees on it,
+        // otherwise the binding would land on unrelated slots of the shaders that don't declare it.
+        for ( auto& texture : state.textures )
+        {
+            if ( !texture.name || shaders.empty() ) continue;
+            auto* itTex = backendTextures.find( texture.texture );
+            bool uav = texture.computeUAV && itTex && ( ( *itTex )->flags & VRHI_TEXTURE_COMPUTE_WRITE );
+            nvrhi::ResourceType type = uav ? nvrhi::ResourceType::Texture_UAV : nvrhi::ResourceType::Texture_SRV;
+
+            int32_t slot = BE_Util_ResolveBindingSlot( texture.name, type, *shaders[0] );
+            for ( auto* shader : shaders )
+            {
+                if ( BE_Util_ResolveBindingSlot( texture.name, type, *shader ) != slot ) slot = -1;
+            }
+            if ( slot == -1 ) continue;
+            texture.slot = slot;
+            texture.name = nullptr;
+        }
+
+        vhBackendStateBlock block;
+        if ( !shaders.empty() && ( shaders[0]->flags & VRHI_SHADER_STAGE_COMPUTE ) )
+        {
+            block.computePipeline = BE_GetComputePipeline( state, *shaders[0] );
+        }
+
+        std::vector< vhBackendShader* > graphicsShaders;
+        for ( auto* shader : shaders )
+        {
+            if ( BE_Util_ShaderStageMatches( shader->flags, false, true ) ) graphicsShaders.push_back( shader );
+        }
+        if ( !graphicsShaders.empty() )
+        {
+            block.hasGraphics = BE_PresubmitPipelineDescCommon( state, graphicsShaders.data(), ( int ) graphicsShaders.size(), nullptr, &block.graphicsDesc );
+
+            std::vector< vhTexture > colours;
+            for ( const auto& target : state.colourAttachment ) colours.push_back( target.texture );
+            if ( block.hasGraphics && ( !colours.empty() || state.depthAttachment.texture != VRHI_INVALID_HANDLE ) )
+            {
+                nvrhi::FramebufferHandle framebuffer = BE_GetFrameBuffer( colours, state.depthAttachment.texture );
+                if ( framebuffer )
+                {
+                    block.graphicsFramebufferInfo = framebuffer->getFramebufferInfo();
+                    block.graphicsPipeline = BE_GetGraphicsPipeline( block.graphicsDesc, state.program, block.graphicsFramebufferInfo );
+                }
+            }
+        }
+
+        BE_State( cmd->id ) = std::move( state );
+        std::lock_guard< std::mutex > lock( g_nvRHIStateMutex );
+        backendStateBlocks[cmd->id] = std::move( block );
+    }
+
+    void Handle_vhDestroyStateBlock( VIDL_vhDestroyStateBlock* cmd ) override
+    {
+        BE_CmdRAII cmdRAII( cmd );
+        std::lock_guard< std::mutex > lock( g_nvRHIStateMutex );
+        if ( !backendStateBlocks.erase( cmd->id ) )
+        {
+            VRHI_ERR( "vhDestroyStateBlock() : State %llu is not a state block!\n", ( unsigned long long ) cmd->id );
+        }
+    }
+
     void Handle_vhCmdSetStateAttachments( VIDL_vhCmdSetStateAttachments* cmd ) override
     {
         BE_CmdRAII cmdRAII( cmd );
-        auto& state = backendStates[cmd->id];
+        auto& state = BE_State( cmd->id );
         state.colourAttachment = cmd->colours;
         state.depthAttachment = cmd->depth;
     }
@@ -1367,13 +3483,76 @@ public:
             g_vhDevice->runGarbageCollection();
         }
 
-        // Notify caller that we're done.
-        // Safety warning : fence is probably from stack of caller
-        if ( cmd->fence )
-            cmd->fence->store( true );
+        // Notify callers waiting on this ticket. Anything they query afterwards must already be visible.
+        BE_RetireReadbacks();
+        BE_PublishDirtyStates();
+        BE_PruneQueueTokens();
+        BE_CompleteFlushTicket( cmd->ticket );
+    }
+
+    void Handle_vhDispatchBatchInternal( VIDL_vhDispatchBatchInternal* cmd ) override
+    {
+        BE_CmdRAII cmdRAII( cmd );
+        BE_DispatchBatch( reinterpret_cast< const vhDispatchDesc* >( vhCmdTail( cmd ) ), cmd->count, cmd->token );
+    }
+
+    void Handle_vhSubmitDrawsInternal( VIDL_vhSubmitDrawsInternal* cmd ) override
+    {
+        BE_CmdRAII cmdRAII( cmd );
+        if ( cmd->frame < nextFrame )
+        {
+            VRHI_ERR( "vhEndEncoder() : Frame %llu was already recorded, dropping %u draws! Encoders must end before vhFrame().\n", cmd->frame, cmd->count );
+            return;
+        }
+        auto& frame = pendingFrames[cmd->frame];
+        auto* draws = reinterpret_cast< const vhDraw* >( vhCmdTail( cmd ) );
+        frame.draws.insert( frame.draws.end(), draws, draws + cmd->count );
+        frame.received++;
+        BE_RecordFrames();
+    }
+
+    void Handle_vhFrameInternal( VIDL_vhFrameInternal* cmd ) override
+    {
+        BE_CmdRAII cmdRAII( cmd );
+        pendingFrames[cmd->frame].expected = cmd->encoders;
+        BE_RecordFrames();
+    }
+
+    void Handle_vhQueueSignalInternal( VIDL_vhQueueSignalInternal* cmd ) override
+    {
+        BE_CmdRAII cmdRAII( cmd );
+        auto queue = cmd->queue;
+        if ( g_vhCmdLists[( uint64_t ) queue] )
+        {
+            BE_RecordQueueToken( cmd->token, queue );
+        }
+        else if ( uint64_t serial = vhCmdListOpenSerial( queue ) )
+        {
+            // Nothing is recording, so everything so far went out with the last submission.
+            queueTokens[cmd->token].serials[( uint64_t ) queue] = serial - 1;
+        }
+    }
+
+    void Handle_vhQueueWaitInternal( VIDL_vhQueueWaitInternal* cmd ) override
+    {
+        BE_CmdRAII cmdRAII( cmd );
+        auto it = queueTokens.find( cmd->token );
+        if ( it == queueTokens.end() ) return; // Already completed, or never recorded any work.
+
+        for ( uint64_t queue = 0; queue < ( uint64_t ) nvrhi::CommandQueue::Count; queue++ )
+        {
+            auto producer = ( nvrhi::CommandQueue ) queue;
+            uint64_t serial = it->second.serials[queue];
+            if ( serial == UINT64_MAX || producer == cmd->consumer ) continue; // Same queue work is already ordered.
+
+            // The producer must be submitted before anything can wait on it.
+            if ( serial >= vhCmdListOpenSerial( producer ) ) vhCmdListFlush( producer );
+            if ( serial >= vhCmdListOpenSerial( producer ) ) continue;
+            vhCmdListWaitForSerial( cmd->consumer, producer, serial );
+        }
     }
 
-    void Handle_vhDispatch( VIDL_vhDispatch* cmd ) override
+    void Handle_vhDispatchInternal( VIDL_vhDispatchInternal* cmd ) override
     {
         BE_CmdRAII cmdRAII( cmd );
         if ( cmd->stateID == VRHI_INVALID_HANDLE || cmd->workGroupCount.x == 0 || cmd->workGroupCount.y == 0 || cmd->workGroupCount.z == 0 ) return;
@@ -1393,23 +3572,23 @@ public:
             return;
         }
 
-        auto itShader = backendShaders.find( state.program[0] );
-        if ( itShader == backendShaders.end() )
+        auto* itShader = backendShaders.find( state.program[0] );
+        if ( !itShader )
         {
             VRHI_ERR( "vhDispatch: Shader %llu not found for state %llu!\n", state.program[0], cmd->stateID );
             return;
         }
         
-        BE_Dispatch( state, *itShader->second, cmd->workGroupCount );
+        BE_Dispatch( state, **itShader, cmd->workGroupCount, cmd->token, BE_FindStateBlock( cmd->stateID ) );
     }
 
-    void Handle_vhDispatchIndirect( VIDL_vhDispatchIndirect* cmd ) override
+    void Handle_vhDispatchIndirectInternal( VIDL_vhDispatchIndirectInternal* cmd ) override
     {
         BE_CmdRAII cmdRAII( cmd );
         if ( cmd->stateID == VRHI_INVALID_HANDLE || cmd->indirectBuffer == VRHI_INVALID_HANDLE ) return;
         
-        auto itBuf = backendBuffers.find( cmd->indirectBuffer );
-        if ( itBuf == backendBuffers.end() )
+        auto* itBuf = backendBuffers.find( cmd->indirectBuffer );
+        if ( !itBuf )
         {
              VRHI_ERR( "vhDispatchIndirect: Indirect buffer %d not found!\n", cmd->indirectBuffer );
              return;
@@ -1429,14 +3608,14 @@ public:
             return;
         }
 
-        auto itShader = backendShaders.find( state.program[0] );
-        if ( itShader == backendShaders.end() )
+        auto* itShader = backendShaders.find( state.program[0] );
+        if ( !itShader )
         {
             VRHI_ERR( "vhDispatchIndirect: Shader %llu not found for state %llu!\n", state.program[0], cmd->stateID );
             return;
         }
 
-        BE_DispatchIndirect( state, *itShader->second, *itBuf->second, cmd->byteOffset );
+        BE_DispatchIndirect( state, **itShader, **itBuf, cmd->byteOffset, cmd->token, BE_FindStateBlock( cmd->stateID ) );
     }
 
     void Handle_vhBlitBuffer( VIDL_vhBlitBuffer* cmd ) override
@@ -1444,22 +3623,22 @@ public:
         BE_CmdRAII cmdRAII( cmd );
         if ( cmd->dst == VRHI_INVALID_HANDLE || cmd->src == VRHI_INVALID_HANDLE || cmd->size == 0 ) return;
         
-        auto itDst = backendBuffers.find( cmd->dst );
-        auto itSrc = backendBuffers.find( cmd->src );
+        auto* itDst = backendBuffers.find( cmd->dst );
+        auto* itSrc = backendBuffers.find( cmd->src );
 
-        if ( itDst == backendBuffers.end() ) 
+        if ( !itDst ) 
         {
              VRHI_ERR( "vhBlitBuffer: Destination buffer %d not found!\n", cmd->dst );
              return;
         }
-        if ( itSrc == backendBuffers.end() ) 
+        if ( !itSrc ) 
         {
              VRHI_ERR( "vhBlitBuffer: Source buffer %d not found!\n", cmd->src );
              return;
         }
 
         // We can't clamp size if offset is out of bounds.
-        if ( cmd->srcOffset > itSrc->second->desc.byteSize || cmd->dstOffset > itDst->second->desc.byteSize )
+        if ( cmd->srcOffset > ( *itSrc )->byteSize || cmd->dstOffset > ( *itDst )->byteSize )
         {
             VRHI_ERR( "vhBlitBuffer: Source or destination buffer offset out of bounds!\n" );
             return;
@@ -1467,16 +3646,41 @@ public:
 
         // Clamp size to avoid buffer overruns.
         uint64_t clampedSizeBytes = cmd->size;
-        if ( cmd->srcOffset + cmd->size > itSrc->second->desc.byteSize )
+        if ( cmd->srcOffset + cmd->size > ( *itSrc )->byteSize )
+        {
+            clampedSizeBytes = std::min( ( *itSrc )->byteSize - cmd->srcOffset, cmd->size );
+        }
+        if ( cmd->dstOffset + cmd->size > ( *itDst )->byteSize )
+        {
+            clampedSizeBytes = std::min( ( *itDst )->byteSize - cmd->dstOffset, clampedSizeBytes );
+        }
+
+        BE_BlitBuffer( **itDst, **itSrc, cmd->dstOffset, cmd->srcOffset, clampedSizeBytes );
+    }
+
+    void Handle_vhReadBufferAsyncInternal( VIDL_vhReadBufferAsyncInternal* cmd ) override
+    {
+        BE_CmdRAII cmdRAII( cmd );
+        // NO dataRAII here - outData is owned by the caller.
+
+        auto* it = backendBuffers.find( cmd->buffer );
+        if ( !it || !( *it )->handle )
         {
-            clampedSizeBytes = std::min( itSrc->second->desc.byteSize - cmd->srcOffset, cmd->size );
+            VRHI_ERR( "vhReadBufferAsync() : Buffer %d not found!\n", cmd->buffer );
+            BE_CompleteReadbackTicket( cmd->ticket );
+            return;
         }
-        if ( cmd->dstOffset + cmd->size > itDst->second->desc.byteSize )
+
+        auto& bbuf = **it;
+        uint64_t size = cmd->size ? cmd->size : bbuf.byteSize - std::min( cmd->offset, bbuf.byteSize );
+        if ( !size || cmd->offset + size > bbuf.byteSize )
         {
-            clampedSizeBytes = std::min( itDst->second->desc.byteSize - cmd->dstOffset, clampedSizeBytes );
+            VRHI_ERR( "vhReadBufferAsync() : Range [%llu, +%llu] is outside buffer %s of %llu bytes!\n", cmd->offset, size, bbuf.name.c_str(), bbuf.byteSize );
+            BE_CompleteReadbackTicket( cmd->ticket );
+            return;
         }
 
-        BE_BlitBuffer( *itDst->second, *itSrc->second, cmd->dstOffset, cmd->srcOffset, clampedSizeBytes );
+        BE_ReadbackBuffer( bbuf, cmd->offset, size, cmd->ticket, cmd->outData );
     }
 
     // --------------------------------------------------------------------------
@@ -1489,20 +3693,41 @@ public:
         g_vhCmdThreadReady = true;
         if ( initCallback ) initCallback();
 
+        // Adaptive spin-then-block: on an empty queue, spin for up to |spinBudget| before blocking on the queue semaphore.
+        // The budget grows back towards the configured maximum while work keeps arriving mid-spin and decays while it doesn't.
+        const auto maxSpin = std::chrono::microseconds( std::max( g_vhInit.backendSpinMicroseconds, 0 ) );
+        auto spinBudget = maxSpin;
+
+        void* cmds[vhCmdBatch::kMaxCommands];
         while ( !g_vhCmdsQuit )
         {
-            void* cmd = nullptr;
-            if ( !g_vhCmds.try_dequeue( cmd ) )
+            size_t count = g_vhCmds.try_dequeue_bulk( cmds, vhCmdBatch::kMaxCommands );
+            if ( !count && maxSpin.count() > 0 )
             {
-                // Block until there is a command to process
-                if ( ! g_vhCmds.wait_dequeue_timed( cmd, std::chrono::milliseconds( 8 ) ) )
-                    continue;
+                auto spinEnd = std::chrono::steady_clock::now() + spinBudget;
+                while ( !count && std::chrono::steady_clock::now() < spinEnd )
+                {
+                    std::this_thread::yield();
+                    count = g_vhCmds.try_dequeue_bulk( cmds, vhCmdBatch::kMaxCommands );
+                }
+                spinBudget = count ? std::min( spinBudget * 2, maxSpin ) : std::max( spinBudget / 2, maxSpin / 8 );
+            }
+            if ( !count )
+            {
+                // Block until there is a command to process. vhShutdown() enqueues a null command to wake us.
+                count = g_vhCmds.wait_dequeue_bulk( cmds, vhCmdBatch::kMaxCommands );
             }
-            if ( cmd != nullptr )
+
+            // Hold the backend lock once for the whole batch rather than per command.
+            std::lock_guard< std::mutex > lock( backendMutex );
+            for ( size_t i = 0; i < count; i++ )
             {
-                std::lock_guard< std::mutex > lock( backendMutex );
-                HandleCmd( cmd );
+                if ( cmds[i] != nullptr ) HandleCmd( cmds[i] );
             }
+            if ( !pendingReadbacks.empty() ) BE_RetireReadbacks();
+            uploadArena.recycle();
+            if ( !pendingPoolReleases.empty() ) BE_RetirePoolReleases();
+            BE_PublishDirtyStates();
         }
 
         VRHI_LOG( "    RHI Thread exiting.\n" );
@@ -1512,60 +3737,50 @@ public:
     // Backend :: Query
     // --------------------------------------------------------------------------
 
-    // The query functions are a fastpath for getting info about objects from the main-thread. They directly lock the backend mutex and access the backend maps, rather than 
-    // sending a command to the backend thread and then waiting for a response. Object info queries are usually extremely short and fast, so this is OK. Query functions should never do 
-    // significant work or take a long time to complete, because that would bubble the hell out of the command thread.
+    // The query functions are a fastpath for getting info about objects from the main-thread. Rather than sending a command to the backend thread and
+    // waiting for a response, they read the immutable snapshots the backend publishes whenever an object is created, resized or modified. They never
+    // take backendMutex, so a query can't stall behind a long command and never stalls the command thread.
 
     vhTexInfo QueryTextureInfo( vhTexture handle, std::vector< vhTextureMipInfo >* outMipInfo )
     {
-        std::lock_guard< std::mutex > lock( backendMutex );
-        auto it = backendTextures.find( handle );
-        if ( it == backendTextures.end() || !it->second )
-        {
-            return vhTexInfo();
-        }
-
-        if ( outMipInfo )
+        vhTexInfo info;
+        textureSnapshots.read( handle, [&]( const vhTextureSnapshot& snapshot )
         {
-            *outMipInfo = it->second->mipInfo;
-        }
-        return it->second->info;
+            info = snapshot.info;
+            if ( outMipInfo ) *outMipInfo = snapshot.mipInfo;
+        } );
+        return info;
     }
 
     void* QueryTextureHandle( vhTexture handle )
     {
-        std::lock_guard< std::mutex > lock( backendMutex );
-        auto it = backendTextures.find( handle );
-        if ( it == backendTextures.end() || !it->second )
-        {
-            return nullptr;
-        }
-        return it->second->handle.Get();
+        void* ptr = nullptr;
+        textureSnapshots.read( handle, [&]( const vhTextureSnapshot& snapshot ) { ptr = snapshot.handle; } );
+        return ptr;
     }
 
     uint64_t QueryBufferInfo( vhBuffer handle, uint32_t* outStride, uint64_t* outFlags )
     {
-        std::lock_guard< std::mutex > lock( backendMutex );
-        auto it = backendBuffers.find( handle );
-        if ( it == backendBuffers.end() || !it->second )
+        uint64_t byteSize = 0;
+        bufferSnapshots.read( handle, [&]( const vhBufferSnapshot& snapshot )
         {
-            return 0;
-        }
-
-        if ( outStride ) *outStride = it->second->stride;
-        if ( outFlags ) *outFlags = it->second->flags;
-        return it->second->desc.byteSize;
+            if ( outStride ) *outStride = snapshot.stride;
+            if ( outFlags ) *outFlags = snapshot.flags;
+            byteSize = snapshot.byteSize;
+        } );
+        return byteSize;
     }
 
-    void* QueryBufferHandle( vhBuffer handle )
+    void* QueryBufferHandle( vhBuffer handle, uint64_t* outOffset )
     {
-        std::lock_guard< std::mutex > lock( backendMutex );
-        auto it = backendBuffers.find( handle );
-        if ( it == backendBuffers.end() || !it->second )
+        void* ptr = nullptr;
+        if ( outOffset ) *outOffset = 0;
+        bufferSnapshots.read( handle, [&]( const vhBufferSnapshot& snapshot )
         {
-            return nullptr;
-        }
-        return it->second->handle.Get();
+            ptr = snapshot.handle;
+            if ( outOffset ) *outOffset = snapshot.offset;
+        } );
+        return ptr;
     }
 
     void QueryShaderInfo(
@@ -1576,45 +3791,47 @@ public:
         std::vector< vhSpecConstant >* outSpecConstants
     )
     {
-        std::lock_guard< std::mutex > lock( backendMutex );
-        auto it = backendShaders.find( handle );
-        if ( it == backendShaders.end() || !it->second->handle )
+        bool found = shaderSnapshots.read( handle, [&]( const vhShaderSnapshot& snapshot )
+        {
+            if ( outGroupSize ) *outGroupSize = snapshot.threadGroupSize;
+            if ( outResources ) *outResources = snapshot.reflection;
+            if ( outPushConstants ) *outPushConstants = snapshot.pushConstants;
+            if ( outSpecConstants ) *outSpecConstants = snapshot.specConstants;
+        } );
+        if ( !found )
         {
             if ( outGroupSize ) *outGroupSize = { 0, 0, 0 };
             if ( outResources ) outResources->clear();
             if ( outPushConstants ) outPushConstants->clear();
             if ( outSpecConstants ) outSpecConstants->clear();
-            return;
         }
-
-        const auto& bshader = *it->second;
-        if ( outGroupSize ) *outGroupSize = bshader.threadGroupSize;
-        if ( outResources ) *outResources = bshader.reflection;
-        if ( outPushConstants ) *outPushConstants = bshader.pushConstants;
-        if ( outSpecConstants ) *outSpecConstants = bshader.specConstants;
     }
 
     void* QueryShaderHandle( vhShader handle )
     {
-        std::lock_guard< std::mutex > lock( backendMutex );
-        auto it = backendShaders.find( handle );
-        if ( it == backendShaders.end() || !it->second )
-        {
-            return nullptr;
-        }
-        return it->second->handle.Get();
+        void* ptr = nullptr;
+        shaderSnapshots.read( handle, [&]( const vhShaderSnapshot& snapshot ) { ptr = snapshot.handle; } );
+        return ptr;
     }
 
     bool QueryState( vhStateId id, vhState& outState )
+    {
+        return stateSnapshots.read( id, [&]( const vhState& snapshot ) { outState = snapshot; } );
+    }
+
+    vhPipelineCacheStats QueryPipelineCacheStats()
     {
         std::lock_guard<std::mutex> lock( backendMutex );
-        auto it = backendStates.find( id );
-        if ( it == backendStates.end() )
-        {
-            return false;
-        }
-        outState = it->second;
-        return true;
+        return {
+            .hits = pipelineCacheHits, .misses = pipelineCacheMisses, .pipelines = backendComputePipelines.size() + backendGraphicsPipelines.size(),
+            .bindingSetHits = bindingSetCacheHits, .bindingSetMisses = bindingSetCacheMisses, .bindingSets = backendBindingSets.size()
+        };
+    }
+
+    vhFrameStats QueryFrameStats()
+    {
+        std::lock_guard<std::mutex> lock( backendMutex );
+        return frameStats;
     }
 
     // --------------------------------------------------------------------------
@@ -1663,9 +3880,9 @@ uint64_t vhBackendQueryBufferInfo( vhBuffer buffer, uint32_t* outStride, uint64_
     return g_vhCmdBackendState.QueryBufferInfo( buffer, outStride, outFlags );
 }
 
-void* vhBackendQueryBufferHandle( vhBuffer buffer )
+void* vhBackendQueryBufferHandle( vhBuffer buffer, uint64_t* outOffset )
 {
-    return g_vhCmdBackendState.QueryBufferHandle( buffer );
+    return g_vhCmdBackendState.QueryBufferHandle( buffer, outOffset );
 }
 
 void vhBackendQueryShaderInfo( vhShader shader, glm::uvec3* outGroupSize, std::vector< vhShaderReflectionResource >* outResources, std::vector< vhPushConstantRange >* outPushConstants, std::vector< vhSpecConstant >* outSpecConstants )
@@ -1683,6 +3900,21 @@ bool vhBackendQueryState( vhStateId id, vhState& outState )
     return g_vhCmdBackendState.QueryState( id, outState );
 }
 
+vhPipelineCacheStats vhBackendQueryPipelineCacheStats()
+{
+    return g_vhCmdBackendState.QueryPipelineCacheStats();
+}
+
+vhFrameStats vhBackendQueryFrameStats()
+{
+    return g_vhCmdBackendState.QueryFrameStats();
+}
+
+uint8_t* vhBackendMapUpload( uint64_t size, uint32_t* outChunk, uint64_t* outOffset )
+{
+    return g_vhCmdBackendState.uploadArena.map( size, *outChunk, *outOffset );
+}
+
 #ifdef VRHI_UNIT_TEST
 bool vhBackend_UNITTEST_GetFrameBuffer( const std::vector< vhTexture >& colors, vhTexture depth )
 {
@@ -1692,4 +3924,9 @@ bool vhBackend_UNITTEST_GetFrameBuffer( const std::vector< vhTexture >& colors,
     if ( !fb1 || !fb2 ) return false;
     return fb1.Get() == fb2.Get();
 }
+
+nvrhi::FramebufferHandle vhBackend_UNITTEST_FrameBuffer( const std::vector< vhTexture >& colors, vhTexture depth, int mip, int layer )
+{
+    return g_vhCmdBackendState.UNITTEST_GetFrameBuffer( colors, depth, mip, layer );
+}
 #endif // VRHI_UNIT_TEST
@@ -192,12 +192,33 @@ int vhVertexLayoutDefSize( const std::vector< vhVertexLayoutDef >& def )
     return lastDef.offset + vhVertexLayoutDefSize( lastDef );
 }
 
+// Vertex attribute format of |def|. 3 component types only exist for 32-bit bases, UNKNOWN for the rest.
+nvrhi::Format vhVertexLayoutDefFormat( const vhVertexLayoutDef& def )
+{
+    using F = nvrhi::Format;
+    struct Entry { const char* type; F formats[4]; };
+    static const Entry table[] =
+    {
+        { "float",  { F::R32_FLOAT, F::RG32_FLOAT, F::RGB32_FLOAT, F::RGBA32_FLOAT } },
+        { "half",   { F::R16_FLOAT, F::RG16_FLOAT, F::UNKNOWN, F::RGBA16_FLOAT } },
+        { "int",    { F::R32_SINT, F::RG32_SINT, F::RGB32_SINT, F::RGBA32_SINT } },
+        { "uint",   { F::R32_UINT, F::RG32_UINT, F::RGB32_UINT, F::RGBA32_UINT } },
+        { "short",  { F::R16_SINT, F::RG16_SINT, F::UNKNOWN, F::RGBA16_SINT } },
+        { "ushort", { F::R16_UINT, F::RG16_UINT, F::UNKNOWN, F::RGBA16_UINT } },
+        { "byte",   { F::R8_SINT, F::RG8_SINT, F::UNKNOWN, F::RGBA8_SINT } },
+        { "ubyte",  { F::R8_UINT, F::RG8_UINT, F::UNKNOWN, F::RGBA8_UINT } },
+    };
+    if ( def.componentCount < 1 || def.componentCount > 4 ) return F::UNKNOWN;
+    for ( const auto& entry : table )
+    {
+        if ( def.type == entry.type ) return entry.formats[def.componentCount - 1];
+    }
+    return F::UNKNOWN;
+}
+
 vhBuffer vhAllocBuffer()
 {
-    std::lock_guard<std::mutex> lock( g_vhBufferIDListMutex );
     uint32_t id = g_vhBufferIDList.alloc();
-    g_vhBufferIDValid[id] = true;
-
     vhResetBuffer( id );
     return id;
 }
@@ -211,19 +232,21 @@ void vhResetBuffer( vhBuffer buffer )
     vhCmdEnqueue( cmd );
 }
 
-void vhDestroyBuffer( vhBuffer buffer )
+void vhReserveBuffer( vhBuffer buffer, uint64_t capacity )
 {
-    std::lock_guard<std::mutex> lock( g_vhBufferIDListMutex );
+    auto cmd = vhCmdAlloc<VIDL_vhReserveBuffer>( buffer, capacity );
+    assert( cmd );
+    vhCmdEnqueue( cmd );
+}
 
-    if ( g_vhBufferIDValid.find( buffer ) == g_vhBufferIDValid.end() )
+void vhDestroyBuffer( vhBuffer buffer )
+{
+    if ( !g_vhBufferIDList.release( buffer ) )
     {
-        // Invalid buffer handle
+        // Invalid or already destroyed buffer handle
         return;
     }
 
-    g_vhBufferIDValid.erase( buffer );
-    g_vhBufferIDList.release( buffer );
-
     // Queue up command to destroy the buffer
     auto cmd = vhCmdAlloc<VIDL_vhDestroyBuffer>( buffer );
     assert( cmd );
@@ -336,12 +359,54 @@ void vhUpdateStorageBuffer(
     vhCmdEnqueue( cmd );
 }
 
+vhUploadMapping vhMapBufferUpload( vhBuffer buffer, uint64_t offset, uint64_t size )
+{
+    if ( buffer == VRHI_INVALID_HANDLE || !size ) return {};
+
+    vhUploadMapping mapping;
+    mapping.size = size;
+    mapping.buffer = buffer;
+    mapping.offset = offset;
+    mapping.data = vhBackendMapUpload( size, &mapping.chunk, &mapping.chunkOffset );
+    if ( !mapping.data )
+    {
+        VRHI_ERR( "vhMapBufferUpload() : Failed to allocate %llu bytes of upload memory!\n", size );
+        return {};
+    }
+    return mapping;
+}
+
+void vhReadBufferAsyncInternal( vhReadbackTicket ticket, vhBuffer buffer, uint64_t offset, uint64_t size, vhMem* outData )
+{
+    auto cmd = vhCmdAlloc<VIDL_vhReadBufferAsyncInternal>( ticket, buffer, offset, size, outData );
+    assert( cmd );
+    vhCmdEnqueue( cmd );
+}
+
+vhReadbackTicket vhReadBufferAsync(
+    vhBuffer buffer,
+    uint64_t offset,
+    uint64_t size,
+    vhMem* outData
+)
+{
+    if ( outData && outData->isExternal() )
+    {
+        VRHI_ERR( "vhReadBufferAsync() : Cannot read back into a vhMem that references external memory!\n" );
+        return 0;
+    }
+
+    vhReadbackTicket ticket = g_vhReadbackTicketIssued.fetch_add( 1 ) + 1;
+    vhReadBufferAsyncInternal( ticket, buffer, offset, size, outData );
+    return ticket;
+}
+
 uint64_t vhGetBufferInfo( vhBuffer buffer, uint32_t* outStride, uint64_t* outFlags )
 {
     return vhBackendQueryBufferInfo( buffer, outStride, outFlags );
 }
 
-void* vhGetBufferNvrhiHandle( vhBuffer buffer )
+void* vhGetBufferNvrhiHandle( vhBuffer buffer, uint64_t* outOffset )
 {
-    return vhBackendQueryBufferHandle( buffer );
+    return vhBackendQueryBufferHandle( buffer, outOffset );
 }
\ No newline at end of file
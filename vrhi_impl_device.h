@@ -65,6 +65,150 @@ static VKAPI_ATTR VkBool32 VKAPI_CALL vhVKDebugCallback(
     return VK_FALSE;
 }
 
+// -------------------------------------------------------- Pipeline Cache --------------------------------------------------------
+
+// NVRHI always creates pipelines with a null VkPipelineCache and has no way to pass one in. Its Vulkan backend calls through
+// the vulkan.hpp dynamic dispatcher we own though, so we route vkCreate*Pipelines through hooks that substitute our cache.
+
+static VkPipelineCache s_vhPipelineCache = VK_NULL_HANDLE;
+static PFN_vkCreateComputePipelines s_vhVkCreateComputePipelines = nullptr;
+static PFN_vkCreateGraphicsPipelines s_vhVkCreateGraphicsPipelines = nullptr;
+
+static VKAPI_ATTR VkResult VKAPI_CALL vhHookCreateComputePipelines( VkDevice device, VkPipelineCache cache, uint32_t count, const VkComputePipelineCreateInfo* infos, const VkAllocationCallbacks* alloc, VkPipeline* outPipelines )
+{
+    return s_vhVkCreateComputePipelines( device, cache ? cache : s_vhPipelineCache, count, infos, alloc, outPipelines );
+}
+
+static VKAPI_ATTR VkResult VKAPI_CALL vhHookCreateGraphicsPipelines( VkDevice device, VkPipelineCache cache, uint32_t count, const VkGraphicsPipelineCreateInfo* infos, const VkAllocationCallbacks* alloc, VkPipeline* outPipelines )
+{
+    return s_vhVkCreateGraphicsPipelines( device, cache ? cache : s_vhPipelineCache, count, infos, alloc, outPipelines );
+}
+
+static vhPipelineCacheFileHeader vhPipelineCacheDeviceHeader()
+{
+    VkPhysicalDeviceProperties props = {};
+    vkGetPhysicalDeviceProperties( g_vulkanPhysicalDevice, &props );
+
+    vhPipelineCacheFileHeader header;
+    header.vendorID = props.vendorID;
+    header.deviceID = props.deviceID;
+    header.driverVersion = props.driverVersion;
+    memcpy( header.pipelineCacheUUID, props.pipelineCacheUUID, VK_UUID_SIZE );
+    return header;
+}
+
+// Reads |g_vhInit.pipelineCachePath|. Returns an empty blob if the file is missing, corrupt or from another device / driver.
+static std::vector< uint8_t > vhLoadPipelineCacheFile( bool quiet )
+{
+    std::vector< uint8_t > data;
+    FILE* f = fopen( g_vhInit.pipelineCachePath.c_str(), "rb" );
+    if ( !f ) return data;
+
+    vhPipelineCacheFileHeader header, expected = vhPipelineCacheDeviceHeader();
+    bool valid = fread( &header, sizeof( header ), 1, f ) == 1 &&
+        header.magic == expected.magic && header.version == expected.version &&
+        header.vendorID == expected.vendorID && header.deviceID == expected.deviceID &&
+        header.driverVersion == expected.driverVersion &&
+        memcmp( header.pipelineCacheUUID, expected.pipelineCacheUUID, VK_UUID_SIZE ) == 0;
+
+    if ( valid )
+    {
+        // The size comes from disk, so check it against what the file actually holds before allocating for it.
+        long dataStart = ftell( f );
+        valid = dataStart >= 0 && fseek( f, 0, SEEK_END ) == 0;
+        long fileSize = valid ? ftell( f ) : -1;
+        valid = valid && fileSize >= dataStart && header.dataSize == ( uint64_t ) ( fileSize - dataStart ) && fseek( f, dataStart, SEEK_SET ) == 0;
+    }
+    if ( valid )
+    {
+        data.resize( header.dataSize );
+        valid = fread( data.data(), 1, data.size(), f ) == data.size() && komihash( data.data(), data.size(), 0 ) == header.dataHash;
+    }
+    fclose( f );
+
+    if ( !valid )
+    {
+        if ( !quiet ) VRHI_LOG( "    Ignoring stale pipeline cache %s\n", g_vhInit.pipelineCachePath.c_str() );
+        data.clear();
+    }
+    return data;
+}
+
+static void vhInitPipelineCache( bool quiet )
+{
+    if ( g_vhInit.pipelineCachePath.empty() ) return;
+
+    std::vector< uint8_t > initialData = vhLoadPipelineCacheFile( quiet );
+    VkPipelineCacheCreateInfo info = { VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO };
+    info.initialDataSize = initialData.size();
+    info.pInitialData = initialData.empty() ? nullptr : initialData.data();
+    if ( vkCreatePipelineCache( g_vulkanDevice, &info, nullptr, &s_vhPipelineCache ) != VK_SUCCESS )
+    {
+        VRHI_ERR( "vhInit() : Failed to create Vulkan pipeline cache!\n" );
+        s_vhPipelineCache = VK_NULL_HANDLE;
+        return;
+    }
+    if ( !quiet ) VRHI_LOG( "    Created pipeline cache (%llu bytes loaded from %s)\n", ( unsigned long long ) initialData.size(), g_vhInit.pipelineCachePath.c_str() );
+
+    s_vhVkCreateComputePipelines = VULKAN_HPP_DEFAULT_DISPATCHER.vkCreateComputePipelines;
+    s_vhVkCreateGraphicsPipelines = VULKAN_HPP_DEFAULT_DISPATCHER.vkCreateGraphicsPipelines;
+    VULKAN_HPP_DEFAULT_DISPATCHER.vkCreateComputePipelines = &vhHookCreateComputePipelines;
+    VULKAN_HPP_DEFAULT_DISPATCHER.vkCreateGraphicsPipelines = &vhHookCreateGraphicsPipelines;
+}
+
+static bool vhSavePipelineCacheInternal()
+{
+    if ( s_vhPipelineCache == VK_NULL_HANDLE ) return false;
+
+    std::vector< uint8_t > data;
+    size_t size = 0;
+    if ( vkGetPipelineCacheData( g_vulkanDevice, s_vhPipelineCache, &size, nullptr ) != VK_SUCCESS ) return false;
+    data.resize( size );
+    if ( vkGetPipelineCacheData( g_vulkanDevice, s_vhPipelineCache, &size, data.data() ) != VK_SUCCESS ) return false;
+    data.resize( size );
+
+    vhPipelineCacheFileHeader header = vhPipelineCacheDeviceHeader();
+    header.dataSize = data.size();
+    header.dataHash = komihash( data.data(), data.size(), 0 );
+
+    // Write to a temp file and swap it in, so a crash mid-write never leaves a truncated cache behind.
+    std::string tmpPath = g_vhInit.pipelineCachePath + ".tmp";
+    FILE* f = fopen( tmpPath.c_str(), "wb" );
+    if ( !f )
+    {
+        VRHI_ERR( "vhSavePipelineCache() : Failed to open %s for writing!\n", tmpPath.c_str() );
+        return false;
+    }
+    bool written = fwrite( &header, sizeof( header ), 1, f ) == 1 && fwrite( data.data(), 1, data.size(), f ) == data.size();
+    written = ( fclose( f ) == 0 ) && written;
+
+    std::error_code ec;
+    if ( written ) std::filesystem::rename( tmpPath, g_vhInit.pipelineCachePath, ec );
+    if ( !written || ec )
+    {
+        VRHI_ERR( "vhSavePipelineCache() : Failed to write %s!\n", g_vhInit.pipelineCachePath.c_str() );
+        std::filesystem::remove( tmpPath, ec );
+        return false;
+    }
+    return true;
+}
+
+bool vhSavePipelineCache()
+{
+    std::lock_guard<std::mutex> lock( g_nvRHIStateMutex );
+    return vhSavePipelineCacheInternal();
+}
+
+static void vhShutdownPipelineCache()
+{
+    if ( s_vhPipelineCache == VK_NULL_HANDLE ) return;
+    vhSavePipelineCacheInternal();
+    VULKAN_HPP_DEFAULT_DISPATCHER.vkCreateComputePipelines = s_vhVkCreateComputePipelines;
+    VULKAN_HPP_DEFAULT_DISPATCHER.vkCreateGraphicsPipelines = s_vhVkCreateGraphicsPipelines;
+    vkDestroyPipelineCache( g_vulkanDevice, s_vhPipelineCache, nullptr );
+    s_vhPipelineCache = VK_NULL_HANDLE;
+}
+
 // -------------------------------------------------------- RHI Device --------------------------------------------------------
 
 void vhInit( bool quiet )
@@ -173,6 +317,23 @@ void vhInit( bool quiet )
         if ( !quiet ) VRHI_LOG( "    Ray Tracing extensions missing. RT features disabled.\n" );
     }
 
+    // One queue of every family, as vk-bootstrap would create, plus a second queue of the graphics family for async
+    // compute where it has one. A compute family of its own can't take async dispatches, see BE_DispatchQueue().
+    auto queueFamilies = vkbPhys.get_queue_families();
+    std::vector< vkb::CustomQueueDescription > queueDescs;
+    uint32_t graphicsFamily = UINT32_MAX;
+    for ( uint32_t family = 0; family < ( uint32_t ) queueFamilies.size(); family++ )
+    {
+        uint32_t count = 1;
+        if ( graphicsFamily == UINT32_MAX && ( queueFamilies[family].queueFlags & VK_QUEUE_GRAPHICS_BIT ) )
+        {
+            graphicsFamily = family;
+            count = std::min( queueFamilies[family].queueCount, 2u );
+        }
+        queueDescs.push_back( vkb::CustomQueueDescription( family, std::vector< float >( count, 1.0f ) ) );
+    }
+    devBuilder.custom_queue_setup( queueDescs );
+
     auto devRet = devBuilder.build();
     if ( !devRet )
     {
@@ -229,6 +390,12 @@ void vhInit( bool quiet )
         g_QueueFamilyTransfer = g_QueueFamilyCompute;
     }
 
+    if ( queueFamilies[g_QueueFamilyGraphics].queueCount >= 2 )
+    {
+        vkGetDeviceQueue( g_vulkanDevice, g_QueueFamilyGraphics, 1, &g_vulkanComputeQueue );
+        g_QueueFamilyCompute = g_QueueFamilyGraphics;
+    }
+
     static std::vector<std::string> s_enabledExtensions;
     s_enabledExtensions.clear();
     if ( g_vhRayTracingEnabled )
@@ -253,6 +420,7 @@ void vhInit( bool quiet )
 
     // Required by NVRHI Vulkan backend - initialises vk::DispatchLoaderDynamic for function pointers.
     VULKAN_HPP_DEFAULT_DISPATCHER.init( g_vulkanInstance, vkGetInstanceProcAddr, g_vulkanDevice, vkGetDeviceProcAddr );
+    vhInitPipelineCache( quiet );
 
     nvrhi::vulkan::DeviceDesc nvrhiDesc;
     nvrhiDesc.errorCB = &g_vhVKMessageCallback;
@@ -304,9 +472,11 @@ void vhShutdown( bool quiet )
     // Join RHI Command Buffer Thread
     if ( !quiet ) VRHI_LOG( "    Joining RHI Thread...\n" );
     g_vhCmdsQuit = true;
+    g_vhCmds.enqueue( nullptr ); // Wake the RHI thread if it is blocked on an empty queue.
     g_vhCmdThread.join();
     g_vhCmdThreadReady = false;
     vhBackendShutdown();
+    g_vhFrameEncoders = 0; // The backend dropped the draws of any unfinished frame.
     g_vhDevice->runGarbageCollection();
     vhCmdListFlushAll();
 
@@ -316,12 +486,18 @@ void vhShutdown( bool quiet )
         vkDeviceWaitIdle( g_vulkanDevice );
     }
 
+    if ( !quiet ) VRHI_LOG( "    Saving pipeline cache...\n" );
+    vhShutdownPipelineCache();
+
     if ( !quiet ) VRHI_LOG( "    Destroying NVRHI Device...\n" );
+    vhCmdListResetSubmissions(); // Pooled command lists must go before the device.
     g_vhDevice = nullptr; // RefCountPtr handles the release()
 
     // Clear resources
     if ( !quiet ) VRHI_LOG( "    Clearing resources...\n" );
     g_vhTextureIDList.purge();
+    g_vhBufferIDList.purge();
+    g_vhShaderIDList.purge();
 
     if ( g_vulkanDevice != VK_NULL_HANDLE )
     {
@@ -381,21 +557,82 @@ std::string vhGetDeviceInfo()
     return std::string(buffer);
 }
 
-void vhDispatch( vhStateId stateID, glm::uvec3 workGroupCount )
+void vhDispatchInternal( vhQueueToken token, vhStateId stateID, glm::uvec3 workGroupCount )
+{
+    VIDL_vhDispatchInternal* cmd = vhCmdAlloc<VIDL_vhDispatchInternal>( token, stateID, workGroupCount );
+    vhCmdEnqueue( cmd );
+}
+
+void vhDispatchIndirectInternal( vhQueueToken token, vhStateId stateID, vhBuffer indirectBuffer, uint64_t byteOffset )
+{
+    VIDL_vhDispatchIndirectInternal* cmd = vhCmdAlloc<VIDL_vhDispatchIndirectInternal>( token, stateID, indirectBuffer, byteOffset );
+    vhCmdEnqueue( cmd );
+}
+
+void vhQueueSignalInternal( vhQueueToken token, nvrhi::CommandQueue queue )
+{
+    VIDL_vhQueueSignalInternal* cmd = vhCmdAlloc<VIDL_vhQueueSignalInternal>( token, queue );
+    vhCmdEnqueue( cmd );
+}
+
+void vhQueueWaitInternal( nvrhi::CommandQueue consumer, vhQueueToken token )
 {
-    VIDL_vhDispatch* cmd = vhCmdAlloc<VIDL_vhDispatch>( stateID, workGroupCount );
+    VIDL_vhQueueWaitInternal* cmd = vhCmdAlloc<VIDL_vhQueueWaitInternal>( consumer, token );
     vhCmdEnqueue( cmd );
 }
 
-void vhDispatchIndirect( vhStateId stateID, vhBuffer indirectBuffer, uint64_t byteOffset )
+vhQueueToken vhDispatch( vhStateId stateID, glm::uvec3 workGroupCount )
+{
+    vhQueueToken token = g_vhQueueTokenIssued.fetch_add( 1 ) + 1;
+    vhDispatchInternal( token, stateID, workGroupCount );
+    return token;
+}
+
+vhQueueToken vhDispatchIndirect( vhStateId stateID, vhBuffer indirectBuffer, uint64_t byteOffset )
 {
     if ( byteOffset % 4 != 0 )
     {
         VRHI_ERR( "vhDispatchIndirect() : byteOffset %llu must be 4-byte aligned!\n", byteOffset );
-        return;
+        return 0;
     }
-    VIDL_vhDispatchIndirect* cmd = vhCmdAlloc<VIDL_vhDispatchIndirect>( stateID, indirectBuffer, byteOffset );
+    vhQueueToken token = g_vhQueueTokenIssued.fetch_add( 1 ) + 1;
+    vhDispatchIndirectInternal( token, stateID, indirectBuffer, byteOffset );
+    return token;
+}
+
+vhQueueToken vhDispatchBatch( const vhDispatchDesc* descs, size_t count )
+{
+    if ( !count ) return 0;
+    if ( !descs || count > UINT32_MAX )
+    {
+        VRHI_ERR( "vhDispatchBatch() : Invalid batch of %llu dispatches!\n", ( uint64_t ) count );
+        return 0;
+    }
+    vhQueueToken token = g_vhQueueTokenIssued.fetch_add( 1 ) + 1;
+    uint64_t bytes = count * sizeof( vhDispatchDesc );
+    auto cmd = vhCmdAllocTail< VIDL_vhDispatchBatchInternal >( bytes, token, ( uint32_t ) count );
+    assert( cmd );
+    memcpy( vhCmdTail( cmd ), descs, bytes );
     vhCmdEnqueue( cmd );
+    return token;
+}
+
+vhQueueToken vhQueueSignal( nvrhi::CommandQueue queue )
+{
+    vhQueueToken token = g_vhQueueTokenIssued.fetch_add( 1 ) + 1;
+    vhQueueSignalInternal( token, queue );
+    return token;
+}
+
+void vhQueueWait( nvrhi::CommandQueue consumer, vhQueueToken token )
+{
+    if ( !token ) return;
+    vhQueueWaitInternal( consumer, token );
+}
+
+vhPipelineCacheStats vhGetPipelineCacheStats()
+{
+    return vhBackendQueryPipelineCacheStats();
 }
 
 void vhBlitBuffer( vhBuffer dst, vhBuffer src, uint64_t dstOffset, uint64_t srcOffset, uint64_t size )
@@ -404,38 +641,162 @@ void vhBlitBuffer( vhBuffer dst, vhBuffer src, uint64_t dstOffset, uint64_t srcO
     vhCmdEnqueue( cmd );
 }
 
-void vhFlushInternal( std::atomic<bool>* fence, bool waitForGPU )
+void vhFlushInternal( vhFlushTicket ticket, bool waitForGPU )
 {
-    // Fence memory must be valid until signaled! 
-    // Usually stack memory of the caller waiting on it.
-    VIDL_vhFlushInternal* cmd = vhCmdAlloc<VIDL_vhFlushInternal>( fence, waitForGPU );
+    VIDL_vhFlushInternal* cmd = vhCmdAlloc<VIDL_vhFlushInternal>( ticket, waitForGPU );
     vhCmdEnqueue( cmd );
+    vhPublishCommands();
 }
 
-void vhFlush()
+vhFlushTicket vhFlushAsync( bool waitForGPU )
 {
-    std::atomic<bool> fence = false;
-    vhFlushInternal( &fence, false );
+    vhFlushTicket ticket = g_vhFlushTicketIssued.fetch_add( 1 ) + 1;
+    vhFlushInternal( ticket, waitForGPU );
+    return ticket;
+}
+
+bool vhIsFlushComplete( vhFlushTicket ticket )
+{
+    return g_vhFlushTicketCompleted.load( std::memory_order_acquire ) >= ticket;
+}
+
+void vhWaitFlush( vhFlushTicket ticket )
+{
+    // Short flushes usually complete within a few yields; only block in the kernel if they don't.
+    for ( int i = 0; i < 64; i++ )
+    {
+        if ( vhIsFlushComplete( ticket ) ) return;
+        std::this_thread::yield();
+    }
 
-    // Wait for fence to be signaled
-    while ( !fence.load() )
+    uint64_t completed = g_vhFlushTicketCompleted.load( std::memory_order_acquire );
+    while ( completed < ticket )
     {
-        std::this_thread::sleep_for( std::chrono::milliseconds( 1 ) );
+        g_vhFlushTicketCompleted.wait( completed, std::memory_order_acquire );
+        completed = g_vhFlushTicketCompleted.load( std::memory_order_acquire );
     }
 }
 
-void vhFinish()
+vhMem* vhMapFileMem( const std::filesystem::path& path, uint64_t offset, uint64_t size )
+{
+#if defined(_WIN32)
+    HANDLE file = CreateFileW( path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr );
+    if ( file == INVALID_HANDLE_VALUE )
+    {
+        VRHI_ERR( "vhMapFileMem() : Failed to open %s!\n", path.string().c_str() );
+        return nullptr;
+    }
+    LARGE_INTEGER fileSizeRaw = {};
+    GetFileSizeEx( file, &fileSizeRaw );
+    uint64_t fileSize = ( uint64_t ) fileSizeRaw.QuadPart;
+#else
+    int file = open( path.c_str(), O_RDONLY | O_CLOEXEC );
+    struct stat fileStat = {};
+    if ( file < 0 || fstat( file, &fileStat ) != 0 )
+    {
+        if ( file >= 0 ) close( file );
+        VRHI_ERR( "vhMapFileMem() : Failed to open %s!\n", path.string().c_str() );
+        return nullptr;
+    }
+    uint64_t fileSize = ( uint64_t ) fileStat.st_size;
+#endif
+
+    if ( !size && offset < fileSize ) size = fileSize - offset;
+    if ( !size || offset + size > fileSize )
+    {
+        VRHI_ERR( "vhMapFileMem() : Range [%llu, +%llu] is outside %s of %llu bytes!\n", offset, size, path.string().c_str(), fileSize );
+#if defined(_WIN32)
+        CloseHandle( file );
+#else
+        close( file );
+#endif
+        return nullptr;
+    }
+
+    // Views have to start on an allocation granularity / page boundary.
+#if defined(_WIN32)
+    SYSTEM_INFO systemInfo;
+    GetSystemInfo( &systemInfo );
+    uint64_t base = offset - offset % systemInfo.dwAllocationGranularity;
+    HANDLE mapping = CreateFileMappingW( file, nullptr, PAGE_READONLY, 0, 0, nullptr );
+    CloseHandle( file );
+    void* view = mapping ? MapViewOfFile( mapping, FILE_MAP_READ, ( DWORD ) ( base >> 32 ), ( DWORD ) base, ( SIZE_T ) ( offset - base + size ) ) : nullptr;
+    if ( mapping ) CloseHandle( mapping );
+    if ( !view )
+    {
+        VRHI_ERR( "vhMapFileMem() : Failed to map %s!\n", path.string().c_str() );
+        return nullptr;
+    }
+    auto release = [view]( const uint8_t*, size_t ) { UnmapViewOfFile( view ); };
+#else
+    uint64_t base = offset - offset % ( uint64_t ) sysconf( _SC_PAGESIZE );
+    size_t length = ( size_t ) ( offset - base + size );
+    void* view = mmap( nullptr, length, PROT_READ, MAP_PRIVATE, file, ( off_t ) base );
+    close( file );
+    if ( view == MAP_FAILED )
+    {
+        VRHI_ERR( "vhMapFileMem() : Failed to map %s!\n", path.string().c_str() );
+        return nullptr;
+    }
+    madvise( view, length, MADV_SEQUENTIAL ); // Uploads read it front to back, exactly once.
+    auto release = [view, length]( const uint8_t*, size_t ) { munmap( view, length ); };
+#endif
+
+    return vhAllocMemView( ( const uint8_t* ) view + ( offset - base ), size, release );
+}
+
+void vhCommitUploadInternal( vhUploadMapping mapping )
 {
-    std::atomic<bool> fence = false;
-    vhFlushInternal( &fence, true );
+    auto cmd = vhCmdAlloc<VIDL_vhCommitUploadInternal>( mapping );
+    assert( cmd );
+    vhCmdEnqueue( cmd );
+}
+
+void vhCommitUpload( const vhUploadMapping& mapping )
+{
+    if ( !mapping.data ) return;
+    vhCommitUploadInternal( mapping );
+}
+
+void vhRetireReadbacksInternal( vhReadbackTicket waitTicket )
+{
+    VIDL_vhRetireReadbacksInternal* cmd = vhCmdAlloc<VIDL_vhRetireReadbacksInternal>( waitTicket );
+    vhCmdEnqueue( cmd );
+    vhPublishCommands();
+}
+
+bool vhIsReadbackComplete( vhReadbackTicket ticket )
+{
+    if ( g_vhReadbackTicketCompleted.load( std::memory_order_acquire ) >= ticket ) return true;
+
+    // The backend only retires readbacks while it has commands to process; make sure a poll is on its way.
+    if ( !g_vhReadbackPollPending.exchange( true ) ) vhRetireReadbacksInternal( 0 );
+    return false;
+}
 
-    // Wait for fence to be signaled
-    while ( !fence.load() )
+void vhWaitReadback( vhReadbackTicket ticket )
+{
+    if ( g_vhReadbackTicketCompleted.load( std::memory_order_acquire ) >= ticket ) return;
+    vhRetireReadbacksInternal( ticket );
+
+    uint64_t completed = g_vhReadbackTicketCompleted.load( std::memory_order_acquire );
+    while ( completed < ticket )
     {
-        std::this_thread::sleep_for( std::chrono::milliseconds( 1 ) );
+        g_vhReadbackTicketCompleted.wait( completed, std::memory_order_acquire );
+        completed = g_vhReadbackTicketCompleted.load( std::memory_order_acquire );
     }
 }
 
+void vhFlush()
+{
+    vhWaitFlush( vhFlushAsync( false ) );
+}
+
+void vhFinish()
+{
+    vhWaitFlush( vhFlushAsync( true ) );
+}
+
 // -------------------------------------------------------- Dummy Resources --------------------------------------------------------
 
 static nvrhi::BufferHandle s_vhDummyOmniBuffer = nullptr;
@@ -623,11 +984,28 @@ uint64_t vhHashShaderBytecode( nvrhi::ShaderHandle shader )
     const void* bytecode = nullptr;
     size_t size = 0;
     shader->getBytecode( &bytecode, &size );
-    if ( bytecode && size > 0 )
-    {
-        return komihash( bytecode, size, 0 );
-    }
-    return 0;
+    if ( !bytecode || size == 0 ) return 0;
+
+    // One module can hold several entry points, so the stage and entry point are part of the shader's identity.
+    const nvrhi::ShaderDesc& desc = shader->getDesc();
+    uint64_t h = komihash( bytecode, size, 0 );
+    h = komihash( &desc.shaderType, sizeof( desc.shaderType ), h );
+    h = komihash( desc.entryName.data(), desc.entryName.size(), h );
+    return h;
+}
+
+bool vhShaderMatches( nvrhi::IShader* a, nvrhi::IShader* b )
+{
+    if ( a == b ) return true;
+    if ( !a || !b ) return false;
+    if ( a->getDesc().shaderType != b->getDesc().shaderType || a->getDesc().entryName != b->getDesc().entryName ) return false;
+
+    const void* bytecodeA = nullptr;
+    const void* bytecodeB = nullptr;
+    size_t sizeA = 0, sizeB = 0;
+    a->getBytecode( &bytecodeA, &sizeA );
+    b->getBytecode( &bytecodeB, &sizeB );
+    return sizeA == sizeB && ( sizeA == 0 || memcmp( bytecodeA, bytecodeB, sizeA ) == 0 );
 }
 
 uint64_t vhHashInputLayout( nvrhi::InputLayoutHandle layout )
@@ -792,6 +1170,30 @@ uint64_t vhHashGraphicsPipeline( const nvrhi::GraphicsPipelineDesc& desc, const
     return h;
 }
 
+uint64_t vhHashBindingSet( const nvrhi::BindingSetDesc& desc, nvrhi::IBindingLayout* layout )
+{
+    static_assert( sizeof( nvrhi::BindingSetItem ) == 40, "nvrhi::BindingSetItem size mismatch" );
+
+    uint64_t h = 0;
+    h = komihash( &layout, sizeof( layout ), h );
+
+    for ( const auto& item : desc.bindings )
+    {
+        nvrhi::IResource* resource = item.resourceHandle;
+        h = komihash( &resource, sizeof( resource ), h );
+
+        uint32_t slotAndElement[2] = { item.slot, item.arrayElement };
+        h = komihash( slotAndElement, sizeof( slotAndElement ), h );
+
+        uint8_t typeDimFormat[3] = { ( uint8_t ) item.type, ( uint8_t ) item.dimension, ( uint8_t ) item.format };
+        h = komihash( typeDimFormat, sizeof( typeDimFormat ), h );
+
+        // Covers both the texture subresources and the buffer range.
+        h = komihash( item.rawData, sizeof( item.rawData ), h );
+    }
+    return h;
+}
+
 uint64_t vhHashComputePipeline( const nvrhi::ComputePipelineDesc& desc )
 {
     uint64_t h = 0;
@@ -817,3 +1219,120 @@ uint64_t vhHashComputePipeline( const nvrhi::ComputePipelineDesc& desc )
 }
 
 
+
+// -------------------------------------------------------- Draw Submission --------------------------------------------------------
+
+static std::mutex s_vhEncoderPoolMutex;
+static std::vector< std::unique_ptr< vhEncoder > > s_vhEncoderPool;
+
+void vhRadixSort64( uint64_t* keys, uint32_t* values, uint64_t* tempKeys, uint32_t* tempValues, size_t count )
+{
+    if ( count < 2 ) return;
+
+    // Histogram every digit in a single pass over the keys.
+    size_t histograms[8][256] = {};
+    for ( size_t i = 0; i < count; i++ )
+    {
+        uint64_t key = keys[i];
+        for ( int digit = 0; digit < 8; digit++ ) histograms[digit][( key >> ( digit * 8 ) ) & 0xFF]++;
+    }
+
+    uint64_t firstKey = keys[0];
+    uint64_t* srcKeys = keys;
+    uint32_t* srcValues = values;
+    uint64_t* dstKeys = tempKeys;
+    uint32_t* dstValues = tempValues;
+    for ( int digit = 0; digit < 8; digit++ )
+    {
+        int shift = digit * 8;
+        size_t* histogram = histograms[digit];
+        if ( histogram[( firstKey >> shift ) & 0xFF] == count ) continue; // Every key has this digit, order is unchanged.
+
+        size_t offset = 0;
+        for ( int bucket = 0; bucket < 256; bucket++ )
+        {
+            size_t n = histogram[bucket];
+            histogram[bucket] = offset;
+            offset += n;
+        }
+        for ( size_t i = 0; i < count; i++ )
+        {
+            size_t dst = histogram[( srcKeys[i] >> shift ) & 0xFF]++;
+            dstKeys[dst] = srcKeys[i];
+            dstValues[dst] = srcValues[i];
+        }
+        std::swap( srcKeys, dstKeys );
+        std::swap( srcValues, dstValues );
+    }
+
+    if ( srcKeys != keys )
+    {
+        memcpy( keys, srcKeys, count * sizeof( uint64_t ) );
+        memcpy( values, srcValues, count * sizeof( uint32_t ) );
+    }
+}
+
+void vhFrameInternal( uint64_t frame, uint32_t encoders )
+{
+    VIDL_vhFrameInternal* cmd = vhCmdAlloc<VIDL_vhFrameInternal>( frame, encoders );
+    vhCmdEnqueue( cmd );
+}
+
+vhEncoder* vhBeginEncoder()
+{
+    {
+        std::lock_guard< std::mutex > lock( s_vhEncoderPoolMutex );
+        if ( !s_vhEncoderPool.empty() )
+        {
+            vhEncoder* encoder = s_vhEncoderPool.back().release();
+            s_vhEncoderPool.pop_back();
+            return encoder;
+        }
+    }
+    return new vhEncoder();
+}
+
+void vhSubmit( vhEncoder* encoder, const vhDraw& draw )
+{
+    assert( encoder );
+    if ( draw.stateID == VRHI_INVALID_HANDLE || draw.vertexCount == 0 || draw.instanceCount == 0 ) return;
+    encoder->draws.push_back( draw );
+}
+
+void vhEndEncoder( vhEncoder* encoder )
+{
+    if ( !encoder ) return;
+    if ( encoder->draws.size() > UINT32_MAX )
+    {
+        VRHI_ERR( "vhEndEncoder() : Too many draws in one encoder (%llu)!\n", ( uint64_t ) encoder->draws.size() );
+        encoder->draws.clear();
+    }
+    if ( !encoder->draws.empty() )
+    {
+        // The frame only completes once the backend has seen every encoder, so publish right away. Otherwise the draws
+        // could sit in this thread's batch while vhFrame() runs on another.
+        uint64_t bytes = encoder->draws.size() * sizeof( vhDraw );
+        auto cmd = vhCmdAllocTail< VIDL_vhSubmitDrawsInternal >( bytes, g_vhFrameIndex.load(), ( uint32_t ) encoder->draws.size() );
+        assert( cmd );
+        memcpy( vhCmdTail( cmd ), encoder->draws.data(), bytes );
+        vhCmdEnqueue( cmd );
+        vhPublishCommands();
+        g_vhFrameEncoders++;
+        encoder->draws.clear();
+    }
+
+    std::lock_guard< std::mutex > lock( s_vhEncoderPoolMutex );
+    s_vhEncoderPool.emplace_back( encoder );
+}
+
+void vhFrame()
+{
+    uint64_t frame = g_vhFrameIndex.fetch_add( 1 );
+    vhFrameInternal( frame, g_vhFrameEncoders.exchange( 0 ) );
+    vhPublishCommands();
+}
+
+vhFrameStats vhGetFrameStats()
+{
+    return vhBackendQueryFrameStats();
+}
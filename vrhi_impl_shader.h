@@ -300,10 +300,7 @@ std::string vhBuildShaderFlagArgs_Internal( uint64_t flags )
 
 vhShader vhAllocShader( )
 {
-    std::lock_guard< std::mutex > lock( g_vhShaderIDListMutex );
-    uint32_t id = g_vhShaderIDList.alloc( );
-    g_vhShaderIDValid[id] = true;
-    return id;
+    return g_vhShaderIDList.alloc( );
 }
 
 #ifdef VRHI_SHADER_COMPILER
@@ -460,11 +457,7 @@ void* vhGetShaderNvrhiHandle( vhShader shader )
 
 void vhDestroyShader( vhShader shader )
 {
-    std::lock_guard< std::mutex > lock( g_vhShaderIDListMutex );
-    if ( g_vhShaderIDValid.find( shader ) == g_vhShaderIDValid.end( ) ) return;
-
-    g_vhShaderIDValid.erase( shader );
-    g_vhShaderIDList.release( shader );
+    if ( !g_vhShaderIDList.release( shader ) ) return;
 
     auto cmd = vhCmdAlloc<VIDL_vhDestroyShader>( shader );
     assert( cmd );
@@ -33,175 +33,419 @@ bool vhGetState( vhStateId id, vhState& outState )
     return vhBackendQueryState( id, outState );
 }
 
+// Heap memory a state command carries besides its own record, for g_vhStateBytesEnqueued.
+template< typename T >
+static uint64_t vhPayloadBytes( const std::vector< T >& values )
+{
+    return values.size() * sizeof( T );
+}
+
+static uint64_t vhPayloadBytes( const vhState::ConstantBufferValue& value ) { return value.data.size() * sizeof( glm::vec4 ); }
+static uint64_t vhPayloadBytes( const vhState::UniformBufferValue& value ) { return value.data.size() * sizeof( glm::vec4 ); }
+
+template< typename T > requires requires( const T& value ) { value.data; }
+static uint64_t vhPayloadBytes( const std::vector< T >& values )
+{
+    uint64_t bytes = values.size() * sizeof( T );
+    for ( const auto& value : values ) bytes += vhPayloadBytes( value );
+    return bytes;
+}
+
+// Every state command goes through here, so the bytes vhSetState() sends to the backend can be measured.
+template< typename T >
+static void vhCmdEnqueueState( T* cmd, uint64_t payloadBytes = 0 )
+{
+    assert( cmd );
+    g_vhStateBytesEnqueued.fetch_add( sizeof( T ) + payloadBytes, std::memory_order_relaxed );
+    vhCmdEnqueue( cmd );
+}
+
 void vhCmdSetStateViewRect( vhStateId id, glm::vec4 rect )
 {
-    vhCmdEnqueue( new VIDL_vhCmdSetStateViewRect( id, rect ) );
+    vhCmdEnqueueState( vhCmdAlloc< VIDL_vhCmdSetStateViewRect >( id, rect ) );
 }
 
 void vhCmdSetStateViewScissor( vhStateId id, glm::vec4 scissor )
 {
-    vhCmdEnqueue( new VIDL_vhCmdSetStateViewScissor( id, scissor ) );
+    vhCmdEnqueueState( vhCmdAlloc< VIDL_vhCmdSetStateViewScissor >( id, scissor ) );
 }
 
 void vhCmdSetStateViewClear( vhStateId id, uint16_t flags, uint32_t rgba, float depth, uint8_t stencil )
 {
-    vhCmdEnqueue( new VIDL_vhCmdSetStateViewClear( id, flags, rgba, depth, stencil ) );
+    vhCmdEnqueueState( vhCmdAlloc< VIDL_vhCmdSetStateViewClear >( id, flags, rgba, depth, stencil ) );
 }
 
 void vhCmdSetStateProgram( vhStateId id, vhProgram program )
 {
-    vhCmdEnqueue( new VIDL_vhCmdSetStateProgram( id, program ) );
+    vhCmdEnqueueState( vhCmdAlloc< VIDL_vhCmdSetStateProgram >( id, program ), vhPayloadBytes( program ) );
 }
 
 void vhCmdSetStateViewTransform( vhStateId id, glm::mat4 view, glm::mat4 proj )
 {
-    vhCmdEnqueue( new VIDL_vhCmdSetStateViewTransform( id, view, proj ) );
+    vhCmdEnqueueState( vhCmdAlloc< VIDL_vhCmdSetStateViewTransform >( id, view, proj ) );
 }
 
 void vhCmdSetStateWorldTransform( vhStateId id, std::vector< glm::mat4 > matrices )
 {
-    vhCmdEnqueue( new VIDL_vhCmdSetStateWorldTransform( id, matrices ) );
+    vhCmdEnqueueState( vhCmdAlloc< VIDL_vhCmdSetStateWorldTransform >( id, matrices ), vhPayloadBytes( matrices ) );
 }
 
 void vhCmdSetStateFlags( vhStateId id, uint64_t flags )
 {
-    vhCmdEnqueue( new VIDL_vhCmdSetStateFlags( id, flags ) );
+    vhCmdEnqueueState( vhCmdAlloc< VIDL_vhCmdSetStateFlags >( id, flags ) );
 }
 
 void vhCmdSetStateDebugFlags( vhStateId id, uint64_t flags )
 {
-    vhCmdEnqueue( new VIDL_vhCmdSetStateDebugFlags( id, flags ) );
+    vhCmdEnqueueState( vhCmdAlloc< VIDL_vhCmdSetStateDebugFlags >( id, flags ) );
 }
 
 void vhCmdSetStateStencil( vhStateId id, uint32_t front, uint32_t back )
 {
-    vhCmdEnqueue( new VIDL_vhCmdSetStateStencil( id, front, back ) );
+    vhCmdEnqueueState( vhCmdAlloc< VIDL_vhCmdSetStateStencil >( id, front, back ) );
 }
 
 void vhCmdSetStateVertexBuffer( vhStateId id, uint8_t stream, vhBuffer buffer, uint64_t offset, uint32_t start, uint32_t num )
 {
-    vhCmdEnqueue( new VIDL_vhCmdSetStateVertexBuffer( id, stream, buffer, offset, start, num ) );
+    vhCmdEnqueueState( vhCmdAlloc< VIDL_vhCmdSetStateVertexBuffer >( id, stream, buffer, offset, start, num ) );
 }
 
 void vhCmdSetStateIndexBuffer( vhStateId id, vhBuffer buffer, uint64_t offset, uint32_t first, uint32_t num )
 {
-    vhCmdEnqueue( new VIDL_vhCmdSetStateIndexBuffer( id, buffer, offset, first, num ) );
+    vhCmdEnqueueState( vhCmdAlloc< VIDL_vhCmdSetStateIndexBuffer >( id, buffer, offset, first, num ) );
 }
 
 void vhCmdSetStateTextures( vhStateId id, const std::vector< vhState::TextureBinding >& textures )
 {
-    vhCmdEnqueue( new VIDL_vhCmdSetStateTextures( id, textures ) );
+    vhCmdEnqueueState( vhCmdAlloc< VIDL_vhCmdSetStateTextures >( id, textures ), vhPayloadBytes( textures ) );
 }
 
 void vhCmdSetStateSamplers( vhStateId id, const std::vector< vhState::SamplerDefinition >& samplers )
 {
-    vhCmdEnqueue( new VIDL_vhCmdSetStateSamplers( id, samplers ) );
+    vhCmdEnqueueState( vhCmdAlloc< VIDL_vhCmdSetStateSamplers >( id, samplers ), vhPayloadBytes( samplers ) );
 }
 
 void vhCmdSetStateBuffers( vhStateId id, const std::vector< vhState::BufferBinding >& buffers )
 {
-    vhCmdEnqueue( new VIDL_vhCmdSetStateBuffers( id, buffers ) );
+    vhCmdEnqueueState( vhCmdAlloc< VIDL_vhCmdSetStateBuffers >( id, buffers ), vhPayloadBytes( buffers ) );
 }
 
 void vhCmdSetStateConstants( vhStateId id, const std::vector< vhState::ConstantBufferValue >& constants )
 {
-    vhCmdEnqueue( new VIDL_vhCmdSetStateConstants( id, constants ) );
+    vhCmdEnqueueState( vhCmdAlloc< VIDL_vhCmdSetStateConstants >( id, constants ), vhPayloadBytes( constants ) );
 }
 
 void vhCmdSetStatePushConstants( vhStateId id, glm::vec4 data )
 {
-    vhCmdEnqueue( new VIDL_vhCmdSetStatePushConstants( id, data ) );
+    vhCmdEnqueueState( vhCmdAlloc< VIDL_vhCmdSetStatePushConstants >( id, data ) );
 }
 
 void vhCmdSetStateUniforms( vhStateId id, const std::vector< vhState::UniformBufferValue >& uniforms )
 {
-    vhCmdEnqueue( new VIDL_vhCmdSetStateUniforms( id, uniforms ) );
+    vhCmdEnqueueState( vhCmdAlloc< VIDL_vhCmdSetStateUniforms >( id, uniforms ), vhPayloadBytes( uniforms ) );
 }
 
 void vhCmdSetStateAttachments( vhStateId id, const std::vector< vhState::RenderTarget >& colors, vhState::RenderTarget depth )
 {
-    vhCmdEnqueue( new VIDL_vhCmdSetStateAttachments( id, colors, depth ) );
+    vhCmdEnqueueState( vhCmdAlloc< VIDL_vhCmdSetStateAttachments >( id, colors, depth ), vhPayloadBytes( colors ) );
 }
 
-bool vhSetState( vhStateId id, vhState& state, uint64_t dirtyForceMask )
+void vhCmdSetStateTexture( vhStateId id, uint32_t idx, uint32_t count, vhState::TextureBinding texture )
 {
-    uint64_t dirty = state.dirty | dirtyForceMask;
-    if ( !dirty ) return true;
+    vhCmdEnqueueState( vhCmdAlloc< VIDL_vhCmdSetStateTexture >( id, idx, count, texture ) );
+}
 
-    if ( dirty & VRHI_DIRTY_VIEWPORT )
+void vhCmdSetStateSampler( vhStateId id, uint32_t idx, uint32_t count, vhState::SamplerDefinition sampler )
+{
+    vhCmdEnqueueState( vhCmdAlloc< VIDL_vhCmdSetStateSampler >( id, idx, count, sampler ) );
+}
+
+void vhCmdSetStateBuffer( vhStateId id, uint32_t idx, uint32_t count, vhState::BufferBinding buffer )
+{
+    vhCmdEnqueueState( vhCmdAlloc< VIDL_vhCmdSetStateBuffer >( id, idx, count, buffer ) );
+}
+
+void vhCmdSetStateConstant( vhStateId id, uint32_t idx, uint32_t count, const vhState::ConstantBufferValue& constant )
+{
+    vhCmdEnqueueState( vhCmdAlloc< VIDL_vhCmdSetStateConstant >( id, idx, count, constant ), vhPayloadBytes( constant ) );
+}
+
+void vhCmdSetStateUniform( vhStateId id, uint32_t idx, uint32_t count, const vhState::UniformBufferValue& uniform )
+{
+    vhCmdEnqueueState( vhCmdAlloc< VIDL_vhCmdSetStateUniform >( id, idx, count, uniform ), vhPayloadBytes( uniform ) );
+}
+
+// ------------ State Blocks ------------
+
+// vhSetState() packs every dirty field into the tail of a single vhCmdSetStateBlock record, section by section in the
+// order of the VRHI_DIRTY_* bits. Tables are written as their size followed by ( index, entry ) pairs, covering every
+// entry when the table was replaced and only the dirty slots otherwise. Names stay pointers, as in vhState itself.
+
+struct vhStateBlockWriter
+{
+    uint8_t* out = nullptr; // Only measures while null.
+    uint64_t size = 0;
+
+    void bytes( const void* data, uint64_t count )
     {
-        vhCmdSetStateViewRect( id, state.viewRect );
-        vhCmdSetStateViewScissor( id, state.viewScissor );
-        vhCmdSetStateViewClear( id, state.clearFlags, state.clearRgba, state.clearDepth, state.clearStencil );
+        if ( out && count ) std::memcpy( out + size, data, count );
+        size += count;
     }
 
-    if ( dirty & VRHI_DIRTY_ATTACHMENTS )
+    template< typename T >
+    void value( const T& v )
     {
-        vhCmdSetStateAttachments( id, state.colourAttachment, state.depthAttachment );
+        static_assert( std::is_trivially_copyable_v< T >, "Only trivially copyable values can be packed." );
+        bytes( &v, sizeof( T ) );
     }
 
-    if ( dirty & VRHI_DIRTY_CAMERA )
+    template< typename T >
+    void entry( const T& v ) { value( v ); }
+
+    template< typename T > requires requires( const T& v ) { v.data; }
+    void entry( const T& v )
     {
-        vhCmdSetStateViewTransform( id, state.viewMatrix, state.projMatrix );
+        value( v.name );
+        value( ( uint32_t ) v.data.size() );
+        bytes( v.data.data(), v.data.size() * sizeof( glm::vec4 ) );
     }
 
-    if ( dirty & VRHI_DIRTY_WORLD )
+    template< typename T >
+    void table( const std::vector< T >& t, uint64_t slots = UINT64_MAX )
     {
-        vhCmdSetStateWorldTransform( id, state.worldMatrix );
+        uint32_t count = 0;
+        for ( uint32_t idx = 0; idx < t.size(); idx++ ) count += ( slots == UINT64_MAX || ( idx < 64 && ( slots >> idx & 1 ) ) );
+        value( ( uint32_t ) t.size() );
+        value( count );
+        for ( uint32_t idx = 0; idx < t.size(); idx++ )
+        {
+            if ( slots != UINT64_MAX && ( idx >= 64 || !( slots >> idx & 1 ) ) ) continue;
+            value( idx );
+            entry( t[idx] );
+        }
     }
+};
 
-    if ( dirty & VRHI_DIRTY_PIPELINE )
+struct vhStateBlockReader
+{
+    const uint8_t* in = nullptr;
+    uint64_t size = 0;
+    uint64_t offset = 0;
+    bool ok = true;
+
+    void bytes( void* data, uint64_t count )
     {
-        vhCmdSetStateFlags( id, state.stateFlags );
-        vhCmdSetStateDebugFlags( id, state.debugFlags );
-        vhCmdSetStateStencil( id, state.frontStencil, state.backStencil );
+        if ( !ok || count > size - offset ) { ok = false; return; }
+        if ( count ) std::memcpy( data, in + offset, count );
+        offset += count;
     }
 
-    if ( dirty & VRHI_DIRTY_VERTEX_INDEX )
+    template< typename T >
+    void value( T& v ) { bytes( &v, sizeof( T ) ); }
+
+    template< typename T >
+    void entry( T& v ) { value( v ); }
+
+    template< typename T > requires requires( T& v ) { v.data; }
+    void entry( T& v )
     {
-        for ( uint8_t i = 0; i < ( uint8_t ) state.vertexBindings.size(); ++i )
+        uint32_t count = 0;
+        value( v.name );
+        value( count );
+        if ( !ok || count > ( size - offset ) / sizeof( glm::vec4 ) ) { ok = false; return; }
+        v.data.resize( count );
+        bytes( v.data.data(), count * sizeof( glm::vec4 ) );
+    }
+
+    template< typename T >
+    void table( std::vector< T >& t )
+    {
+        uint32_t tableSize = 0, count = 0;
+        value( tableSize );
+        value( count );
+        if ( !ok ) return;
+        t.resize( tableSize );
+        for ( uint32_t i = 0; i < count && ok; i++ )
         {
-            const auto& b = state.vertexBindings[i];
-            vhCmdSetStateVertexBuffer( id, i, b.buffer, b.byteOffset, b.startVertex, b.numVertices );
+            uint32_t idx = 0;
+            T v{};
+            value( idx );
+            entry( v );
+            if ( ok && idx < tableSize ) t[idx] = std::move( v );
         }
-        vhCmdSetStateIndexBuffer( id, state.indexBinding.buffer, state.indexBinding.byteOffset, state.indexBinding.firstIndex, state.indexBinding.numIndices );
     }
+};
 
+// Tables dirtied without going through the per-slot setters, or forced, are written whole.
+static void vhWriteStateBlock( vhStateBlockWriter& writer, const vhState& state, uint64_t dirty, uint64_t dirtyForceMask )
+{
+    auto fnSlots = [&]( uint64_t flag, uint64_t slots, uint64_t sharedSlots ) { return ( ( dirtyForceMask & flag ) || !sharedSlots ) ? UINT64_MAX : slots; };
+
+    if ( dirty & VRHI_DIRTY_WORLD )
+    {
+        writer.table( state.worldMatrix );
+    }
+    if ( dirty & VRHI_DIRTY_VERTEX_INDEX )
+    {
+        writer.table( state.vertexBindings );
+        writer.value( state.indexBinding );
+    }
+    if ( dirty & VRHI_DIRTY_CAMERA )
+    {
+        writer.value( state.viewMatrix );
+        writer.value( state.projMatrix );
+    }
+    if ( dirty & VRHI_DIRTY_PIPELINE )
+    {
+        writer.value( state.stateFlags );
+        writer.value( state.debugFlags );
+        writer.value( state.frontStencil );
+        writer.value( state.backStencil );
+        writer.value( state.clearFlags );
+        writer.value( state.clearRgba );
+        writer.value( state.clearDepth );
+        writer.value( state.clearStencil );
+    }
+    if ( dirty & VRHI_DIRTY_VIEWPORT )
+    {
+        writer.value( state.viewRect );
+        writer.value( state.viewScissor );
+    }
+    if ( dirty & VRHI_DIRTY_ATTACHMENTS )
+    {
+        writer.table( state.colourAttachment );
+        writer.value( state.depthAttachment );
+    }
     if ( dirty & VRHI_DIRTY_TEXTURE_SAMPLERS )
     {
-        vhCmdSetStateTextures( id, state.textures );
-        vhCmdSetStateSamplers( id, state.samplers );
+        uint64_t shared = state.dirtyTextureSlots | state.dirtySamplerSlots;
+        writer.table( state.textures, fnSlots( VRHI_DIRTY_TEXTURE_SAMPLERS, state.dirtyTextureSlots, shared ) );
+        writer.table( state.samplers, fnSlots( VRHI_DIRTY_TEXTURE_SAMPLERS, state.dirtySamplerSlots, shared ) );
     }
-
     if ( dirty & VRHI_DIRTY_BUFFERS )
     {
-        vhCmdSetStateBuffers( id, state.buffers );
+        writer.table( state.buffers, fnSlots( VRHI_DIRTY_BUFFERS, state.dirtyBufferSlots, state.dirtyBufferSlots ) );
     }
-
     if ( dirty & VRHI_DIRTY_CONSTANTS )
     {
-        vhCmdSetStateConstants( id, state.constants );
+        writer.table( state.constants, fnSlots( VRHI_DIRTY_CONSTANTS, state.dirtyConstantSlots, state.dirtyConstantSlots ) );
     }
-
     if ( dirty & VRHI_DIRTY_PUSH_CONSTANTS )
     {
-        vhCmdSetStatePushConstants( id, state.pushConstants );
+        writer.value( state.pushConstants );
     }
-
     if ( dirty & VRHI_DIRTY_PROGRAM )
     {
-        vhCmdSetStateProgram( id, state.program );
+        writer.table( state.program );
     }
+    if ( dirty & VRHI_DIRTY_UNIFORMS )
+    {
+        writer.table( state.uniforms, fnSlots( VRHI_DIRTY_UNIFORMS, state.dirtyUniformSlots, state.dirtyUniformSlots ) );
+    }
+}
 
+// Backend side of vhWriteStateBlock(). Returns false if the block is malformed; |state| may then be partially updated.
+bool vhApplyStateBlock( vhState& state, uint64_t dirty, const uint8_t* data, uint64_t size )
+{
+    vhStateBlockReader reader = { .in = data, .size = size };
+
+    if ( dirty & VRHI_DIRTY_WORLD )
+    {
+        reader.table( state.worldMatrix );
+    }
+    if ( dirty & VRHI_DIRTY_VERTEX_INDEX )
+    {
+        reader.table( state.vertexBindings );
+        reader.value( state.indexBinding );
+    }
+    if ( dirty & VRHI_DIRTY_CAMERA )
+    {
+        reader.value( state.viewMatrix );
+        reader.value( state.projMatrix );
+    }
+    if ( dirty & VRHI_DIRTY_PIPELINE )
+    {
+        reader.value( state.stateFlags );
+        reader.value( state.debugFlags );
+        reader.value( state.frontStencil );
+        reader.value( state.backStencil );
+        reader.value( state.clearFlags );
+        reader.value( state.clearRgba );
+        reader.value( state.clearDepth );
+        reader.value( state.clearStencil );
+    }
+    if ( dirty & VRHI_DIRTY_VIEWPORT )
+    {
+        reader.value( state.viewRect );
+        reader.value( state.viewScissor );
+    }
+    if ( dirty & VRHI_DIRTY_ATTACHMENTS )
+    {
+        reader.table( state.colourAttachment );
+        reader.value( state.depthAttachment );
+    }
+    if ( dirty & VRHI_DIRTY_TEXTURE_SAMPLERS )
+    {
+        reader.table( state.textures );
+        reader.table( state.samplers );
+    }
+    if ( dirty & VRHI_DIRTY_BUFFERS )
+    {
+        reader.table( state.buffers );
+    }
+    if ( dirty & VRHI_DIRTY_CONSTANTS )
+    {
+        reader.table( state.constants );
+    }
+    if ( dirty & VRHI_DIRTY_PUSH_CONSTANTS )
+    {
+        reader.value( state.pushConstants );
+    }
+    if ( dirty & VRHI_DIRTY_PROGRAM )
+    {
+        reader.table( state.program );
+    }
     if ( dirty & VRHI_DIRTY_UNIFORMS )
     {
-        vhCmdSetStateUniforms( id, state.uniforms );
+        reader.table( state.uniforms );
     }
 
+    return reader.ok && reader.offset == size;
+}
+
+bool vhSetState( vhStateId id, vhState& state, uint64_t dirtyForceMask )
+{
+    uint64_t dirty = state.dirty | dirtyForceMask;
+    if ( !dirty ) return true;
+
+    vhStateBlockWriter writer;
+    vhWriteStateBlock( writer, state, dirty, dirtyForceMask );
+    auto cmd = vhCmdAllocTail< VIDL_vhCmdSetStateBlock >( writer.size, id, dirty, writer.size );
+    assert( cmd );
+    writer = { .out = vhCmdTail( cmd ) };
+    vhWriteStateBlock( writer, state, dirty, dirtyForceMask );
+    assert( writer.size == cmd->size );
+    vhCmdEnqueueState( cmd, writer.size );
+
     state.dirty = 0x0ull;
+    state.dirtyTextureSlots = state.dirtySamplerSlots = state.dirtyBufferSlots = state.dirtyConstantSlots = state.dirtyUniformSlots = 0;
     return true;
 }
 
+void vhCreateStateBlock( vhStateId id, const vhState& state )
+{
+    auto cmd = vhCmdAlloc< VIDL_vhCreateStateBlock >( id, state );
+    assert( cmd );
+    vhCmdEnqueue( cmd );
+}
+
+void vhDestroyStateBlock( vhStateId id )
+{
+    auto cmd = vhCmdAlloc< VIDL_vhDestroyStateBlock >( id );
+    assert( cmd );
+    vhCmdEnqueue( cmd );
+}
+
 nvrhi::PrimitiveType vhTranslatePrimitiveType( uint64_t stateFlags )
 {
     uint32_t pt = ( uint32_t ) ( ( stateFlags & VRHI_STATE_PT_MASK ) >> VRHI_STATE_PT_SHIFT );
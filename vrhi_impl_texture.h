@@ -133,10 +133,7 @@ bool vhVerifyRegionInTexture( const vhFormatInfo& fmt, glm::ivec3 mipDimensions,
 
 vhTexture vhAllocTexture()
 {
-    std::lock_guard< std::mutex > lock( g_vhTextureIDListMutex );
     uint32_t id = g_vhTextureIDList.alloc();
-    g_vhTextureIDValid[id] = true;
-    
     vhResetTexture( id );
     return id;
 }
@@ -152,17 +149,12 @@ void vhResetTexture( vhTexture texture )
 
 void vhDestroyTexture( vhTexture texture )
 {
-    std::lock_guard< std::mutex > lock( g_vhTextureIDListMutex );
-
-    if ( g_vhTextureIDValid.find( texture ) == g_vhTextureIDValid.end() )
+    if ( !g_vhTextureIDList.release( texture ) )
     {
-        // Invalid texture handle
+        // Invalid or already destroyed texture handle
         return;
     }
 
-    g_vhTextureIDValid.erase( texture );
-    g_vhTextureIDList.release( texture );
-
     // Queue up command to destroy texture
     auto cmd = vhCmdAlloc<VIDL_vhDestroyTexture>( texture );
     assert( cmd );
@@ -228,16 +220,72 @@ void vhReadTextureSlow(
     vhMem* outData
 )
 {
-    // Ensure all pending GPU work is complete before reading
-    vhFinish();
-    
-    // Queue up command to read texture
-    auto cmd = vhCmdAlloc<VIDL_vhReadTextureSlow>( texture, mip, layer, outData );
+    // The readback is ordered behind everything this thread enqueued before it; only that copy is waited on.
+    vhWaitReadback( vhReadTextureAsync( texture, mip, layer, 1, 1, outData ) );
+}
+
+void vhReadTextureAsyncInternal( vhReadbackTicket ticket, vhTexture texture, int startMips, int startLayers, int numMips, int numLayers, vhMem* outData )
+{
+    auto cmd = vhCmdAlloc<VIDL_vhReadTextureAsyncInternal>( ticket, texture, startMips, startLayers, numMips, numLayers, outData );
     assert( cmd );
     vhCmdEnqueue( cmd );
-    
-    // Wait for readback to complete
-    vhFinish();
+}
+
+vhReadbackTicket vhReadTextureAsync(
+    vhTexture texture,
+    int startMips, int startLayers,
+    int numMips, int numLayers,
+    vhMem* outData
+)
+{
+    if ( outData && outData->isExternal() )
+    {
+        VRHI_ERR( "vhReadTextureAsync() : Cannot read back into a vhMem that references external memory!\n" );
+        return 0;
+    }
+
+    vhReadbackTicket ticket = g_vhReadbackTicketIssued.fetch_add( 1 ) + 1;
+    vhReadTextureAsyncInternal( ticket, texture, startMips, startLayers, numMips, numLayers, outData );
+    return ticket;
+}
+
+vhUploadMapping vhMapTextureUpload( vhTexture texture, int mip, int layer )
+{
+    if ( texture == VRHI_INVALID_HANDLE ) return {};
+
+    std::vector< vhTextureMipInfo > mipInfo;
+    vhTexInfo info = vhGetTextureInfo( texture, &mipInfo );
+    if ( info.format == nvrhi::Format::UNKNOWN )
+    {
+        // A texture created moments ago may not have reached the backend yet.
+        vhWaitFlush( vhFlushAsync() );
+        info = vhGetTextureInfo( texture, &mipInfo );
+    }
+    if ( info.format == nvrhi::Format::UNKNOWN )
+    {
+        VRHI_ERR( "vhMapTextureUpload() : Texture %d not found!\n", texture );
+        return {};
+    }
+    if ( mip < 0 || mip >= info.mipLevels || layer < 0 || layer >= info.arrayLayers )
+    {
+        VRHI_ERR( "vhMapTextureUpload() : Mip %d layer %d is out of bounds!\n", mip, layer );
+        return {};
+    }
+
+    vhUploadMapping mapping;
+    mapping.size = ( uint64_t ) mipInfo[mip].size;
+    mapping.rowPitch = ( uint32_t ) mipInfo[mip].pitch;
+    mapping.slicePitch = ( uint64_t ) mipInfo[mip].slice_size;
+    mapping.texture = texture;
+    mapping.mip = mip;
+    mapping.layer = layer;
+    mapping.data = vhBackendMapUpload( mapping.size, &mapping.chunk, &mapping.chunkOffset );
+    if ( !mapping.data )
+    {
+        VRHI_ERR( "vhMapTextureUpload() : Failed to allocate %llu bytes of upload memory!\n", mapping.size );
+        return {};
+    }
+    return mapping;
 }
 
 void vhBlitTexture(
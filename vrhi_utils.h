@@ -77,6 +77,434 @@ public:
 };
 
 
+// Object handles pack a dense slot index into the low bits and a generation count into the high bits.
+// The generation is bumped every time a slot is released, so a recycled slot never hands out a handle equal to a stale one.
+static constexpr uint32_t kVhHandleIndexBits = 20;
+static constexpr uint32_t kVhHandleIndexMask = ( 1u << kVhHandleIndexBits ) - 1;
+static constexpr uint32_t kVhHandleGenerationMask = ( 1u << ( 32 - kVhHandleIndexBits ) ) - 1;
+
+inline uint32_t vhHandleIndex( uint32_t handle )
+{
+    return handle & kVhHandleIndexMask;
+}
+
+inline uint32_t vhHandleGeneration( uint32_t handle )
+{
+    return handle >> kVhHandleIndexBits;
+}
+
+// Lock-free, growable allocator for generation-tagged object handles.
+// Slots live in lazily allocated chunks that are never moved or freed, so any thread can touch a slot without a lock.
+// Released slots go on a tagged Treiber stack; the tag stops a concurrent pop from being fooled by ABA.
+class vhHandleAllocator
+{
+    vhHandleAllocator( const vhHandleAllocator& ) = delete;
+    vhHandleAllocator& operator=( const vhHandleAllocator& ) = delete;
+
+    static constexpr uint32_t kChunkBits = 10;
+    static constexpr uint32_t kChunkSize = 1u << kChunkBits;
+    static constexpr uint32_t kMaxChunks = ( kVhHandleIndexMask + 1 ) / kChunkSize;
+    static constexpr uint32_t kMaxIndex = kVhHandleIndexMask; // The all-ones index is never handed out, so no handle equals VRHI_INVALID_HANDLE.
+    static constexpr uint32_t kNoIndex = 0xFFFFFFFF;
+
+    struct Slot
+    {
+        std::atomic< uint32_t > state = 0; // ( generation << 1 ) | live
+        std::atomic< uint32_t > next = kNoIndex; // Free list link.
+    };
+
+    std::atomic< Slot* > m_chunks[kMaxChunks] = {};
+    std::atomic< uint64_t > m_freeHead = kNoIndex; // ( tag << 32 ) | index
+    std::atomic< uint32_t > m_end = 0;
+    std::atomic< uint32_t > m_allocCount = 0;
+
+    Slot* slot( uint32_t index ) const
+    {
+        Slot* chunk = m_chunks[index >> kChunkBits].load( std::memory_order_acquire );
+        return chunk ? &chunk[index & ( kChunkSize - 1 )] : nullptr;
+    }
+
+    Slot* slotEnsure( uint32_t index )
+    {
+        auto& entry = m_chunks[index >> kChunkBits];
+        Slot* chunk = entry.load( std::memory_order_acquire );
+        if ( !chunk )
+        {
+            Slot* fresh = new Slot[kChunkSize];
+            if ( entry.compare_exchange_strong( chunk, fresh, std::memory_order_acq_rel ) ) chunk = fresh;
+            else delete[] fresh;
+        }
+        return &chunk[index & ( kChunkSize - 1 )];
+    }
+
+    // Returns the live handle of slot |index|, or VRHI_INVALID_HANDLE if it isn't live.
+    static uint32_t liveHandle( uint32_t index, uint32_t state )
+    {
+        return ( state & 1 ) ? ( ( state >> 1 ) << kVhHandleIndexBits ) | index : VRHI_INVALID_HANDLE;
+    }
+
+public:
+    vhHandleAllocator() {}
+
+    ~vhHandleAllocator()
+    {
+        for ( auto& chunk : m_chunks ) delete[] chunk.load();
+    }
+
+    // Returns a fresh handle, or VRHI_INVALID_HANDLE once every slot is live.
+    uint32_t alloc()
+    {
+        uint32_t index = kNoIndex;
+        uint64_t head = m_freeHead.load( std::memory_order_acquire );
+        while ( ( uint32_t ) head != kNoIndex )
+        {
+            uint64_t next = ( ( head >> 32 ) + 1 ) << 32 | slot( ( uint32_t ) head )->next.load( std::memory_order_relaxed );
+            if ( m_freeHead.compare_exchange_weak( head, next, std::memory_order_acq_rel, std::memory_order_acquire ) )
+            {
+                index = ( uint32_t ) head;
+                break;
+            }
+        }
+
+        if ( index == kNoIndex )
+        {
+            index = m_end.fetch_add( 1, std::memory_order_relaxed );
+            if ( index >= kMaxIndex )
+            {
+                m_end.store( kMaxIndex, std::memory_order_relaxed );
+                return VRHI_INVALID_HANDLE;
+            }
+        }
+
+        Slot* s = slotEnsure( index );
+        uint32_t state = s->state.load( std::memory_order_relaxed ) | 1;
+        s->state.store( state, std::memory_order_release );
+        m_allocCount.fetch_add( 1, std::memory_order_relaxed );
+        return liveHandle( index, state );
+    }
+
+    // Returns false if |handle| is not live, e.g. it was already released.
+    bool release( uint32_t handle )
+    {
+        if ( handle == VRHI_INVALID_HANDLE ) return false;
+        uint32_t index = vhHandleIndex( handle );
+        Slot* s = slot( index );
+        if ( !s ) return false;
+
+        uint32_t expected = ( vhHandleGeneration( handle ) << 1 ) | 1;
+        uint32_t released = ( ( ( vhHandleGeneration( handle ) + 1 ) & kVhHandleGenerationMask ) << 1 );
+        if ( !s->state.compare_exchange_strong( expected, released, std::memory_order_acq_rel ) ) return false;
+        m_allocCount.fetch_sub( 1, std::memory_order_relaxed );
+
+        uint64_t head = m_freeHead.load( std::memory_order_relaxed );
+        uint64_t next;
+        do
+        {
+            s->next.store( ( uint32_t ) head, std::memory_order_relaxed );
+            next = ( ( head >> 32 ) + 1 ) << 32 | index;
+        } while ( !m_freeHead.compare_exchange_weak( head, next, std::memory_order_acq_rel, std::memory_order_relaxed ) );
+        return true;
+    }
+
+    bool valid( uint32_t handle ) const
+    {
+        if ( handle == VRHI_INVALID_HANDLE ) return false;
+        const Slot* s = slot( vhHandleIndex( handle ) );
+        return s && liveHandle( vhHandleIndex( handle ), s->state.load( std::memory_order_acquire ) ) == handle;
+    }
+
+    uint32_t count() const { return m_allocCount.load( std::memory_order_relaxed ); }
+
+    // Invalidates every live handle. Not thread-safe; only for shutdown.
+    void purge()
+    {
+        uint32_t end = std::min( m_end.load(), kMaxIndex );
+        for ( uint32_t i = 0; i < end; i++ )
+        {
+            Slot* s = slot( i );
+            uint32_t state = s->state.load();
+            if ( state & 1 ) s->state.store( ( ( ( state >> 1 ) + 1 ) & kVhHandleGenerationMask ) << 1 );
+        }
+        m_freeHead = kNoIndex;
+        m_end = 0;
+        m_allocCount = 0;
+    }
+};
+
+// Dense handle-indexed table.
+// Lookups index straight into a slot vector instead of walking a tree. Each slot remembers the full handle it was filled
+// with, so a stale handle whose slot has since been recycled misses instead of aliasing the new occupant.
+template< typename T >
+class vhSlotTable
+{
+    struct Slot
+    {
+        uint32_t handle = VRHI_INVALID_HANDLE;
+        T value {};
+    };
+
+    std::vector< Slot > m_slots;
+    size_t m_count = 0;
+
+public:
+    // Returns the value stored for |handle|, or nullptr if there is none.
+    T* find( uint32_t handle )
+    {
+        uint32_t idx = vhHandleIndex( handle );
+        if ( handle == VRHI_INVALID_HANDLE || idx >= m_slots.size() ) return nullptr;
+        Slot& slot = m_slots[idx];
+        return slot.handle == handle ? &slot.value : nullptr;
+    }
+
+    const T* find( uint32_t handle ) const
+    {
+        return const_cast< vhSlotTable* >( this )->find( handle );
+    }
+
+    bool contains( uint32_t handle ) const { return find( handle ) != nullptr; }
+
+    // Returns the value stored for |handle|, default-constructing it if there is none.
+    // Any stale occupant of the slot is replaced.
+    T& operator[]( uint32_t handle )
+    {
+        assert( handle != VRHI_INVALID_HANDLE );
+        uint32_t idx = vhHandleIndex( handle );
+        if ( idx >= m_slots.size() )
+        {
+            m_slots.resize( std::max< size_t >( idx + 1, m_slots.size() * 2 ) );
+        }
+        Slot& slot = m_slots[idx];
+        if ( slot.handle != handle )
+        {
+            if ( slot.handle == VRHI_INVALID_HANDLE ) m_count++;
+            slot.handle = handle;
+            slot.value = T {};
+        }
+        return slot.value;
+    }
+
+    bool erase( uint32_t handle )
+    {
+        uint32_t idx = vhHandleIndex( handle );
+        if ( handle == VRHI_INVALID_HANDLE || idx >= m_slots.size() || m_slots[idx].handle != handle ) return false;
+        m_slots[idx].handle = VRHI_INVALID_HANDLE;
+        m_slots[idx].value = T {};
+        m_count--;
+        return true;
+    }
+
+    void clear()
+    {
+        m_slots.clear();
+        m_count = 0;
+    }
+
+    size_t size() const { return m_count; }
+};
+
+// Two-level segregated fit (TLSF) allocator for ranges of an external address space, e.g. offsets into a buffer.
+// Free blocks are binned by a power of two (first level) and 16 linear steps within it (second level), with a bitmap
+// per level, so alloc and release are O(1) with bounded fragmentation. Block metadata lives in a vector; handing out
+// the block index lets release() skip any lookup. Every size and offset is a multiple of the alignment.
+class vhAllocatorTLSF
+{
+    vhAllocatorTLSF( const vhAllocatorTLSF& ) = delete;
+    vhAllocatorTLSF& operator=( const vhAllocatorTLSF& ) = delete;
+
+    static constexpr uint32_t kSLBits = 4;
+    static constexpr uint32_t kSLCount = 1u << kSLBits;
+    static constexpr uint32_t kFLShift = 8; // Sizes below 256 bytes share the first bin.
+    static constexpr uint32_t kFLCount = 64 - kFLShift + 1;
+    static constexpr uint32_t kNone = 0xFFFFFFFF;
+
+    struct Block
+    {
+        uint64_t offset = 0;
+        uint64_t size = 0;
+        uint32_t prevPhys = kNone, nextPhys = kNone;
+        uint32_t prevFree = kNone, nextFree = kNone;
+        bool free = false;
+    };
+
+    std::vector< Block > m_blocks;
+    std::vector< uint32_t > m_unusedBlocks;
+    uint64_t m_flBitmap = 0;
+    uint32_t m_slBitmap[kFLCount] = {};
+    uint32_t m_heads[kFLCount][kSLCount];
+    uint64_t m_size = 0;
+    uint64_t m_used = 0;
+    uint64_t m_alignment = 16;
+
+    static void mapping( uint64_t size, uint32_t& fl, uint32_t& sl )
+    {
+        if ( size < ( 1ull << kFLShift ) )
+        {
+            fl = 0;
+            sl = ( uint32_t ) ( size >> ( kFLShift - kSLBits ) );
+            return;
+        }
+        uint32_t log2 = 63 - ( uint32_t ) std::countl_zero( size );
+        sl = ( uint32_t ) ( size >> ( log2 - kSLBits ) ) ^ kSLCount;
+        fl = log2 - kFLShift + 1;
+    }
+
+    uint32_t newBlock()
+    {
+        if ( m_unusedBlocks.empty() )
+        {
+            m_blocks.emplace_back();
+            return ( uint32_t ) m_blocks.size() - 1;
+        }
+        uint32_t index = m_unusedBlocks.back();
+        m_unusedBlocks.pop_back();
+        m_blocks[index] = Block();
+        return index;
+    }
+
+    void insertFree( uint32_t index )
+    {
+        Block& block = m_blocks[index];
+        uint32_t fl, sl;
+        mapping( block.size, fl, sl );
+        block.free = true;
+        block.prevFree = kNone;
+        block.nextFree = m_heads[fl][sl];
+        if ( block.nextFree != kNone ) m_blocks[block.nextFree].prevFree = index;
+        m_heads[fl][sl] = index;
+        m_flBitmap |= 1ull << fl;
+        m_slBitmap[fl] |= 1u << sl;
+    }
+
+    void removeFree( uint32_t index )
+    {
+        Block& block = m_blocks[index];
+        uint32_t fl, sl;
+        mapping( block.size, fl, sl );
+        if ( block.prevFree != kNone ) m_blocks[block.prevFree].nextFree = block.nextFree;
+        if ( block.nextFree != kNone ) m_blocks[block.nextFree].prevFree = block.prevFree;
+        if ( m_heads[fl][sl] == index )
+        {
+            m_heads[fl][sl] = block.nextFree;
+            if ( block.nextFree == kNone )
+            {
+                m_slBitmap[fl] &= ~( 1u << sl );
+                if ( !m_slBitmap[fl] ) m_flBitmap &= ~( 1ull << fl );
+            }
+        }
+        block.free = false;
+        block.prevFree = block.nextFree = kNone;
+    }
+
+    // Folds |next| into its physical predecessor |index|.
+    void merge( uint32_t index, uint32_t next )
+    {
+        Block& block = m_blocks[index];
+        block.size += m_blocks[next].size;
+        block.nextPhys = m_blocks[next].nextPhys;
+        if ( block.nextPhys != kNone ) m_blocks[block.nextPhys].prevPhys = index;
+        m_unusedBlocks.push_back( next );
+    }
+
+public:
+    static constexpr uint32_t kInvalidBlock = kNone;
+
+    vhAllocatorTLSF() { reset( 0 ); }
+    vhAllocatorTLSF( uint64_t size, uint64_t alignment = 16 ) { reset( size, alignment ); }
+
+    // Forgets every allocation and manages [0, size) afresh. |alignment| must be a power of two of at least 16.
+    void reset( uint64_t size, uint64_t alignment = 16 )
+    {
+        assert( alignment >= ( 1u << ( kFLShift - kSLBits ) ) && std::has_single_bit( alignment ) );
+        m_blocks.clear();
+        m_unusedBlocks.clear();
+        m_flBitmap = 0;
+        std::fill( std::begin( m_slBitmap ), std::end( m_slBitmap ), 0 );
+        for ( auto& heads : m_heads ) std::fill( std::begin( heads ), std::end( heads ), kNone );
+        m_alignment = alignment;
+        m_size = size & ~( alignment - 1 );
+        m_used = 0;
+        if ( !m_size ) return;
+
+        uint32_t index = newBlock();
+        m_blocks[index].size = m_size;
+        insertFree( index );
+    }
+
+    // Returns the block index of a range of at least |size| bytes and its offset in |outOffset|, or kInvalidBlock.
+    uint32_t alloc( uint64_t size, uint64_t& outOffset )
+    {
+        if ( !size || size > m_size ) return kInvalidBlock;
+        size = ( size + m_alignment - 1 ) & ~( m_alignment - 1 );
+
+        // Round up to the next second level bin, so that any block found there is large enough.
+        uint64_t search = size;
+        if ( search >= ( 1ull << kFLShift ) )
+        {
+            uint32_t log2 = 63 - ( uint32_t ) std::countl_zero( search );
+            search += ( 1ull << ( log2 - kSLBits ) ) - 1;
+        }
+        uint32_t fl, sl;
+        mapping( search, fl, sl );
+        if ( fl >= kFLCount ) return kInvalidBlock;
+
+        uint32_t slMap = sl < kSLCount ? m_slBitmap[fl] & ( ~0u << sl ) : 0;
+        if ( !slMap )
+        {
+            uint64_t flMap = fl + 1 < 64 ? m_flBitmap & ( ~0ull << ( fl + 1 ) ) : 0;
+            if ( !flMap ) return kInvalidBlock;
+            fl = ( uint32_t ) std::countr_zero( flMap );
+            slMap = m_slBitmap[fl];
+        }
+        sl = ( uint32_t ) std::countr_zero( slMap );
+
+        uint32_t index = m_heads[fl][sl];
+        removeFree( index );
+
+        // Give the tail back.
+        if ( m_blocks[index].size - size >= m_alignment )
+        {
+            uint32_t rest = newBlock();
+            Block& block = m_blocks[index];
+            m_blocks[rest].offset = block.offset + size;
+            m_blocks[rest].size = block.size - size;
+            m_blocks[rest].prevPhys = index;
+            m_blocks[rest].nextPhys = block.nextPhys;
+            if ( block.nextPhys != kNone ) m_blocks[block.nextPhys].prevPhys = rest;
+            block.nextPhys = rest;
+            block.size = size;
+            insertFree( rest );
+        }
+
+        m_used += m_blocks[index].size;
+        outOffset = m_blocks[index].offset;
+        return index;
+    }
+
+    void release( uint32_t index )
+    {
+        if ( index >= m_blocks.size() || m_blocks[index].free ) return;
+        m_used -= m_blocks[index].size;
+
+        uint32_t prev = m_blocks[index].prevPhys;
+        if ( prev != kNone && m_blocks[prev].free )
+        {
+            removeFree( prev );
+            merge( prev, index );
+            index = prev;
+        }
+        uint32_t next = m_blocks[index].nextPhys;
+        if ( next != kNone && m_blocks[next].free )
+        {
+            removeFree( next );
+            merge( index, next );
+        }
+        insertFree( index );
+    }
+
+    uint64_t size() const { return m_size; }
+    uint64_t used() const { return m_used; }
+};
+
 // ------------ Texture Utilities ------------
 
 // Get next mipmap dimension